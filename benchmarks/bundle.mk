@@ -91,13 +91,16 @@ $(bundle-analysis): $(name).cfg ../../../bin/BundleWCETO
 	$(valgrind) ../../../bin/BundleWCETO -c $(name).cfg -m $(THREADS) \
 		-x $(BUNDLE_CTX) -t $(THREAD_CTX) configBUNDLE.xml
 	touch $@
-# ILP Result
+# ILP Result, solved by BundleWCETO itself when built with LPSOLVE
+ilp=$(name)-level-1.ilp
 $(ilp-current): $(bundle-analysis)
+	if [ -f $(ilp) ]; then sed -n 2p $(ilp) | cut -f1 > $@; else \
 	lp_solve $(name)-level-1.lp | grep "objective function:" | \
-	awk '{print $$5}' | sed s/\\..*//g > $@
+	awk '{print $$5}' | sed s/\\..*//g > $@; fi
 $(ilp-prev): $(bundle-analysis)
+	if [ -f $(ilp) ]; then sed -n 2p $(ilp) | cut -f2 > $@; else \
 	lp_solve $(name)-level-1.lp2 | grep "objective function:" | \
-	awk '{print $$5}' | sed s/\\..*//g > $@
+	awk '{print $$5}' | sed s/\\..*//g > $@; fi
 $(bundle-done): $(ilp-current) $(ilp-prev)
 	touch $@
 
@@ -150,7 +153,7 @@ datespec=$(shell date +\%F.\%H:\%M)
 clean:
 	@-mv summary.txt summary-$(datespec).txt
 	rm -f $(name).cfg *.dot *.jpg *.entry vgcore.* *.wceto simulator-*.cfg
-	rm -f *.lp *.lp2 *.wcet *.ctxs *.done *.sim *.cycles *.analysis
+	rm -f *.lp *.lp2 *.ilp *.wcet *.ctxs *.done *.sim *.cycles *.analysis
 	rm -f *.log *.entry-w-unswitched *.cache
 
 reallyclean: clean
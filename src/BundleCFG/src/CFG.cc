@@ -1,16 +1,26 @@
 #include "CFG.h"
+#include <mutex>
 
 CFG::CFG() : ListDigraph(), _function(*this), _addr(*this), _loop_head(*this),
 	     _is_loop_head(*this), _loop_iters(*this)
 {
 	_initial = INVALID;
 	_terminal = INVALID;
+	_frozen = false;
 }
 
 CFG::CFG(CFG &other) : ListDigraph(), _function(*this), _addr(*this),
 		       _loop_head(*this), _is_loop_head(*this),
 		       _loop_iters(*this) {
+	/*
+	 * Maps created on the other graph register with its notifier,
+	 * serialize copies so analyses may copy a CFG concurrently
+	 */
+	static mutex copy_lock;
+	lock_guard<mutex> guard(copy_lock);
 	_initial = INVALID;
+	_terminal = INVALID;
+	_frozen = false;
 	
 	DigraphCopy<ListDigraph, ListDigraph> dc(other, *this);
 	ListDigraph::NodeMap<ListDigraph::Node> other_to_this(other);
@@ -29,11 +39,16 @@ CFG::CFG(CFG &other) : ListDigraph(), _function(*this), _addr(*this),
 			setHead(tnode, thead);
 		}
 	}
+	map<ListDigraph::Node, ListDigraph::Node>::const_iterator cit;
+	for (cit = other._calls.begin(); cit != other._calls.end(); ++cit) {
+		_calls[other_to_this[cit->first]] = other_to_this[cit->second];
+	}
 	ListDigraph::Node oinit = other.getInitial();
 	if (oinit != INVALID) {
 		ListDigraph::Node tinit = other_to_this[oinit];
 		setInitial(tinit);
 	}
+	reindex();
 }
 
 std::ostream&
@@ -52,17 +67,24 @@ operator<< (std::ostream &stream, const CFG& cfg) {
 
 ListDigraph::Node
 CFG::addNode() {
+	modify("addNode");
 	ListDigraph::Node rv = ListDigraph::addNode();
 
 	_addr[rv] = 0;
 	_loop_head[rv] = INVALID;
 	_is_loop_head[rv] = false;
 	_loop_iters[rv] = 0;
-	
+	indexNode(rv);
 	
 	return rv;
 }
 
+ListDigraph::Arc
+CFG::addArc(ListDigraph::Node source, ListDigraph::Node target) {
+	modify("addArc");
+	return ListDigraph::addArc(source, target);
+}
+
 /**
  *
  * output: Address[iterations]?(function, head)
@@ -89,6 +111,7 @@ CFG::stringNode(ListDigraph::Node node) const {
 
 void
 CFG::setInitial(ListDigraph::Node node) {
+	modify("setInitial");
 	_initial = node;
 }
 ListDigraph::Node
@@ -103,6 +126,7 @@ CFG::getTerminal() const {
 
 void
 CFG::setTerminal(ListDigraph::Node node) {
+	modify("setTerminal");
 	_terminal = node;
 }
 
@@ -123,7 +147,10 @@ CFG::calcTerminal() {
 
 void
 CFG::setFunction(ListDigraph::Node node, const FunctionCall &fcall) {
+	modify("setFunction");
+	unindexNode(node);
 	_function[node].copy(fcall);
+	indexNode(node);
 }
 
 FunctionCall
@@ -143,7 +170,10 @@ CFG::getAddr(ListDigraph::Node node) const {
 }
 void
 CFG::setAddr(ListDigraph::Node node, iaddr_t addr) {
+	modify("setAddr");
+	unindexNode(node);
 	_addr[node] = addr;
+	indexNode(node);
 }
 string
 CFG::stringAddr(ListDigraph::Node node) const {
@@ -159,13 +189,16 @@ CFG::stringAddr(ListDigraph::Node node) const {
 }
 
 ListDigraph::Node
-CFG::find(iaddr_t addr, FunctionCall const &fcall) {
-	ListDigraph::NodeIt nit(*this);
-
-	for ( ; nit != INVALID; ++nit) {
-		ListDigraph::Node node = nit;
-		if (_addr[node] == addr &&
-		    _function[node] == fcall) {
+CFG::find(iaddr_t addr, FunctionCall const &fcall) const {
+	CallKey key;
+	key.addr = addr;
+	fcall.fillStack(key.stack);
+
+	typedef call_index_t::const_iterator iter_t;
+	pair<iter_t, iter_t> range = _call_index.equal_range(key);
+	for (iter_t it = range.first; it != range.second; ++it) {
+		ListDigraph::Node node = it->second;
+		if (_function[node] == fcall) {
 			return node;
 		}
 	}
@@ -173,32 +206,26 @@ CFG::find(iaddr_t addr, FunctionCall const &fcall) {
 }
 
 ListDigraph::Node
-CFG::findIgnoreName(uint32_t addr, FunctionCall const &fcall) {
-	ListDigraph::NodeIt nit(*this);
-
-	for ( ; nit != INVALID; ++nit) {
-		ListDigraph::Node node = nit;
-		if (_addr[node] != addr) {
-			continue;
-		}
-		if (fcall.stacksMatch(_function[node])) {
-			return node;
-		}
+CFG::findIgnoreName(uint32_t addr, FunctionCall const &fcall) const {
+	CallKey key;
+	key.addr = addr;
+	fcall.fillStack(key.stack);
+
+	call_index_t::const_iterator it = _call_index.find(key);
+	if (it == _call_index.end()) {
+		return INVALID;
 	}
-	return INVALID;
+	return it->second;
 }
 
 list<ListDigraph::Node>
-CFG::find(iaddr_t addr) {
+CFG::find(iaddr_t addr) const {
 	list<ListDigraph::Node> rlist;
 
-	ListDigraph::NodeIt nit(*this);
-
-	for ( ; nit != INVALID; ++nit) {
-		ListDigraph::Node node = nit;
-		if (_addr[node] == addr) {
-			rlist.push_back(node);
-		}
+	typedef addr_index_t::const_iterator iter_t;
+	pair<iter_t, iter_t> range = _addr_index.equal_range(addr);
+	for (iter_t it = range.first; it != range.second; ++it) {
+		rlist.push_back(it->second);
 	}
 	return rlist;
 }
@@ -214,6 +241,7 @@ CFG::getHead(ListDigraph::Node node) const {
 
 void
 CFG::setHead(ListDigraph::Node node, ListDigraph::Node head) {
+	modify("setHead");
 	if (node != INVALID && !valid(node)) {
 		throw runtime_error("CFG::setHead target node is invalid");
 	}
@@ -231,6 +259,7 @@ CFG::isHead(ListDigraph::Node node) const {
 
 void
 CFG::markHead(ListDigraph::Node node, bool yes) {
+	modify("markHead");
 	_is_loop_head[node] = yes;
 }
 
@@ -241,11 +270,12 @@ CFG::getIters(ListDigraph::Node head) const {
 
 void
 CFG::setIters(ListDigraph::Node head, unsigned int iters) {
+	modify("setIters");
 	_loop_iters[head] = iters;
 }
 
 bool
-CFG::sameLoop(ListDigraph::Node a, ListDigraph::Node b) {
+CFG::sameLoop(ListDigraph::Node a, ListDigraph::Node b) const {
 	string prefix = "CFG::sameLoop: ";
 	ListDigraph::Node a_head, b_head;
 	a_head = getHead(a);
@@ -282,7 +312,7 @@ CFG::sameLoop(ListDigraph::Node a, ListDigraph::Node b) {
 }
 
 bool
-CFG::inLoop(ListDigraph::Node head, ListDigraph::Node node) {
+CFG::inLoop(ListDigraph::Node head, ListDigraph::Node node) const {
 	if (head == node) {
 		return true;
 	}
@@ -294,8 +324,27 @@ CFG::inLoop(ListDigraph::Node head, ListDigraph::Node node) {
 	return false;
 }
 
+ListDigraph::Node
+CFG::getCallee(ListDigraph::Node node) const {
+	map<ListDigraph::Node, ListDigraph::Node>::const_iterator it =
+		_calls.find(node);
+	if (it == _calls.end()) {
+		return INVALID;
+	}
+	return it->second;
+}
+
 void
-CFG::dump(string path) {
+CFG::setCallee(ListDigraph::Node node, ListDigraph::Node entry) {
+	modify("setCallee");
+	if (!valid(node) || !valid(entry)) {
+		throw runtime_error("CFG::setCallee Invalid node");
+	}
+	_calls[node] = entry;
+}
+
+void
+CFG::dump(string path) const {
 	ofstream dump(path.c_str());
 
 	for (ListDigraph::NodeIt nit(*this); nit != INVALID; ++nit) {
@@ -309,6 +358,66 @@ CFG::dump(string path) {
 /**
  * CFG Private methods
  */
+
+void
+CFG::modify(const char *what) const {
+	if (_frozen) {
+		throw runtime_error(string("CFG::") + what + " CFG is frozen");
+	}
+}
+bool
+CFG::CallKey::operator==(const CallKey &other) const {
+	return addr == other.addr && stack == other.stack;
+}
+
+size_t
+CFG::CallKeyHash::operator()(const CallKey &key) const {
+	return std::hash<iaddr_t>()(key.addr) ^ (key.stack.hash() << 1);
+}
+
+void
+CFG::indexNode(ListDigraph::Node node) {
+	CallKey key;
+	key.addr = _addr[node];
+	_function[node].fillStack(key.stack);
+
+	_call_index.insert(make_pair(key, node));
+	_addr_index.insert(make_pair(key.addr, node));
+}
+
+void
+CFG::unindexNode(ListDigraph::Node node) {
+	CallKey key;
+	key.addr = _addr[node];
+	_function[node].fillStack(key.stack);
+
+	pair<call_index_t::iterator, call_index_t::iterator> crange =
+		_call_index.equal_range(key);
+	for (call_index_t::iterator it = crange.first; it != crange.second; ++it) {
+		if (it->second == node) {
+			_call_index.erase(it);
+			break;
+		}
+	}
+	pair<addr_index_t::iterator, addr_index_t::iterator> arange =
+		_addr_index.equal_range(key.addr);
+	for (addr_index_t::iterator it = arange.first; it != arange.second; ++it) {
+		if (it->second == node) {
+			_addr_index.erase(it);
+			break;
+		}
+	}
+}
+
+void
+CFG::reindex() {
+	_call_index.clear();
+	_addr_index.clear();
+	for (ListDigraph::NodeIt nit(*this); nit != INVALID; ++nit) {
+		indexNode(nit);
+	}
+}
+
 void
 CFG::copyMaps(DigraphCopy<ListDigraph, ListDigraph> &dc, CFG &src, CFG &dst) {
 	dc.nodeMap(src._function, dst._function);
@@ -8,6 +8,8 @@
 #include <stack>
 #include <stdexcept>
 #include <fstream>
+#include <unordered_map>
+#include <map>
 #include "BundleTypes.h"
 #include "Cache.h"
 #include "FunctionCall.h"
@@ -21,6 +23,10 @@ using namespace std;
  * library. Inherits from lemon::ListDigraph.
  *
  * Nodes are individual instructions
+ *
+ * Once loaded a CFG is frozen, it is then only read and may be shared
+ * by any number of analyses. The data an analysis keeps per
+ * instruction lives in its own CFGMaps (see CFGMap.h).
  */
 class CFG : public ListDigraph {
 public:
@@ -33,6 +39,8 @@ public:
 	 * Override to protect against incorrect node addition
 	 */
 	ListDigraph::Node addNode(void);
+	ListDigraph::Arc addArc(ListDigraph::Node source,
+				ListDigraph::Node target);
 	virtual string stringNode(ListDigraph::Node node) const;
 
 	/* Gets and sets the initial (root) node of the CFG */
@@ -54,8 +62,13 @@ public:
 	string stringAddr(ListDigraph::Node node) const;
 	void setAddr(ListDigraph::Node, iaddr_t addr);
 
-	/* Finds the instruction with the address and function */
-	ListDigraph::Node find(iaddr_t addr, FunctionCall const &fcall);
+	/*
+	 * Finds the instruction with the address and function
+	 *
+	 * Lookups by address (and call stack) are served by an index kept
+	 * up to date by addNode, setAddr and setFunction
+	 */
+	ListDigraph::Node find(iaddr_t addr, FunctionCall const &fcall) const;
 	/**
 	 * Finds the instruction with the address and function call
 	 * ignoring the name of the function
@@ -64,10 +77,10 @@ public:
 	 * updating or setting head's of other nodes in the CFG. 
 	 */ 
 	ListDigraph::Node findIgnoreName(uint32_t addr,
-					 FunctionCall const &fcall);
+					 FunctionCall const &fcall) const;
 
 	/* Finds all instructions with the address */
-	list<ListDigraph::Node> find(iaddr_t addr);
+	list<ListDigraph::Node> find(iaddr_t addr) const;
 
 	/* Gets and sets the loop head of the instruction */
 	ListDigraph::Node getHead(ListDigraph::Node node) const;
@@ -81,17 +94,44 @@ public:
 	void setIters(ListDigraph::Node head, unsigned int iters);
 
 	/* Determines if two nodes are part of the same loop */
-	bool sameLoop(ListDigraph::Node a, ListDigraph::Node b);
+	bool sameLoop(ListDigraph::Node a, ListDigraph::Node b) const;
 
 	/* Determines if the node's closest loop head is head */
-	bool inLoop(ListDigraph::Node head, ListDigraph::Node node);
+	bool inLoop(ListDigraph::Node head, ListDigraph::Node node) const;
 	
-	void dump(string path);
+	/**
+	 * Gets and sets the entry of the function called by a call
+	 * instruction
+	 *
+	 * Only a CFG built with shared functions (see
+	 * CFGFactory::setShared) has callees, each function is in it once
+	 * and a call instruction is followed by the instruction it returns
+	 * to. getCallee is INVALID for any other instruction.
+	 */
+	ListDigraph::Node getCallee(ListDigraph::Node node) const;
+	void setCallee(ListDigraph::Node node, ListDigraph::Node entry);
+	/* Every call instruction and the entry it calls */
+	const map<ListDigraph::Node, ListDigraph::Node>& getCalls() const {
+		return _calls;
+	}
+	/* True if functions are shared by their call sites */
+	bool isShared() const { return !_calls.empty(); }
+
+	void dump(string path) const;
+
+	/**
+	 * Freezes the CFG, after which changing it throws a runtime_error
+	 *
+	 * A frozen CFG is safe to read from several threads at once.
+	 */
+	void freeze() { _frozen = true; }
+	bool frozen() const { return _frozen; }
 
 	/* To allow polymorphism */
 	virtual ~CFG() {};
 private:
 	ListDigraph::Node _initial, _terminal;
+	bool _frozen;
 	
 	/* Every instruction belongs to a function, functions are identified by
 	   their calling address and their name */
@@ -104,6 +144,35 @@ private:
 	ListDigraph::NodeMap<bool> _is_loop_head;
 	/* All loop heads have a number of iterations */
 	ListDigraph::NodeMap<unsigned int> _loop_iters;
+	/* Call instructions to the function entries they call, few
+	   instructions are calls so the map is sparse */
+	map<ListDigraph::Node, ListDigraph::Node> _calls;
+
+	/* An instruction is identified by its address and call stack */
+	struct CallKey {
+		iaddr_t addr;
+		CallStack stack;
+		bool operator==(const CallKey &other) const;
+	};
+	struct CallKeyHash {
+		size_t operator()(const CallKey &key) const;
+	};
+	typedef unordered_multimap<CallKey, ListDigraph::Node, CallKeyHash>
+	    call_index_t;
+	typedef unordered_multimap<iaddr_t, ListDigraph::Node> addr_index_t;
+	/* Instructions by address and call stack */
+	call_index_t _call_index;
+	/* Instructions by address alone */
+	addr_index_t _addr_index;
+
+	/* Adds (or removes) the node to the indices under its current
+	   address and function */
+	void indexNode(ListDigraph::Node node);
+	void unindexNode(ListDigraph::Node node);
+	/* Rebuilds the indices from the node maps */
+	void reindex();
+	/* Throws if the CFG is frozen */
+	void modify(const char *what) const;
 
 	void copyMaps(DigraphCopy<ListDigraph, ListDigraph> &dc,
 		      CFG &src, CFG &dst);
@@ -1,6 +1,8 @@
 #include "CFGFactory.h"
 #include "CFGReadWrite.h"
-#define dout dbg.buf << dbg.start 
+#define dout DBG_OUT(dbg, TRACE_DEBUG)
+#define lout TRACE_OUT(log)
+#define mout TRACE_OUT(mlog)
 
 /**
  * Attributes are not statically defined interfaces.
@@ -52,11 +54,13 @@ CFGFactory::produce() {
 	}
 
 	FunctionCall call("main", CallStack({0x0}));
+	_functions[hep_cfg] = INVALID;
 	ListDigraph::Node terminal = makeCall(cfg, call, node);
 	cfg->setTerminal(terminal);
 
 	ListDigraph::Node initial = cfg->find(firstAddr(node), call);
 	cfg->setInitial(initial);
+	_functions[hep_cfg] = initial;
 
 	identifyLoops(*cfg);
 
@@ -83,8 +87,10 @@ dmcpre(int level, Node *node) {
 void
 CFGFactory::dmc1(CFG *cfg, FunctionCall call, Node *node) {
 #ifdef DBG_MAKECALL
-	string pre = dmcpre(dbg.getLevel(), node);
-	mlog << pre << "associated FunctionCall " << call << endl;
+	if (mlog.on()) {
+		string pre = dmcpre(dbg.getLevel(), node);
+		mout << pre << "associated FunctionCall " << call << endl;
+	}
 #endif /* DBG_MAKECALL */
 	dout << hnodeStr(node) << " associated FunctionCall " << call << endl;
 	dbg.flush(cout);
@@ -94,8 +100,11 @@ void
 CFGFactory::dmc2(CFG *cfg, FunctionCall call, Node *node,
 		 ListDigraph::Node first, ListDigraph::Node last) {
 #ifdef DBG_MAKECALL
+	if (!mlog.on()) {
+		return;
+	}
 	string pre = dmcpre(dbg.getLevel(), node);
-	mlog << pre << "First/Last Instr: 0x" << hex << cfg->getAddr(first)
+	mout << pre << "First/Last Instr: 0x" << hex << cfg->getAddr(first)
 	    << "/0x" << cfg->getAddr(last) << dec << endl;
 #endif
 }
@@ -103,28 +112,36 @@ CFGFactory::dmc2(CFG *cfg, FunctionCall call, Node *node,
 void CFGFactory::dmc3(CFG *cfg, FunctionCall call, Node *node,
 		      vector<Node*> &succs) {
  #ifdef DBG_MAKECALL
+	if (!mlog.on()) {
+		return;
+	}
 	string pre = dmcpre(dbg.getLevel(), node);
-	mlog << pre << "Successors: " << succs.size() << hex;
+	stringstream ss;
+	ss << pre << "Successors: " << succs.size() << hex;
 	vector<Node*>::iterator nit;
 	for (nit = succs.begin(); nit != succs.end(); nit++) {
 		Node *next = (*nit);
 		int addr = firstAddr(next);
 		if (nit != succs.begin()) {
-			mlog << ", ";
+			ss << ", ";
 		} else {
-			mlog << endl << "\t";
+			ss << endl << "\t";
 		}
-		mlog << "0x" << addr;
+		ss << "0x" << addr;
 	}
-	mlog << dec << endl;
+	ss << dec << endl;
+	mlog.write(ss.str());
 #endif /* DBG_MAKECALL */
 }
 
 void CFGFactory::dmc4(CFG *cfg, FunctionCall call, Node *node,
 		      Node *next) {
 #ifdef DBG_MAKECALL
+	if (!mlog.on()) {
+		return;
+	}
 	string pre = dmcpre(dbg.getLevel(), node);
-	mlog << pre << "no CFG node for: " << hnodeStr(next)
+	mout << pre << "no CFG node for: " << hnodeStr(next)
 	     << ", recursing" << endl
 	     << "--↓" << endl;
 	
@@ -134,9 +151,12 @@ void CFGFactory::dmc4(CFG *cfg, FunctionCall call, Node *node,
 void CFGFactory::dmc5(CFG *cfg, FunctionCall call, Node *node,
 		      Node *next) {
 #ifdef DBG_MAKECALL
+	if (!mlog.on()) {
+		return;
+	}
 	string pre = dmcpre(dbg.getLevel(), node);
-	mlog << "↑--" << endl;
-	mlog << pre << "finished recursive call for: " << hnodeStr(next)
+	mout << "↑--" << endl;
+	mout << pre << "finished recursive call for: " << hnodeStr(next)
 	     << endl;
 #endif /* DBG_MAKECALL */
 }
@@ -145,8 +165,11 @@ void
 CFGFactory::dmc6(CFG *cfg, FunctionCall call, Node *node,
 		 ListDigraph::Node last, ListDigraph::Node succ_first) {
 #ifdef DBG_MAKECALL
+	if (!mlog.on()) {
+		return;
+	}
 	string pre = dmcpre(dbg.getLevel(), node);
-	mlog << pre << "added arc from last node: " << endl
+	mout << pre << "added arc from last node: " << endl
 	     << pre << "  " << cfg->stringNode(last) << endl
 	     << pre << "   to first node →" << endl
 	     << pre << "  " << cfg->stringNode(succ_first) << endl;
@@ -157,15 +180,18 @@ void
 CFGFactory::dmc7(CFG *cfg, FunctionCall call, Node *node,
 		 ListDigraph::Node last) {
 #ifdef DBG_MAKECALL
+	if (!mlog.on()) {
+		return;
+	}
 	string pre = dmcpre(dbg.getLevel(), node);
-	mlog << pre << cfg->stringNode(last) << " is a call " << endl;
+	mout << pre << cfg->stringNode(last) << " is a call " << endl;
 
 	Cfg* callto = node->GetCallee();
 	Node *next = callto->GetStartNode();
 	string called_fname = next->GetCfg()->getStringName();
 
-	mlog << pre << "   calling function " << called_fname << endl;
-	mlog << pre << "   context should be 0x" << hex << cfg->getAddr(last)
+	mout << pre << "   calling function " << called_fname << endl;
+	mout << pre << "   context should be 0x" << hex << cfg->getAddr(last)
 	     << dec << endl;
 #endif
 }
@@ -174,11 +200,14 @@ void
 CFGFactory::dmc10(CFG *cfg, FunctionCall call, Node *node,
 		  ListDigraph::Node final) {
 #ifdef DBG_MAKECALL
+	if (!mlog.on()) {
+		return;
+	}
 	string pre = dmcpre(dbg.getLevel(), node);
 	if (final == INVALID) {
-		mlog << pre << "Final: INVALID" << endl;
+		mout << pre << "Final: INVALID" << endl;
 	} else {
-		mlog << pre << "Final: 0x" << hex << cfg->getAddr(final)
+		mout << pre << "Final: 0x" << hex << cfg->getAddr(final)
 		     << dec << endl;
 	}
 #endif /* DBG_MAKECALL */	
@@ -237,7 +266,8 @@ CFGFactory::makeCall(CFG *cfg, FunctionCall call, Node *node) {
 				final = succ_last; 
 			}
 		}
-		if (!node->IsCall()) {
+		if (!node->IsCall() || _shared) {
+			/* In shared mode a call is followed by its return */
 			cfg->addArc(last, succ_first);
 			dmc6(cfg, call, node, last, succ_first);
 			dout << "added #2 "
@@ -247,7 +277,13 @@ CFGFactory::makeCall(CFG *cfg, FunctionCall call, Node *node) {
 		succ_count++;
 	}
 	/* Handle calls from this function */
-	if (node->IsCall()) {
+	if (node->IsCall() && _shared) {
+		Node *next = node->GetCallee()->GetStartNode();
+		ListDigraph::Node entry = makeFunction(cfg, next);
+		cfg->setCallee(last, entry);
+		dout << "callee " << cfg->stringNode(last) << " → "
+		     << cfg->stringNode(entry) << endl;
+	} else if (node->IsCall()) {
 		dmc7(cfg, call, node, last);
 		succ_count++;
 		dout << cfg->stringNode(last) << " is a call" << endl;
@@ -291,6 +327,42 @@ CFGFactory::makeCall(CFG *cfg, FunctionCall call, Node *node) {
 	return final;
 }
 
+/**
+ * Adds a function to a CFG built in shared mode, unless it was added
+ * for an earlier call site.
+ *
+ * The instructions of the function are given the call stack holding
+ * only the address of its entry, which is distinct for each function.
+ *
+ * @param[in|out] cfg the CFG being modified
+ * @param[in] start the heptane node that begins the function
+ *
+ * @return the first instruction of the function
+ */
+ListDigraph::Node
+CFGFactory::makeFunction(CFG *cfg, Node *start) {
+	Cfg *hep_cfg = start->GetCfg();
+	map<Cfg*, ListDigraph::Node>::iterator fit = _functions.find(hep_cfg);
+	if (fit != _functions.end()) {
+		if (fit->second == INVALID) {
+			throw runtime_error("Recursive call to "
+					    + hep_cfg->getStringName());
+		}
+		return fit->second;
+	}
+	_functions[hep_cfg] = INVALID;
+
+	t_address addr = firstAddr(start);
+	FunctionCall call(hep_cfg->getStringName(), CallStack({addr}));
+	makeCall(cfg, call, start);
+	ListDigraph::Node entry = cfg->find(addr, call);
+	if (entry == INVALID) {
+		throw runtime_error("Unable to find function entry");
+	}
+	_functions[hep_cfg] = entry;
+	return entry;
+}
+
 /**
  * Adds the instructions of the basic block to the CFG
  *
@@ -330,7 +402,7 @@ CFGFactory::makeBB(CFG *cfg, const FunctionCall &call, Node *node) {
 		cfg->setFunction(new_node, call);
 		#ifdef DBG_MAKEBB
 		dout << "created node " << cfg->stringNode(new_node) << endl;
-		log << setw(6) << left << linec++ << "Node: "
+		lout << setw(6) << left << linec++ << "Node: "
 		    << cfg->stringNode(new_node) << endl;
 		#endif
 
@@ -341,7 +413,7 @@ CFGFactory::makeBB(CFG *cfg, const FunctionCall &call, Node *node) {
 			dout << "added "
 			     << cfg->stringNode(last) << " --> "
 			     << cfg->stringNode(new_node) << endl;
-			log << setw(6) << left << linec++ << "Arc: "
+			lout << setw(6) << left << linec++ << "Arc: "
 			    << cfg->stringNode(last) << " --> "
 			    << cfg->stringNode(new_node) << endl;
 			#endif
@@ -370,6 +442,13 @@ CFGFactory::identifyLoops(CFG &cfg) {
 	ListDigraph::NodeMap<int> pathp(cfg);
 	ListDigraph::NodeMap<bool> visited(cfg);
 	loopDFS(cfg, root, pathp, visited, 1);
+	/* Shared functions are not reached from the initial instruction */
+	map<ListDigraph::Node, ListDigraph::Node>::const_iterator cit;
+	for (cit = cfg.getCalls().begin(); cit != cfg.getCalls().end(); ++cit) {
+		if (!visited[cit->second]) {
+			loopDFS(cfg, cit->second, pathp, visited, 1);
+		}
+	}
 	cout << _debug.str();
 }
 
@@ -390,10 +469,10 @@ CFGFactory::loopDFS(CFG &cfg, ListDigraph::Node node,
 		    ListDigraph::NodeMap<bool> &visited, unsigned int pos) {
 	dbg.inc("loopDFS");
 	dout << cfg.stringNode(node) << endl;
-	log << "loopDFS: " << cfg.stringNode(node) << endl;
+	lout << "loopDFS: " << cfg.stringNode(node) << endl;
 		
 	if (visited[node]) {
-		log << "loopDFS: already visited" << endl;		
+		lout << "loopDFS: already visited" << endl;		
 		dout << " already visited" << endl;
 		dbg.dec();
 		return cfg.getHead(node);
@@ -406,15 +485,15 @@ CFGFactory::loopDFS(CFG &cfg, ListDigraph::Node node,
 	 */
 	for (ListDigraph::OutArcIt a(cfg, node); a != INVALID; ++a) {
 		ListDigraph::Node tgt = cfg.runningNode(a);
-		log << "loopDFS: visited " << cfg.stringNode(tgt) << " "
+		lout << "loopDFS: visited " << cfg.stringNode(tgt) << " "
 		    << visited[tgt] << endl;
 		if (!visited[tgt]) {
 			/* Recursive call */
-			log << "loopDFS: recursing on " << cfg.stringNode(tgt)
+			lout << "loopDFS: recursing on " << cfg.stringNode(tgt)
 			    << endl;
 			ListDigraph::Node header =
 				loopDFS(cfg, tgt, pathp, visited, pos + 1);
-			log << "loopDFS: return from recursion assigning head "
+			lout << "loopDFS: return from recursion assigning head "
 			    <<  cfg.stringNode(header) << " to "
 			    << cfg.stringNode(node) << endl;
 			tagHead(cfg, node, header, pathp);
@@ -429,27 +508,28 @@ CFGFactory::loopDFS(CFG &cfg, ListDigraph::Node node,
 			dout << cfg.stringNode(node) << " assigned head "
 			     << cfg.stringNode(tgt) << endl; 
 			cfg.setHead(node, tgt);
-			log << cfg.stringNode(tgt) << " marked as a head" << endl;
+			lout << cfg.stringNode(tgt) << " marked as a head"
+			     << endl;
 			cfg.markHead(tgt);
 			tagHead(cfg, node, tgt, pathp);
 			continue;
 		}
 		if (cfg.getHead(tgt) == INVALID) {
 			/* tgt has no inner loop header, done */
-			log << "loopDFS: " << cfg.stringNode(tgt) 
+			lout << "loopDFS: " << cfg.stringNode(tgt) 
 			    << " has no loop" << endl;
 			continue;
 		}
 		ListDigraph::Node header = cfg.getHead(tgt);
 		if (pathp[header] > 0) {
 			/* Header of tgt is on the path to node */
-			log << "loopDFS: " << cfg.stringNode(header) 
+			lout << "loopDFS: " << cfg.stringNode(header) 
 			    << " found on path, tagging" << endl;
 			tagHead(cfg, node, header, pathp);
 			continue;
 		}
 		/* Reentry case, find the proper header */
-		log << "loopDFS: reentry case, look for header" << endl;
+		lout << "loopDFS: reentry case, look for header" << endl;
 		while (cfg.getHead(header) != INVALID) {
 			header = cfg.getHead(header);
 			if (pathp[header] > 0) {
@@ -458,9 +538,9 @@ CFGFactory::loopDFS(CFG &cfg, ListDigraph::Node node,
 				break; /* the while */
 			}
 		}
-		log << "loopDFS: rentrny case done" << endl;
+		lout << "loopDFS: rentrny case done" << endl;
 	}
-	log << "loodDFS: " << cfg.stringNode(node) << " done with head: "
+	lout << "loodDFS: " << cfg.stringNode(node) << " done with head: "
 	    << cfg.stringNode(cfg.getHead(node)) << endl;
 	dbg.dec(); dbg.flush(dlog);
 	pathp[node] = 0;
@@ -489,14 +569,14 @@ CFGFactory::tagHead(CFG &cfg, ListDigraph::Node node,
 	dout << cfg.stringNode(node) << " pos:" << pathp[node] << " "
 	     << cfg.stringNode(head) << " pos: "
 	     << (head != INVALID ? pathp[head] : -1) << endl;
-	log << "tagHead: " << cfg.stringNode(node) << endl;
+	lout << "tagHead: " << cfg.stringNode(node) << endl;
 	
 	if (node == head) {
 		dbg.dec();
 		return;
 	}
 	if (head == INVALID) {
-		log << "tagHead: no head assigned, returning"  << endl;
+		lout << "tagHead: no head assigned, returning"  << endl;
 		dout << cfg.stringNode(node) << " no head assigned, aborting "
 		     << "existing head " << cfg.stringNode(cfg.getHead(node))
 		     << endl;
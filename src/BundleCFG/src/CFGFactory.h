@@ -8,19 +8,25 @@
 #include "Generic/CallGraph.h"
 
 #include "CFG.h"
+#include <map>
 #include <stack>
 using namespace std;
 using namespace cfglib;
 
 /**
  * Converts a Heptane Program into a CFG
+ *
+ * By default every call is inlined, the instructions of a function are
+ * copied for each call stack reaching it. With setShared(true) each
+ * function is added once instead, see CFG::getCallee.
  */
 class CFGFactory {
 public:
-	CFGFactory(Program *prog) : _prog(prog) {
-		log.open("creation.log");
-		mlog.open("makeCall.log");
-		dlog.open("loopDFS.log");
+	CFGFactory(Program *prog) : _prog(prog), _shared(false),
+				    dbg("cfgfactory") {
+		log.open("creation.log", "cfgfactory", TRACE_DEBUG);
+		mlog.open("makeCall.log", "cfgfactory", TRACE_DEBUG);
+		dlog.open("loopDFS.log", "cfgfactory", TRACE_DEBUG);
   	}
 	~CFGFactory() {
 		log.close();
@@ -28,9 +34,23 @@ public:
 		dlog.close();
 	}
 	CFG* produce();
+	/**
+	 * Adds each function once, shared by all of its call sites
+	 *
+	 * A call instruction is joined to the instruction it returns to
+	 * and records the entry of the function it calls. The CFG then
+	 * grows with the code size rather than with the number of call
+	 * paths.
+	 */
+	void setShared(bool shared) { _shared = shared; }
 private:
 	Program *_prog;
+	bool _shared;
+	/* Entries of the functions added in shared mode, INVALID while the
+	   function is being added */
+	map<Cfg*, ListDigraph::Node> _functions;
 	ListDigraph::Node makeCall(CFG *cfg, FunctionCall call, Node *node);
+	ListDigraph::Node makeFunction(CFG *cfg, Node *start);
 	ListDigraph::Node makeBB(CFG *cfg, const FunctionCall &call, Node *node);
 	stringstream _debug;
 	string _indent;
@@ -44,9 +64,9 @@ private:
 	void identifyLoops(CFG &cfg);
 	void boundLoops(CFG &cfg, Cfg* hep_cfg);
 	DBG dbg;
-	ofstream log;
-	ofstream mlog;
-	ofstream dlog;
+	TraceFile log;
+	TraceFile mlog;
+	TraceFile dlog;
 
 	void dmc1(CFG *cfg, FunctionCall call, Node *node);
 	void dmc2(CFG *cfg, FunctionCall call, Node *node,
@@ -0,0 +1,47 @@
+#ifndef CFGMAP_H
+#define CFGMAP_H
+
+#include "CFG.h"
+#include <vector>
+using namespace std;
+
+/**
+ * @class CFGMap
+ *
+ * Data an analysis keeps for each instruction of a frozen CFG.
+ *
+ * A ListDigraph::NodeMap registers itself with its graph, so creating
+ * one changes the graph. A CFGMap is only a vector indexed by the node
+ * ids and leaves the CFG untouched, any number of analyses may keep
+ * their own maps over one shared CFG, from any thread.
+ *
+ * The CFG must not gain nodes while the map is in use (see
+ * CFG::freeze()).
+ *
+ * Usage:
+ *   CFGMap<bool> visited(cfg, false);
+ *   visited[node] = true;
+ */
+template <typename T>
+class CFGMap {
+public:
+	typedef typename vector<T>::reference Reference;
+	typedef typename vector<T>::const_reference ConstReference;
+
+	CFGMap(const CFG &cfg, const T &value=T()) : _cfg(cfg),
+		_data(cfg.maxNodeId() + 1, value) {}
+
+	Reference operator[](ListDigraph::Node node) {
+		return _data[_cfg.id(node)];
+	}
+	ConstReference operator[](ListDigraph::Node node) const {
+		return _data[_cfg.id(node)];
+	}
+	/* Sets every instruction to the value */
+	void fill(const T &value) { _data.assign(_data.size(), value); }
+private:
+	const CFG &_cfg;
+	vector<T> _data;
+};
+
+#endif /* CFGMAP_H */
@@ -1,5 +1,13 @@
 #include "CFGReadWrite.h"
 
+#include <map>
+#include <set>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 string
 CFGWriter::nodeHeader() {
 	stringstream ss;
@@ -18,7 +26,8 @@ CFGWriter::nodeHeader() {
 string
 CFGWriter::nodeString(ListDigraph::Node node) {
 	stringstream ss;
-	ss << "0x" << hex << setw(6) << _cfg.getAddr(node) << dec << " ";
+	ss << "0x" << hex << setfill('0') << setw(6) << _cfg.getAddr(node)
+	   << setfill(' ') << dec << " ";
 	ss << setw(11) << left << (_cfg.isHead(node) ? "YES" : "NO");
 	ss << setw(11) << left << _cfg.getIters(node);
 
@@ -41,9 +50,9 @@ CFGWriter::nodeString(ListDigraph::Node node) {
 }
 
 string
-CFGWriter::arcHeader() {
+CFGWriter::arcHeader(string title) {
 	stringstream ss;
-	ss << "ARCS" << endl;
+	ss << title << endl;
 	ss << setw(9) << left << "Address"
 	   << setw(8) << left << "Frame-1"
 	   << "  -->    "
@@ -56,26 +65,29 @@ CFGWriter::arcHeader() {
 
 string
 CFGWriter::arcString(ListDigraph::Arc arc) {
-	stringstream ss;
-	ListDigraph::Node src = _cfg.source(arc);
-	ListDigraph::Node tgt = _cfg.target(arc);
+	return linkString(_cfg.source(arc), _cfg.target(arc));
+}
 
-	ss << "0x" << hex << setw(6) << _cfg.getAddr(src) << " ";
+string
+CFGWriter::linkString(ListDigraph::Node src, ListDigraph::Node tgt) {
+	stringstream ss;
+	ss << "0x" << hex << setfill('0') << setw(6) << _cfg.getAddr(src)
+	   << setfill(' ') << " ";
 	ss << _cfg.getFunction(src);
 	ss << " → ";
 
-	ss << "0x" << hex << setw(6) << _cfg.getAddr(tgt) << " ";
+	ss << "0x" << hex << setfill('0') << setw(6) << _cfg.getAddr(tgt)
+	   << setfill(' ') << " ";
 	ss << _cfg.getFunction(tgt);
 
 	return ss.str();
 }
 
 
-void
-CFGWriter::write(string path) {
-	ofstream ofile(path.c_str());
-
-	ofile << nodeHeader() << endl;
+vector<ListDigraph::Node>
+CFGWriter::nodeOrder() {
+	vector<ListDigraph::Node> order;
+	order.reserve(countNodes(_cfg));
 
 	ListDigraph::NodeMap<bool> visited(_cfg);
 	/* Loop Heads first, necessary */
@@ -87,8 +99,8 @@ CFGWriter::write(string path) {
 			continue;
 		}
 		ListDigraph::Node head = _cfg.getHead(nit);
-		doHeads(ofile, visited, head);
-		ofile << nodeString(nit) << endl;
+		doHeads(order, visited, head);
+		order.push_back(nit);
 		visited[nit] = true;
 	}
 	
@@ -96,7 +108,44 @@ CFGWriter::write(string path) {
 		if (_cfg.isHead(nit)) {
 			continue;
 		}
-		ofile << nodeString(nit) << endl;
+		order.push_back(nit);
+	}
+	return order;
+}
+
+void
+CFGWriter::doHeads(vector<ListDigraph::Node> &order,
+		   ListDigraph::NodeMap<bool> &visited, ListDigraph::Node head) {
+	if (head == INVALID) {
+		return;
+	}
+	if (visited[head]) {
+		return;
+	}
+	ListDigraph::Node prec = _cfg.getHead(head);
+	doHeads(order, visited, prec);
+	order.push_back(head);
+	visited[head] = true;
+}
+
+void
+CFGWriter::write(string path) {
+	if (_text) {
+		writeText(path);
+	} else {
+		writeBinary(path);
+	}
+}
+
+void
+CFGWriter::writeText(string path) {
+	ofstream ofile(path.c_str());
+
+	ofile << nodeHeader() << endl;
+
+	vector<ListDigraph::Node> order = nodeOrder();
+	for (size_t i=0; i < order.size(); i++) {
+		ofile << nodeString(order[i]) << endl;
 	}
 
 	ofile << endl;
@@ -104,24 +153,121 @@ CFGWriter::write(string path) {
 	for (ListDigraph::ArcIt ait(_cfg); ait != INVALID; ++ait) {
 		ofile << arcString(ait) << endl;
 	}
+	if (_cfg.isShared()) {
+		/* Call instruction --> entry of the function called */
+		ofile << endl;
+		ofile << arcHeader("CALLS") << endl;
+		map<ListDigraph::Node, ListDigraph::Node>::const_iterator cit;
+		for (cit = _cfg.getCalls().begin();
+		     cit != _cfg.getCalls().end(); ++cit) {
+			ofile << linkString(cit->first, cit->second) << endl;
+		}
+	}
 
 	ofile.flush();
 	ofile.close();
 }
 
 void
-CFGWriter::doHeads(ofstream &ofile, ListDigraph::NodeMap<bool> &visited,
-		   ListDigraph::Node head) {
-	if (head == INVALID) {
-		return;
+CFGWriter::writeBinary(string path) {
+	vector<ListDigraph::Node> order = nodeOrder();
+	ListDigraph::NodeMap<uint32_t> index(_cfg, BCFG_NONE);
+	for (size_t i=0; i < order.size(); i++) {
+		index[order[i]] = i;
 	}
-	if (visited[head]) {
-		return;
+
+	/*
+	 * Arcs are grouped by source in the order the arc iterator
+	 * visits them, which is the order the text format lists them
+	 */
+	vector<BCFGNode> nodes(order.size());
+	vector<uint32_t> arcs;
+	for (ListDigraph::ArcIt ait(_cfg); ait != INVALID; ++ait) {
+		BCFGNode &src = nodes[index[_cfg.source(ait)]];
+		if (src.arc_count == 0) {
+			src.arc_first = arcs.size();
+		} else if (src.arc_first + src.arc_count != arcs.size()) {
+			throw runtime_error("Out arcs of a node are not "
+			    "contiguous");
+		}
+		src.arc_count++;
+		arcs.push_back(index[_cfg.target(ait)]);
 	}
-	ListDigraph::Node prec = _cfg.getHead(head);
-	doHeads(ofile, visited, prec);
-	ofile << nodeString(head) << endl;
-	visited[head] = true;
+
+	vector<BCFGContext> contexts;
+	vector<uint32_t> stacks;
+	string strings;
+	map<uint32_t, uint32_t> interned;
+	for (size_t i=0; i < order.size(); i++) {
+		ListDigraph::Node node = order[i];
+		BCFGNode &bnode = nodes[i];
+		bnode.addr = _cfg.getAddr(node);
+		bnode.iters = _cfg.getIters(node);
+		bnode.is_head = _cfg.isHead(node);
+		ListDigraph::Node head = _cfg.getHead(node);
+		bnode.head = (head == INVALID) ? BCFG_NONE : index[head];
+
+		FunctionCall call = _cfg.getFunction(node);
+		uint32_t key = call.id();
+		map<uint32_t, uint32_t>::iterator it = interned.find(key);
+		if (it != interned.end()) {
+			bnode.context = it->second;
+			continue;
+		}
+		BCFGContext ctx;
+		memset(&ctx, 0, sizeof(ctx));
+		ctx.name = strings.size();
+		strings += call.getName();
+		strings += '\0';
+		ctx.stack_first = stacks.size();
+		while (call.stack().size() > 0) {
+			stacks.push_back(call.stack().pop());
+		}
+		ctx.stack_count = stacks.size() - ctx.stack_first;
+		bnode.context = contexts.size();
+		interned[key] = contexts.size();
+		contexts.push_back(ctx);
+	}
+
+	vector<uint32_t> calls;
+	map<ListDigraph::Node, ListDigraph::Node>::const_iterator cit;
+	for (cit = _cfg.getCalls().begin(); cit != _cfg.getCalls().end(); ++cit) {
+		calls.push_back(index[cit->first]);
+		calls.push_back(index[cit->second]);
+	}
+
+	BCFGHeader hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = BCFG_MAGIC;
+	hdr.version = BCFG_VERSION;
+	hdr.nodes = nodes.size();
+	hdr.arcs = arcs.size();
+	hdr.contexts = contexts.size();
+	hdr.stack_words = stacks.size();
+	hdr.strings = strings.size();
+	hdr.calls = calls.size() / 2;
+
+	ofstream ofile(path.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!ofile) {
+		throw runtime_error("Could not open " + path + " for writing");
+	}
+	ofile.write((const char *) &hdr, sizeof(hdr));
+	ofile.write((const char *) nodes.data(),
+		    nodes.size() * sizeof(BCFGNode));
+	ofile.write((const char *) arcs.data(),
+		    arcs.size() * sizeof(uint32_t));
+	ofile.write((const char *) contexts.data(),
+		    contexts.size() * sizeof(BCFGContext));
+	ofile.write((const char *) stacks.data(),
+		    stacks.size() * sizeof(uint32_t));
+	ofile.write((const char *) calls.data(),
+		    calls.size() * sizeof(uint32_t));
+	ofile.write(strings.data(), strings.size());
+	ofile.flush();
+	if (!ofile) {
+		throw runtime_error("Could not write " + path);
+	}
+	ofile.close();
 }
 
 static void
@@ -221,9 +367,36 @@ CFGReader::addNode(string addr, ifstream &ifile) {
 
 bool
 CFGReader::addArc(ifstream &ifile) {
+	ListDigraph::Node src, dst;
+	if (!readLink(ifile, src, dst)) {
+		return false;
+	}
+	_cfg.addArc(src, dst);
+	return true;
+}
+
+bool
+CFGReader::addCall(ifstream &ifile) {
+	ListDigraph::Node src, dst;
+	if (!readLink(ifile, src, dst)) {
+		return false;
+	}
+	_cfg.setCallee(src, dst);
+	return true;
+}
+
+/**
+ * Reads "<address> <function> → <address> <function>"
+ *
+ * @return false at the end of the file or of the section (the CALLS
+ *     header)
+ */
+bool
+CFGReader::readLink(ifstream &ifile, ListDigraph::Node &src,
+		    ListDigraph::Node &dst) {
 	string sNodeAddr, dNodeAddr, arrow;
 
-	if (!(ifile >> sNodeAddr)) {
+	if (!(ifile >> sNodeAddr) || sNodeAddr.compare("CALLS") == 0) {
 		return false;
 	}
 	FunctionCall srcFn;
@@ -238,18 +411,145 @@ CFGReader::addArc(ifstream &ifile) {
 	iaddr_t src_addr = stoul(sNodeAddr, &pos, 16);
 	iaddr_t dst_addr = stoul(dNodeAddr, &pos, 16);
 
-	ListDigraph::Node src = _cfg.find(src_addr, srcFn);
-	ListDigraph::Node dst = _cfg.find(dst_addr, dstFn);
+	src = _cfg.find(src_addr, srcFn);
+	dst = _cfg.find(dst_addr, dstFn);
 
 	if (src == INVALID || dst == INVALID) {
 		throw runtime_error("Could not find nodes to make an arc");
 	}
-	_cfg.addArc(src, dst);				  
 	return true;
 }
 
 void
 CFGReader::read(string path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw runtime_error("Could not open " + path);
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		throw runtime_error("Could not stat " + path);
+	}
+	uint32_t magic = 0;
+	if ((size_t) st.st_size >= sizeof(magic) &&
+	    pread(fd, &magic, sizeof(magic), 0) != sizeof(magic)) {
+		magic = 0;
+	}
+	if (magic != BCFG_MAGIC) {
+		close(fd);
+		readText(path);
+		return;
+	}
+
+	void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		throw runtime_error("Could not map " + path);
+	}
+	try {
+		readBinary((const char *) data, st.st_size);
+	} catch (...) {
+		munmap(data, st.st_size);
+		throw;
+	}
+	munmap(data, st.st_size);
+}
+
+void
+CFGReader::readBinary(const char *data, size_t size) {
+	if (size < sizeof(BCFGHeader)) {
+		throw runtime_error("Truncated binary CFG header");
+	}
+	const BCFGHeader *hdr = (const BCFGHeader *) data;
+	if (hdr->version != BCFG_VERSION &&
+	    !(hdr->version == 1 && hdr->calls == 0)) {
+		stringstream ss;
+		ss << "Unsupported binary CFG version " << hdr->version;
+		throw runtime_error(ss.str());
+	}
+	size_t expected = sizeof(BCFGHeader)
+		+ (size_t) hdr->nodes * sizeof(BCFGNode)
+		+ (size_t) hdr->arcs * sizeof(uint32_t)
+		+ (size_t) hdr->contexts * sizeof(BCFGContext)
+		+ (size_t) hdr->stack_words * sizeof(uint32_t)
+		+ (size_t) hdr->calls * 2 * sizeof(uint32_t)
+		+ hdr->strings;
+	if (size != expected) {
+		throw runtime_error("Binary CFG size does not match header");
+	}
+	const BCFGNode *nodes = (const BCFGNode *) (hdr + 1);
+	const uint32_t *arcs = (const uint32_t *) (nodes + hdr->nodes);
+	const BCFGContext *contexts =
+		(const BCFGContext *) (arcs + hdr->arcs);
+	const uint32_t *stacks = (const uint32_t *) (contexts + hdr->contexts);
+	const uint32_t *calltab = stacks + hdr->stack_words;
+	const char *strings = (const char *) (calltab + 2 * hdr->calls);
+
+	vector<FunctionCall> calls(hdr->contexts);
+	for (uint32_t i=0; i < hdr->contexts; i++) {
+		const BCFGContext &ctx = contexts[i];
+		if (ctx.name >= hdr->strings ||
+		    (size_t) ctx.stack_first + ctx.stack_count
+		    > hdr->stack_words) {
+			throw runtime_error("Corrupt binary CFG context");
+		}
+		calls[i].setName(string(strings + ctx.name,
+		    strnlen(strings + ctx.name, hdr->strings - ctx.name)));
+		/* Stored top first, push bottom first */
+		for (uint32_t j=ctx.stack_count; j > 0; j--) {
+			calls[i].stack().push(stacks[ctx.stack_first + j - 1]);
+		}
+	}
+
+	vector<ListDigraph::Node> index(hdr->nodes);
+	/* Position in the arc table to its source */
+	vector<uint32_t> arc_src(hdr->arcs, BCFG_NONE);
+	for (uint32_t i=0; i < hdr->nodes; i++) {
+		const BCFGNode &bnode = nodes[i];
+		if (bnode.context >= hdr->contexts ||
+		    (size_t) bnode.arc_first + bnode.arc_count > hdr->arcs) {
+			throw runtime_error("Corrupt binary CFG node");
+		}
+		ListDigraph::Node node = _cfg.addNode();
+		_cfg.setAddr(node, bnode.addr);
+		_cfg.markHead(node, bnode.is_head != 0);
+		_cfg.setIters(node, bnode.iters);
+		_cfg.setFunction(node, calls[bnode.context]);
+		index[i] = node;
+		for (uint32_t j=0; j < bnode.arc_count; j++) {
+			arc_src[bnode.arc_first + j] = i;
+		}
+	}
+	for (uint32_t i=0; i < hdr->nodes; i++) {
+		if (nodes[i].head == BCFG_NONE) {
+			continue;
+		}
+		if (nodes[i].head >= hdr->nodes) {
+			throw runtime_error("Corrupt binary CFG loop head");
+		}
+		_cfg.setHead(index[i], index[nodes[i].head]);
+	}
+
+	for (uint32_t i=0; i < hdr->arcs; i++) {
+		if (arc_src[i] == BCFG_NONE || arcs[i] >= hdr->nodes) {
+			throw runtime_error("Corrupt binary CFG arc");
+		}
+		_cfg.addArc(index[arc_src[i]], index[arcs[i]]);
+	}
+	for (uint32_t i=0; i < hdr->calls; i++) {
+		uint32_t call = calltab[2*i], entry = calltab[2*i + 1];
+		if (call >= hdr->nodes || entry >= hdr->nodes) {
+			throw runtime_error("Corrupt binary CFG call");
+		}
+		_cfg.setCallee(index[call], index[entry]);
+	}
+
+	findEnds();
+}
+
+void
+CFGReader::readText(string path) {
 	ifstream ifile(path.c_str());
 
 	string line;
@@ -278,15 +578,51 @@ CFGReader::read(string path) {
 	while (addArc(ifile)) {
 		// Let 'er work
 	}
+	/* Only CFGs with shared functions have calls */
+	if (ifile) {
+		for (int i=0; i < 5; i++) {
+			ifile >> line; // Call Header
+		}
+		ifile >> line; //Divider
+		while (addCall(ifile)) {
+		}
+	}
 	
 	ifile.close();
 
+	findEnds();
+}
+
+/**
+ * The initial instruction is the one without predecessors, the
+ * terminal the one without successors.
+ *
+ * With shared functions the entry and the return of every function
+ * look the same, the initial instruction is not called and the
+ * terminal is in its function.
+ */
+void
+CFGReader::findEnds() {
+	set<ListDigraph::Node> entries;
+	map<ListDigraph::Node, ListDigraph::Node>::const_iterator cit;
+	for (cit = _cfg.getCalls().begin(); cit != _cfg.getCalls().end(); ++cit) {
+		entries.insert(cit->second);
+	}
 	for (ListDigraph::NodeIt nit(_cfg); nit != INVALID; ++nit) {
-		if (countInArcs(_cfg, nit) == 0) {
+		if (countInArcs(_cfg, nit) == 0 && entries.count(nit) == 0) {
 			_cfg.setInitial(nit);
 		}
-		if (countOutArcs(_cfg, nit) == 0) {
-			_cfg.setTerminal(nit);
+	}
+	ListDigraph::Node initial = _cfg.getInitial();
+	for (ListDigraph::NodeIt nit(_cfg); nit != INVALID; ++nit) {
+		if (countOutArcs(_cfg, nit) > 0) {
+			continue;
+		}
+		if (_cfg.isShared() && initial != INVALID &&
+		    !_cfg.getFunction(nit).stacksMatch(
+			    _cfg.getFunction(initial))) {
+			continue;
 		}
+		_cfg.setTerminal(nit);
 	}
 }
@@ -5,6 +5,8 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <vector>
+#include <stdint.h>
 using namespace std;
 
 
@@ -20,7 +22,67 @@ using namespace std;
  *   ...
  *   CFGReader cfgr(cfg);
  *   cfgr.read("alpha.cfg");
+ *
+ * CFGs are written in a binary format (see below) unless the text
+ * format is asked for, read() accepts either.
+ */
+
+/**
+ * Binary CFG format, native byte order, laid out as:
+ *
+ *   BCFGHeader
+ *   BCFGNode[nodes]		in the order of the text format
+ *   uint32_t[arcs]		arc targets (node indices), the out arcs
+ *				of a node are contiguous and start at
+ *				BCFGNode::arc_first
+ *   BCFGContext[contexts]	interned function calls
+ *   uint32_t[stack_words]	call sites of every context, top first
+ *   uint32_t[2*calls]		call instruction and callee entry (node
+ *				indices) of each call, see
+ *				CFG::getCallee
+ *   char[strings]		NUL terminated function names
+ *
+ * Arcs are stored in the order they were iterated when written, so
+ * reading back the binary or text form builds the same graph.
+ *
+ * Version 1 had no call table, its header field was reserved (0).
  */
+#define BCFG_MAGIC 0x47464342 /* "BCFG" */
+#define BCFG_VERSION 2
+#define BCFG_NONE 0xFFFFFFFF
+
+struct BCFGHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t nodes;
+	uint32_t arcs;
+	uint32_t contexts;
+	uint32_t stack_words;
+	uint32_t strings;
+	uint32_t calls;
+};
+
+struct BCFGNode {
+	uint64_t addr;
+	uint32_t iters;
+	/* Index of the closest loop head, or BCFG_NONE */
+	uint32_t head;
+	/* Index of the function call in the context table */
+	uint32_t context;
+	uint32_t is_head;
+	/* Out arcs of this node in the arc table */
+	uint32_t arc_first;
+	uint32_t arc_count;
+};
+
+struct BCFGContext {
+	/* Offset of the function name in the string table */
+	uint32_t name;
+	/* Call sites in the stack table */
+	uint32_t stack_first;
+	uint32_t stack_count;
+	uint32_t reserved;
+};
 
 class CFGRWBase {
 public:
@@ -31,15 +93,23 @@ protected:
 
 class CFGWriter : public CFGRWBase {
 public:
-	CFGWriter(CFG &cfg) : CFGRWBase(cfg) {}
+	CFGWriter(CFG &cfg) : CFGRWBase(cfg), _text(false) {}
 	void write(string path);
+	/* Writes the padded text table instead of the binary format */
+	void setText(bool text=true) { _text = text; }
 private:
+	bool _text;
+	void writeText(string path);
+	void writeBinary(string path);
+	/* Nodes in the order they are written, loop heads first */
+	vector<ListDigraph::Node> nodeOrder();
+	void doHeads(vector<ListDigraph::Node> &order,
+	    ListDigraph::NodeMap<bool> &visited, ListDigraph::Node head);
 	string nodeHeader();
-	string arcHeader();		
+	string arcHeader(string title="ARCS");
 	string nodeString(ListDigraph::Node node);
 	string arcString(ListDigraph::Arc arc);
-	void doHeads(ofstream &ofile, ListDigraph::NodeMap<bool> &visited,
-	    ListDigraph::Node head);
+	string linkString(ListDigraph::Node src, ListDigraph::Node tgt);
 };
 
 class CFGReader : public CFGRWBase {
@@ -47,8 +117,16 @@ public:
 	CFGReader(CFG &cfg) : CFGRWBase(cfg) {}
 	void read(string path);
 private:
+	void readText(string path);
+	void readBinary(const char *data, size_t size);
 	void addNode(string addr, ifstream &ifile);
-	bool addArc(ifstream &ifile);	
+	bool addArc(ifstream &ifile);
+	bool addCall(ifstream &ifile);
+	/* Reads two instructions joined by an arrow */
+	bool readLink(ifstream &ifile, ListDigraph::Node &src,
+		      ListDigraph::Node &dst);
+	/* Sets the initial and terminal nodes from the graph structure */
+	void findEnds();
 };
 
 #endif /* CFGREADWRITE_H */
@@ -1,63 +1,71 @@
 #include "Cache.h"
+#include "PolicyLRU.h"
 
 Cache::Cache(Cache& other) {
+	_nsets = 0;
+	_ways = 0;
+	reset(other);
+}
+
+void
+Cache::reset(const Cache &other) {
+	bool same = (_nsets == other._nsets && _ways == other._ways);
+
 	_policy = other._policy;
+	_lru = other._lru;
 	_nsets = other._nsets;
 	_ways = other._ways;
 	_linesize = other._linesize;
 	_latency = other._latency;
 	_mem_latency = other._mem_latency;
 
-	map<int, CacheSet*>::iterator it = other._sets.begin();
-	for (; it != other._sets.end(); it++) {
-		CacheSet *set = new CacheSet(*(it->second));
-		_sets.insert(make_pair(it->first, set));
+	if (!same) {
+		shape();
+	}
+	copy(other._lines.begin(), other._lines.end(), _lines.begin());
+	for (uint32_t i = 0; i < _nsets; i++) {
+		_sets[i]._valid = other._sets[i]._valid;
 	}
 }
 
-CacheSet* Cache::setOf(iaddr_t addr) {
-	uint32_t set = setIndex(addr);
-
-	map<int, CacheSet*>::iterator it = _sets.find(set);
-	if (it != _sets.end()) {
-		/* The set exists */
-		return it->second;
+void
+Cache::shape() {
+	if (_ways > CacheSet::MAX_WAYS) {
+		throw runtime_error("Cache: at most 64 ways are supported");
+	}
+	_lines.assign(_nsets * _ways, 0);
+	_sets.clear();
+	_sets.reserve(_nsets);
+	for (uint32_t i = 0; i < _nsets; i++) {
+		_sets.push_back(CacheSet(this, &_lines[i * _ways]));
 	}
-	/* The set does not exist */
-	CacheSet *rval = new CacheSet(this);
-	_sets[set] = rval;
-	return rval;
 }
 
-uint32_t
-Cache::setIndex(iaddr_t addr) const {
-	iaddr_t begin = addr - (addr % _linesize);
-	uint32_t set = (begin / _linesize) % _nsets;
+void
+Cache::setPolicy(ReplacementPolicy *p) {
+	_policy = p;
+	_lru = (dynamic_cast<PolicyLRU *>(p) != NULL);
+}
 
-	return set;
+CacheSet*
+Cache::setOf(iaddr_t addr) {
+	return &_sets[setIndex(addr)];
 }
 
 bool
 Cache::present(iaddr_t addr) {
-	CacheSet *cs = setOf(addr);
-	return cs->present(addr);
+	return _sets[setIndex(addr)].present(addr);
 }
 
 void Cache::insert(iaddr_t addr) {
-	CacheSet *cs = setOf(addr);
-	cs->insert(addr);
+	_sets[setIndex(addr)].insert(addr);
 }
 
 void Cache::clear() {
-	map<int, CacheSet*>::iterator it;
-	for (it = _sets.begin(); it != _sets.end(); it++) {
-		it->second->clear();
-		delete it->second;
+	for (uint32_t i = 0; i < _nsets; i++) {
+		_sets[i].clear();
 	}
-	_sets.clear();
 }
 
 Cache::~Cache() {
-	clear();
 }
-
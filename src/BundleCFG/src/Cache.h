@@ -23,23 +23,34 @@ class ReplacementPolicy;
  *   32 *byte* line size
  *   4-way associative
  *   0,16,32, or 64 kilobytes in size
+ *
+ * The contents of every set are kept in one array of sets x ways
+ * block addresses, allocated when the cache is constructed.
+ * Clearing, copying into and inserting into the cache do not
+ * allocate.
  */
 class Cache {
 public:
 	Cache(int nSets, int nWays, int lineSize, int latency,
 	      uint32_t mem_latency, ReplacementPolicy *p = NULL) {
-		_policy = p;
 		_nsets = nSets;
 		_ways = nWays;
 		_linesize = lineSize;
 		_latency = latency;
 		_mem_latency = mem_latency;
+		setPolicy(p);
+		shape();
 	};  
 	~Cache();
 	/**
 	 * Copy Constructor
 	 */
 	Cache(Cache &other);
+	/**
+	 * Makes this cache a copy of other, reusing the storage when
+	 * the geometry is the same.
+	 */
+	void reset(const Cache &other);
 	/**
 	 * Returns a reference to the replacement policy
 	 */
@@ -47,9 +58,12 @@ public:
 	/**
 	 * Sets the ReplacementPolicy
 	 */
-	void setPolicy(ReplacementPolicy *p) {
-		_policy = p;
-	}
+	void setPolicy(ReplacementPolicy *p);
+	/**
+	 * Returns true if the policy is LRU, whose sets are updated
+	 * without calling the policy.
+	 */
+	bool isLRU() const { return _lru; }
 	/**
 	 * Returns the number of cache sets in the cache.
 	 */
@@ -74,7 +88,16 @@ public:
 	/**
 	 * Returns the index of the set the address *would* be cached in
 	 */
-	uint32_t setIndex(iaddr_t addr) const;
+	uint32_t setIndex(iaddr_t addr) const {
+		return (addr / _linesize) % _nsets;
+	}
+	/**
+	 * Returns the address of the first byte of the block
+	 * containing addr
+	 */
+	iaddr_t blockOf(iaddr_t addr) const {
+		return addr - (addr % _linesize);
+	}
 	/**
 	 * Returns true if the address is currently cached.
 	 */
@@ -84,7 +107,8 @@ public:
 	 */
 	void insert(iaddr_t addr);
 	/**
-	 * Clears the cache contents (not the parameters)
+	 * Clears the cache contents (not the parameters), does not
+	 * release the storage
 	 */
 	void clear();
 	/**
@@ -97,8 +121,14 @@ public:
 	 */
 	uint32_t memLatency() { return _mem_latency; }
 private:
-	map <int, CacheSet *> _sets;
+	/* Sizes the storage and points each set at its ways */
+	void shape();
+
+	/* Block address cached in each way, set after set */
+	vector<iaddr_t> _lines;
+	vector<CacheSet> _sets;
 	ReplacementPolicy *_policy;
+	bool _lru;
 	uint32_t _nsets;
 	uint32_t _ways;
 	uint32_t _linesize; /** Size of each cache line in bytes */
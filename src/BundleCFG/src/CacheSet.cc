@@ -4,26 +4,36 @@ using namespace std;
 
 CacheSet::CacheSet(Cache* cache) : _cache(cache) {
 	_ways = cache->getWays();
+	if (_ways > MAX_WAYS) {
+		throw runtime_error("CacheSet: at most 64 ways are supported");
+	}
+	_own.assign(_ways, 0);
+	_lines = _own.data();
+	_valid = 0;
+}
+
+CacheSet::CacheSet(Cache *cache, iaddr_t *lines) : _cache(cache) {
+	_ways = cache->getWays();
+	_lines = lines;
+	_valid = 0;
 }
 
-CacheSet::CacheSet(CacheSet &other) : _cache(other._cache) {
+CacheSet::CacheSet(const CacheSet &other) : _cache(other._cache) {
 	_ways = other._ways;
-	map<uint32_t, CacheLine*>::iterator it;
-	for (it = other._storage.begin(); it != other._storage.end(); it++) {
-		CacheLine *value = new CacheLine();
-		*value = *it->second;
-		_storage.insert(make_pair(it->first, value));
-	}
+	_own.assign(other._lines, other._lines + _ways);
+	_lines = _own.data();
+	_valid = other._valid;
 }
 
+CacheSet::CacheSet(CacheSet &&other) = default;
+
 CacheSet::~CacheSet() {
-	clear();
 }
 
 bool CacheSet::present(iaddr_t addr) {
-	map<uint32_t, CacheLine*>::iterator it;
-	for (it = _storage.begin(); it != _storage.end(); it++) {
-		if (it->second->present(addr)) {
+	iaddr_t block = _cache->blockOf(addr);
+	for (uint32_t line = 0; line < _ways; line++) {
+		if ((_valid >> line & 1) && _lines[line] == block) {
 			return true;
 		}
 	}
@@ -31,52 +41,41 @@ bool CacheSet::present(iaddr_t addr) {
 }
 
 bool CacheSet::evicts(iaddr_t addr) {
+	if (_cache->isLRU()) {
+		return !present(addr) && isFull();
+	}
 	ReplacementPolicy *p = _cache->getPolicy();
 	return p->evicts(*this, addr);
 }
 
 void CacheSet::insert(iaddr_t addr) {
-	ReplacementPolicy *p = _cache->getPolicy();
-	uint32_t line = p->lineOf(*this, addr);
-	uint32_t line_size = _cache->getLineSize();
-	map<uint32_t, CacheLine*>::iterator it = _storage.find(line);
-
-	if (it != _storage.end()) {
-		/* Resize is destructive */
-		if (_storage[line]->size() != line_size) {
-			_storage[line]->resize(line_size);
-		}
-		
-	} else {
-		/* New Cache Line */
-		_storage.insert(make_pair(line, new CacheLine));
-		_storage[line]->resize(line_size);
+	/* LRU always places the youngest block in line 0 */
+	uint32_t line = 0;
+	if (!_cache->isLRU()) {
+		ReplacementPolicy *p = _cache->getPolicy();
+		line = p->lineOf(*this, addr);
 	}
-	_storage[line]->store(addr);
+	_lines[line] = _cache->blockOf(addr);
+	_valid |= (uint64_t) 1 << line;
 }
 
-void CacheSet::clear() {
-	map<uint32_t, CacheLine*>::iterator it;
-	for (it = _storage.begin(); it != _storage.end(); it++) {
-		delete it->second;
-	}
-	_storage.clear();
-}
-
-bool CacheSet::empty() {
-	return _storage.empty();
-}
-	
 bool CacheSet::isFull() {
-	return _storage.size() < _ways;
+	uint64_t all = (_ways == MAX_WAYS) ? ~(uint64_t) 0 :
+	    ((uint64_t) 1 << _ways) - 1;
+	return _valid == all;
 }
 
 CacheLine* CacheSet::cacheLine(uint32_t index) {
 	if (index >= _ways) {
 		throw runtime_error("CacheSet::cacheLine index out of bounds");
 	}
-	if (index >= _storage.size()) {
+	if (!(_valid >> index & 1)) {
 		return NULL;
 	}
-	return _storage[index];
+	if (!_line) {
+		_line.reset(new CacheLine());
+	}
+	_line->resize(_cache->getLineSize());
+	_line->store(_lines[index]);
+	return _line.get();
 }
@@ -4,6 +4,7 @@
 #include "Cache.h"
 #include "CFG.h"
 #include <map>
+#include <memory>
 #include <vector>
 #include <stdexcept>
 
@@ -13,15 +14,22 @@
  * Each cache set is indexed from 0->(N-1) where N is the number of
  * ways in the cache. A 2 way associative cache has 2 ways, or sets
  * with lines = {0,1}
+ *
+ * The sets of a Cache are views of the cache's storage. A set
+ * constructed on its own, or copied, has storage of its own.
  */
 class CacheSet {
+	friend class Cache;
 	friend class PolicyLRU;
 public:
+	static const uint32_t MAX_WAYS = 64;
+
 	CacheSet(Cache* cache);
 	/**
 	 * Specialized Copy Constructor
 	 */
-	CacheSet(CacheSet &other);
+	CacheSet(const CacheSet &other);
+	CacheSet(CacheSet &&other);
 	/**
 	 * Destructor
 	 */
@@ -43,17 +51,18 @@ public:
 	/**
 	 * Clears the cache set
 	 */
-	void clear();
+	void clear() { _valid = 0; }
 	/**
 	 * Returns true if the cache set is empty
 	 */
-	bool empty();
+	bool empty() { return _valid == 0; }
 	/**
 	 * Returns true if the cache ses is full
 	 */
 	bool isFull();
 	/**
-	 * Returns a pointer to the cache line at the index
+	 * Returns a copy of the cache line at the index, NULL if the
+	 * line is empty. The copy is valid until the next call.
 	 */
 	CacheLine* cacheLine(uint32_t index);
 	/**
@@ -62,9 +71,17 @@ public:
 	uint32_t ways() { return _ways; }
 private:
 	/**
-	 * Storage for the Cache Set, each of the ways is given a CacheLine
+	 * A view of the storage of a Cache
+	 */
+	CacheSet(Cache *cache, iaddr_t *lines);
+	/**
+	 * Block address stored in each of the ways
+	 */
+	iaddr_t *_lines;
+	/**
+	 * Bit per way, set when the way holds a block
 	 */
-	map<uint32_t, CacheLine*> _storage;
+	uint64_t _valid;
 	/**
 	 * The number of lines in the cache set, the associativity
 	 */
@@ -73,5 +90,13 @@ private:
 	 * Cache this set belongs to
 	 */
 	const Cache *_cache;
+	/**
+	 * Storage of a set that is not part of a Cache
+	 */
+	vector<iaddr_t> _own;
+	/**
+	 * Returned by cacheLine()
+	 */
+	unique_ptr<CacheLine> _line;
 };
 #endif /* CACHE_SET_H */
@@ -1,14 +1,18 @@
 #include "DBG.h"
-DBG::DBG() {
+DBG::DBG(const string &comp) {
+	_trace = comp.empty() ? TRACE_OFF : Trace::level(comp);
 	_level=-2;
 	inc("");
 }
 
 void
 DBG::inc(string pfx, string fill) {
+	_level++;
+	if (!on(TRACE_INFO)) {
+		return;
+	}
 	_pfxs.push(pfx);
 	_fill = fill;
-	_level++;
 
 	string indent="";
 	for (int i=0; i < _level; i++) {
@@ -20,17 +24,31 @@ DBG::inc(string pfx, string fill) {
 }
 void
 DBG::dec() {
+	_level--;
+	if (!on(TRACE_INFO)) {
+		return;
+	}
 	_pfxs.pop();
 	_indents.pop();
-	_level--;
 	update();
 }
 void
 DBG::flush(ostream &stream) {
+	if (!on(TRACE_INFO)) {
+		return;
+	}
 	stream << buf.str();
 	stream.flush();
 	buf.str("");
 }
+void
+DBG::flush(TraceFile &file) {
+	if (!on(TRACE_INFO)) {
+		return;
+	}
+	file.write(buf.str());
+	buf.str("");
+}
 
 
 void
@@ -5,14 +5,27 @@
 #include<sstream>
 #include<stack>
 #include<iostream>
+
+#include "Trace.h"
 using namespace std;
 
+/**
+ * Indented trace output of a component.
+ *
+ * The component's trace level is looked up when the object is made.
+ * When the component is not traced the indentation is not kept and
+ * flushing writes nothing, use DBG_OUT/DBG_BUF so the trace arguments
+ * are not formatted either.
+ */
 class DBG  {
 public:
-	DBG();
+	DBG(const string &comp="");
 	void inc(string pfx="", string fill=" ");
 	void dec();
 	void flush(ostream &stream);
+	void flush(TraceFile &file);
+	/* True when the component traces at the level */
+	bool on(TraceLevel lvl=TRACE_DEBUG) const { return _trace >= lvl; }
 	stringstream buf;
 	/* 
 	 * Symbol that can be added to the end of a line to continue a
@@ -26,6 +39,7 @@ public:
 	int getLevel() { return _level; }
 private:
 	void update();
+	TraceLevel _trace;
 	int _level;
 	stack<string> _indents;
 	stack<string> _pfxs;
@@ -33,4 +47,16 @@ private:
 	uint64_t _age=0;
 };
 
+/**
+ * Start a trace line, or continue one, at a level. When the component
+ * is not traced at that level the rest of the statement is skipped.
+ *
+ *   #define dout DBG_OUT(dbg, TRACE_DEBUG)
+ *   dout << "visited " << cfg.stringNode(node) << endl;
+ */
+#define DBG_OUT(d, lvl) \
+	!(d).on(lvl) ? (void) 0 : TraceVoid() & (d).buf << (d).start
+#define DBG_BUF(d, lvl) \
+	!(d).on(lvl) ? (void) 0 : TraceVoid() & (d).buf
+
 #endif /* DBG_H */
@@ -1,8 +1,129 @@
 #include "FunctionCall.h"
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
-CallStack::CallStack(initializer_list<uint32_t> list) {
-	for (auto elem : list) {
-		push_back(elem);
+/**
+ * A node of the call stack trie, the stack with addr on top of rest
+ */
+struct CallSite {
+	uint32_t id;
+	uint32_t addr;
+	int depth;
+	const CallSite *rest;
+	/* The stacks with one more call on top of this one */
+	mutable unordered_map<uint32_t, const CallSite*> pushed;
+	/* The string form, built on the first call to str() */
+	mutable string str;
+	mutable bool has_str;
+};
+
+/**
+ * The interned call stacks, function names and function calls
+ *
+ * Entries are only added, the lock guards the additions and the lazily
+ * built strings. Reading the fields of an existing CallSite needs no
+ * lock.
+ */
+class CallContexts {
+public:
+	static CallContexts& get() {
+		static CallContexts contexts;
+		return contexts;
+	}
+	const CallSite* empty() const { return &_sites.front(); }
+	const CallSite* push(const CallSite *rest, uint32_t addr);
+	const string& str(const CallSite *site);
+	const string* name(const string &name);
+	uint32_t call(const string *name, uint32_t stack);
+private:
+	mutex _lock;
+	/* Never moves its elements, so CallSite pointers stay valid */
+	deque<CallSite> _sites;
+	unordered_set<string> _names;
+	/* (name, stack id) -> function call id */
+	unordered_map<const string*,
+		      unordered_map<uint32_t, uint32_t> > _calls;
+	uint32_t _ncalls;
+
+	CallContexts() : _ncalls(0) {
+		_sites.push_back(CallSite());
+		CallSite &root = _sites.back();
+		root.id = 0;
+		root.addr = 0;
+		root.depth = 0;
+		root.rest = NULL;
+		root.has_str = false;
+	}
+};
+
+const CallSite*
+CallContexts::push(const CallSite *rest, uint32_t addr) {
+	lock_guard<mutex> guard(_lock);
+	unordered_map<uint32_t, const CallSite*>::iterator it =
+		rest->pushed.find(addr);
+	if (it != rest->pushed.end()) {
+		return it->second;
+	}
+	_sites.push_back(CallSite());
+	CallSite &site = _sites.back();
+	site.id = _sites.size() - 1;
+	site.addr = addr;
+	site.depth = rest->depth + 1;
+	site.rest = rest;
+	site.has_str = false;
+	rest->pushed[addr] = &site;
+	return &site;
+}
+
+const string&
+CallContexts::str(const CallSite *site) {
+	lock_guard<mutex> guard(_lock);
+	if (!site->has_str) {
+		stringstream ss;
+		ss << "T[" << hex;
+		for (const CallSite *it = site; it->depth > 0; it = it->rest) {
+			if (it != site) {
+				ss << ", ";
+			}
+			ss << "0x" << it->addr;
+		}
+		ss << "]" << dec;
+		site->str = ss.str();
+		site->has_str = true;
+	}
+	return site->str;
+}
+
+const string*
+CallContexts::name(const string &name) {
+	lock_guard<mutex> guard(_lock);
+	return &*_names.insert(name).first;
+}
+
+uint32_t
+CallContexts::call(const string *name, uint32_t stack) {
+	lock_guard<mutex> guard(_lock);
+	unordered_map<uint32_t, uint32_t> &ids = _calls[name];
+	unordered_map<uint32_t, uint32_t>::iterator it = ids.find(stack);
+	if (it != ids.end()) {
+		return it->second;
+	}
+	ids[stack] = _ncalls;
+	return _ncalls++;
+}
+
+CallStack::CallStack() : _top(CallContexts::get().empty()) {
+}
+
+CallStack::CallStack(initializer_list<uint32_t> list) :
+    _top(CallContexts::get().empty()) {
+	/* The list is top first, push the bottom first */
+	for (const uint32_t *it = list.end(); it != list.begin(); ) {
+		push(*--it);
 	}
 }
 
@@ -14,91 +135,76 @@ operator<<(ostream &stream, const CallStack &cs) {
 
 string
 CallStack::str() const {
-	stringstream ss;
-	CallStack::const_iterator it;
-	ss << "T[" << hex;
-	for (it=begin(); it != end(); ++it) {
-		if (it != begin()) {
-			ss << ", ";
-		}
-		ss << "0x" << *it;
-	}
-	ss << "]" << dec;
-	return ss.str();
-}
-
-bool
-CallStack::operator==(const CallStack &other) const {
-	CallStack::const_iterator this_it;
-	CallStack::const_iterator other_it;
-	for (this_it = begin(), other_it = other.begin();
-	     this_it != end() && other_it != other.end();
-	     ++this_it, ++other_it) {
-		if (*this_it != *other_it) {
-			return false;
-		}
-	}
-	return true;
+	return CallContexts::get().str(_top);
 }
 
 void
 CallStack::push(uint32_t addr) {
-	push_front(addr);
+	_top = CallContexts::get().push(_top, addr);
 }
 
 uint32_t
 CallStack::peek() const {
-	return front();
+	if (_top->depth == 0) {
+		throw runtime_error("CallStack::peek Empty stack");
+	}
+	return _top->addr;
 }
 
 uint32_t
 CallStack::pop() {
 	uint32_t rval = peek();
-	pop_front();
+	_top = _top->rest;
 	return rval;
 }
 
-void
-CallStack::copy(const CallStack &copy) {
-	CallStack::const_iterator it;
-	clear();
-	for (it = copy.begin(); it != copy.end(); ++it) {
-		push_back(*it);
-	}
+int
+CallStack::size() const {
+	return _top->depth;
 }
 
+uint32_t
+CallStack::id() const {
+	return _top->id;
+}
 
-FunctionCall::FunctionCall() {
-	_function_name = "-NA-";
+
+FunctionCall::FunctionCall() :
+    _function_name(CallContexts::get().name("-NA-")), _id(NO_ID) {
 }
 
 FunctionCall::FunctionCall(const FunctionCall &other) :
-    _function_name(other._function_name), _call_stack(other._call_stack) {
+    _function_name(other._function_name), _id(other._id.load()),
+    _call_stack(other._call_stack) {
 }
 
 void
 FunctionCall::copy(const FunctionCall &other) {
 	_function_name = other._function_name;
+	_id = other._id.load();
 	_call_stack.copy(other._call_stack);
 }
 
 FunctionCall::FunctionCall(string name, const CallStack &cs) :
-    _function_name(name), _call_stack(cs) {
+    _function_name(CallContexts::get().name(name)), _id(NO_ID),
+    _call_stack(cs) {
 }
 
 FunctionCall::FunctionCall(const FunctionCall &prev, string name, uint32_t site) :
-    _function_name(name), _call_stack(prev._call_stack) {
-	_call_stack.push(site);	
+    _function_name(CallContexts::get().name(name)), _id(NO_ID),
+    _call_stack(prev._call_stack) {
+	_call_stack.push(site);
 }
 
 string
 FunctionCall::getName() const {
-	return _function_name;
+	return *_function_name;
 }
 
 void
 FunctionCall::setName(string name) {
-	_function_name = name;
+	_function_name = CallContexts::get().name(name);
+	_id = NO_ID;
 }
 
 void
@@ -111,9 +217,22 @@ FunctionCall::stacksMatch(FunctionCall const &other) const {
 	return _call_stack == other._call_stack;
 }
 
+uint32_t
+FunctionCall::id() const {
+	uint64_t stack = _call_stack.id();
+	uint64_t id = _id.load(memory_order_relaxed);
+	if (id == NO_ID || (id >> 32) != stack) {
+		id = (stack << 32) |
+			CallContexts::get().call(_function_name, stack);
+		_id.store(id, memory_order_relaxed);
+	}
+	return (uint32_t) id;
+}
+
 FunctionCall&
 FunctionCall::operator=(const FunctionCall &other) {
 	_function_name = other._function_name;
+	_id = other._id.load();
 	_call_stack.copy(other._call_stack);
 	return *this;
 }
@@ -123,7 +242,7 @@ FunctionCall::operator==(const FunctionCall &other) const {
 
 	if (_call_stack == other._call_stack) {
 		/* Function names don't matter in comparisons just the address */
-		if (0 != _function_name.compare(other._function_name)) {
+		if (_function_name != other._function_name) {
 			throw runtime_error("Unexpected difference in function names");
 		}
 	}
@@ -132,9 +251,7 @@ FunctionCall::operator==(const FunctionCall &other) const {
 
 string
 FunctionCall::str() const {
-	stringstream ss;
-	ss << getName() << ":" << _call_stack;
-	return ss.str();
+	return *_function_name + ":" + _call_stack.str();
 }
 
 std::ostream&
@@ -142,4 +259,3 @@ operator<< (std::ostream &stream, const FunctionCall& fcall) {
 	stream << fcall.str();
 	return stream;
 }
-
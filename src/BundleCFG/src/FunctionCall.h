@@ -7,26 +7,43 @@
 #include<list>
 #include<sstream>
 #include<initializer_list>
+#include<atomic>
 using namespace std;
 
+/* An interned call stack, see CallStack */
+struct CallSite;
+
 /**
  * Represents a call stack for a function
+ *
+ * Call stacks are interned, every distinct stack is kept once in a
+ * process wide trie where each entry points to the stack below its
+ * top. A CallStack is only a pointer into the trie, so copies,
+ * comparisons and hashes are constant time and the deep stacks of
+ * inlined programs are shared by every instruction using them.
+ *
+ * Each distinct stack has a dense id, 0 is the empty stack. The
+ * interned stacks are never freed.
  */
-class CallStack : list<uint32_t> {
+class CallStack {
 public:
-	/* Has a default copy constructor, may not be exposed */
-	CallStack() {
-	};
+	CallStack();
 	/**
 	 * Creates a call stack with
 	 *   Example: CallStack cs({0x4080, 0x4020, 0x4000});
 	 *
-	 *   Stack Will be T[0x4080, 0x4020, 0x4000] 
+	 *   Stack Will be T[0x4080, 0x4020, 0x4000]
 	 *   Where 0x4080 is the top of the stack.
 	 */
 	CallStack(initializer_list<uint32_t> list);
 	friend ostream &operator<<(ostream &stream, const CallStack &cs);
-	bool operator==(const CallStack &other) const;
+	bool operator==(const CallStack &other) const {
+		return _top == other._top;
+	}
+	bool operator!=(const CallStack &other) const {
+		return _top != other._top;
+	}
+	/* Built once per distinct stack */
 	string str() const;
 
 	/**
@@ -44,17 +61,28 @@ public:
 	/**
 	 * Copies another stack
 	 */
-	void copy(const CallStack& other);
+	void copy(const CallStack& other) { _top = other._top; }
 	/**
 	 * Count of the elements on the stack
 	 */
-	int size() {
-		return list::size();
-	}
+	int size() const;
+	/**
+	 * The dense id of the stack, equal stacks have equal ids
+	 */
+	uint32_t id() const;
+	/**
+	 * Hash of the call sites on the stack, equal stacks have equal
+	 * hashes
+	 */
+	size_t hash() const { return id(); }
+private:
+	const CallSite *_top;
 };
 
 /**
  * Represents the function call that is on the stack for an instruction
+ *
+ * Holds the interned name and call stack, see CallStack.
  */
 class FunctionCall {
 public:
@@ -88,13 +116,27 @@ public:
 	CallStack& stack() { return _call_stack; };
 	bool stacksMatch(const FunctionCall &other) const;
 	void fillStack(CallStack &other) const;
+	/**
+	 * The dense id of the (name, call stack) pair, equal function
+	 * calls with equal names have equal ids
+	 *
+	 * Interned on the first call and kept until the name or the
+	 * stack changes, later calls take no lock.
+	 */
+	uint32_t id() const;
 
 private:
-	/* Function name */
-	string _function_name;
+	/* Function name, interned */
+	const string *_function_name;
+	/* Stack id in the high word, function call id in the low word,
+	 * NO_ID until id() is called. Keyed by the stack id since the
+	 * stack can change through stack().
+	 */
+	mutable atomic<uint64_t> _id;
+	static const uint64_t NO_ID = ~(uint64_t) 0;
 	/* Call stack for *this* function
 	 *   If this function was called by an instruction at 0x402,
-	 *   the top of the stack will be 0x402 
+	 *   the top of the stack will be 0x402
 	 */
 	CallStack _call_stack;
 };
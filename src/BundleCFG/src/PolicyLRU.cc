@@ -12,38 +12,35 @@ PolicyLRU::lineOf(CacheSet& set, iaddr_t addr) {
 
 void
 PolicyLRU::store(CacheSet& set, iaddr_t addr) {
+	iaddr_t block = set._cache->blockOf(addr);
 	uint32_t line;
 	for (line=0; line < set._ways; line++) {
-		if (set._storage[line]->present(addr)) {
+		if ((set._valid >> line & 1) && set._lines[line] == block) {
 			/* Found it! */
 			break;
 		}
 	}
-	if (line != set._ways && line != 0) {
-		/*
-		 * The address is present in the cache, everything
-		 * else needs to be moved down.
-		 */
-		for (uint32_t tgt = line; tgt > 0; tgt--) {
-			*(set._storage[tgt]) = *(set._storage[tgt - 1]);
-		}
+	if (line == set._ways) {
+		/* Not present, the oldest line is dropped */
+		line = set._ways - 1;
+	}
+	/* Everything younger than the line moves down */
+	for (uint32_t tgt = line; tgt > 0; tgt--) {
+		set._lines[tgt] = set._lines[tgt - 1];
 	}
-	set._storage[0]->store(addr);
+	uint64_t below = ((uint64_t) 1 << line) - 1;
+	set._valid = (set._valid & ~((below << 1) | 1)) |
+	    ((set._valid & below) << 1) | 1;
+	set._lines[0] = block;
 }
 
 
 bool
 PolicyLRU::evicts(CacheSet& set, iaddr_t addr) {
-	map<uint32_t, CacheLine*>::iterator it;	
-	for (it = set._storage.begin(); it != set._storage.end(); it++) {
-		if (it->second->present(addr)) {
-			/* Present, won't evict */
-			return false;
-		}
-	}
-	if (set._storage.size() == set._ways) {
-		/* No empty line */
-		return true;
+	if (set.present(addr)) {
+		/* Present, won't evict */
+		return false;
 	}
-	return false;
+	/* No empty line */
+	return set.isFull();
 }
@@ -0,0 +1,152 @@
+#include "Trace.h"
+
+#include <stdexcept>
+
+const size_t TraceFile::CHUNK_BYTES;
+const size_t TraceFile::QUEUE_BYTES;
+
+static const char *components[] = {
+	"cfgfactory", "cfrfactory", "cfrg", "cfr", "wceto", "cfrgwceto"
+};
+
+map<string, TraceLevel> Trace::_levels;
+
+static TraceLevel
+parse_level(const string &name, const string &spec) {
+	if (name == "off") {
+		return TRACE_OFF;
+	}
+	if (name == "info") {
+		return TRACE_INFO;
+	}
+	if (name == "debug") {
+		return TRACE_DEBUG;
+	}
+	throw runtime_error("Invalid trace level in: " + spec);
+}
+
+void
+Trace::configure(const string &spec) {
+	stringstream ss(spec);
+	string item;
+	while (getline(ss, item, ',')) {
+		if (item.empty()) {
+			continue;
+		}
+		string comp = item;
+		TraceLevel lvl = TRACE_DEBUG;
+		size_t idx = item.find(':');
+		if (idx != string::npos) {
+			comp = item.substr(0, idx);
+			lvl = parse_level(item.substr(idx + 1), spec);
+		}
+
+		bool known = false;
+		for (size_t i=0; i < sizeof(components)/sizeof(*components); i++) {
+			if (comp == "all" || comp == components[i]) {
+				_levels[components[i]] = lvl;
+				known = true;
+			}
+		}
+		if (!known) {
+			throw runtime_error("Unknown trace component: " + comp);
+		}
+	}
+}
+
+TraceLevel
+Trace::level(const string &comp) {
+	map<string, TraceLevel>::const_iterator it = _levels.find(comp);
+	if (it == _levels.end()) {
+		return TRACE_OFF;
+	}
+	return it->second;
+}
+
+void
+Trace::reset() {
+	_levels.clear();
+}
+
+void
+TraceFile::open(const string &path, const string &comp, TraceLevel lvl) {
+	close();
+	if (!Trace::enabled(comp, lvl)) {
+		return;
+	}
+	_file.open(path.c_str());
+	if (!_file) {
+		throw runtime_error("Could not open " + path);
+	}
+	_on = true;
+	_closing = false;
+	_writer = thread(&TraceFile::run, this);
+}
+
+void
+TraceFile::write(const string &text) {
+	if (!_on || text.empty()) {
+		return;
+	}
+	unique_lock<mutex> lock(_lock);
+	_pending += text;
+	if (_pending.size() >= CHUNK_BYTES) {
+		queue(lock);
+	}
+}
+
+/**
+ * Hands the pending text to the writer, waiting while the writer is
+ * too far behind
+ */
+void
+TraceFile::queue(unique_lock<mutex> &lock) {
+	while (_queued >= QUEUE_BYTES) {
+		_space.wait(lock);
+	}
+	_queued += _pending.size();
+	_queue.push_back(string());
+	_queue.back().swap(_pending);
+	_ready.notify_one();
+}
+
+void
+TraceFile::run() {
+	unique_lock<mutex> lock(_lock);
+	while (true) {
+		while (_queue.empty() && !_closing) {
+			_ready.wait(lock);
+		}
+		if (_queue.empty()) {
+			break;
+		}
+		string chunk;
+		chunk.swap(_queue.front());
+		_queue.pop_front();
+
+		lock.unlock();
+		_file << chunk;
+		lock.lock();
+
+		_queued -= chunk.size();
+		_space.notify_all();
+	}
+}
+
+void
+TraceFile::close() {
+	if (!_on) {
+		return;
+	}
+	{
+		unique_lock<mutex> lock(_lock);
+		if (!_pending.empty()) {
+			queue(lock);
+		}
+		_closing = true;
+		_ready.notify_one();
+	}
+	_writer.join();
+	_file.close();
+	_on = false;
+}
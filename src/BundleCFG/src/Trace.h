@@ -0,0 +1,140 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+using namespace std;
+
+/**
+ * How much a component traces, each level includes the ones before it
+ */
+enum TraceLevel {
+	TRACE_OFF = 0,
+	TRACE_INFO,
+	TRACE_DEBUG
+};
+
+/**
+ * The trace levels of the components, picked at runtime.
+ *
+ * Tracing is off unless configured. The configuration is read by
+ * every traced object when it is created, so it must be set before
+ * the analysis starts and is not changed afterwards.
+ *
+ * Components:
+ *   cfgfactory - CFG construction (BundleCFG)
+ *   cfrfactory - CFR construction
+ *   cfrg       - CFRG ordering
+ *   cfr        - CFR costs
+ *   wceto      - WCETO calculation
+ *   cfrgwceto  - the older CFRG WCETO calculation
+ *   all        - every component
+ *
+ * Usage:
+ *   Trace::configure("cfrfactory:debug,cfrg:info");
+ *   if (Trace::enabled("cfrg", TRACE_INFO)) ...
+ */
+class Trace {
+public:
+	/**
+	 * Sets component levels from a list of the form
+	 *   <component>[:<level>][,<component>[:<level>]...]
+	 * where level is off, info or debug (the default).
+	 *
+	 * @throws runtime_error for an unknown component or level
+	 */
+	static void configure(const string &spec);
+	static TraceLevel level(const string &comp);
+	static bool enabled(const string &comp, TraceLevel lvl=TRACE_DEBUG) {
+		return level(comp) >= lvl;
+	}
+	/* Resets every component to off */
+	static void reset();
+private:
+	static map<string, TraceLevel> _levels;
+};
+
+/**
+ * A trace file, written by a background thread.
+ *
+ * Nothing is opened, and no thread started, unless the component is
+ * traced at the file's level. Writes are gathered into chunks and
+ * handed to the writer, a writer falling behind by more than
+ * QUEUE_BYTES blocks the traced code rather than growing the queue.
+ *
+ * Each analysis job opens its own files (see the log prefixes), any
+ * thread may write to a file.
+ */
+class TraceFile {
+public:
+	static const size_t CHUNK_BYTES = 64 * 1024;
+	static const size_t QUEUE_BYTES = 4 * 1024 * 1024;
+
+	TraceFile() : _on(false), _queued(0), _closing(false) {}
+	~TraceFile() { close(); }
+	/**
+	 * Opens the file if the component is traced at the level
+	 *
+	 * @param[in] path the file
+	 * @param[in] comp the component writing the file
+	 * @param[in] lvl the lowest level that writes the file
+	 */
+	void open(const string &path, const string &comp,
+		  TraceLevel lvl=TRACE_INFO);
+	/* True when writes reach the file */
+	bool on() const { return _on; }
+	void write(const string &text);
+	/* Writes out everything and closes the file */
+	void close();
+private:
+	bool _on;
+	ofstream _file;
+	thread _writer;
+	mutex _lock;
+	condition_variable _ready, _space;
+	string _pending;
+	deque<string> _queue;
+	size_t _queued;
+	bool _closing;
+
+	void queue(unique_lock<mutex> &lock);
+	void run();
+};
+
+/**
+ * One trace statement, handed to its file at the end of the statement
+ */
+class TraceLine {
+public:
+	TraceLine(TraceFile &file) : _file(file) {}
+	~TraceLine() { _file.write(_buf.str()); }
+	ostream& stream() { return _buf; }
+private:
+	TraceFile &_file;
+	stringstream _buf;
+};
+
+/**
+ * Swallows a stream so the trace macros are a single expression
+ */
+class TraceVoid {
+public:
+	void operator&(ostream &) {}
+};
+
+/**
+ * Streams a statement to a TraceFile, when the file is not on the
+ * arguments are not evaluated.
+ *
+ *   TRACE_OUT(log) << "visited " << cfg.stringNode(node) << endl;
+ */
+#define TRACE_OUT(file) \
+	!(file).on() ? (void) 0 : TraceVoid() & TraceLine(file).stream()
+
+#endif /* TRACE_H */
@@ -20,6 +20,7 @@
 #include "CFG.h"
 #include "CFGFactory.h"
 #include "CFGReadWrite.h"
+#include "Trace.h"
 using namespace std;
 using namespace cfglib;
 
@@ -36,8 +37,15 @@ void usage(void) {
 	cout << "Usage: BundleCFG <OPTIONS> <XML Configuration File>" << endl
 	     << "OPTIONS" << endl
 	     << "	-h/--help	this message" << endl
-	     << "	-t/--trace	enable tracing" << endl
+	     << "	-t/--trace[=<component>:<level>,...]" << endl
+	     << "			enable tracing, level is off, info or debug"
+	     << endl
+	     << "			(default all:debug)" << endl
+	     << "	--shared	add each function once instead of inlining"
+	     << endl
+	     << "			it at every call site" << endl
 	     << "	--test		perform tests and exit " << endl
+	     << "	--text		write the CFG as text (debugging)" << endl
 	     << "	-v/--verbose	enable verbose output" << endl
 	     << endl;
 }
@@ -49,20 +57,23 @@ void usage(void) {
  * validity and instigate the analysis.
  */
 int main(int argc, char** argv) {
-	int vflag = 0, teflag = 0, tflag = 0, hflag = 0;
+	int vflag = 0, teflag = 0, tflag = 0, hflag = 0, txflag = 0;
+	int shflag = 0;
 
 	/* Long form command line options */
 	static struct option long_options[] = {
 		{"help", no_argument, &hflag, 1},
+		{"shared", no_argument, &shflag, 1},
 		{"test", no_argument, &teflag, 1},
-		{"trace", no_argument, &tflag, 1},
+		{"text", no_argument, &txflag, 1},
+		{"trace", optional_argument, NULL, 't'},
 		{"verbose", no_argument, &vflag, 1},
 		{0, 0, 0, 0}
 	};
 
 	while (1) {
 		int opt_ind, c;
-		c = getopt_long(argc, argv, "htv", long_options, &opt_ind);
+		c = getopt_long(argc, argv, "ht::v", long_options, &opt_ind);
 		if (c == -1) {
 			/* End of parsed options */
 			break;
@@ -78,6 +89,13 @@ int main(int argc, char** argv) {
 			break;
 		case 't':
 			tflag = 1;
+			try {
+				Trace::configure(optarg ? optarg : "all");
+			} catch (runtime_error &e) {
+				cout << e.what() << endl;
+				usage();
+				return -1;
+			}
 			break;
 		case 'v':
 			vflag = 1;
@@ -152,10 +170,12 @@ int main(int argc, char** argv) {
 	dotprint.PerformAnalysis();
 
 	CFGFactory cfgFact(prog);
+	cfgFact.setShared(shflag);
 	CFG *cfg = cfgFact.produce();
 
 	string CFGFile = base + ".cfg";
 	CFGWriter cfgw(*cfg);
+	cfgw.setText(txflag);
 	cfgw.write(CFGFile);
 
 	/* Clean up and shutdown */
@@ -1,15 +1,16 @@
 #ifndef CFGDFS_H
 #define CFGDFS_H
 #include "CFG.h"
+#include "CFGMap.h"
 
-typedef bool (*CFGDFS_mask_t)(CFG &cfg, ListDigraph::Node node, void *userdata); 
-typedef bool (*CFGDFS_work_t)(CFG &cfg, ListDigraph::Node node, void *userdata);
-typedef bool (*CFGDFS_sel_t)(CFG &cfg, ListDigraph::Node node, void *userdata);
-typedef bool (*CFGDFS_fin_t)(CFG &cfg, ListDigraph::Node node, void *userdata);
+typedef bool (*CFGDFS_mask_t)(const CFG &cfg, ListDigraph::Node node, void *userdata); 
+typedef bool (*CFGDFS_work_t)(const CFG &cfg, ListDigraph::Node node, void *userdata);
+typedef bool (*CFGDFS_sel_t)(const CFG &cfg, ListDigraph::Node node, void *userdata);
+typedef bool (*CFGDFS_fin_t)(const CFG &cfg, ListDigraph::Node node, void *userdata);
 
 class CFGDFS {
 public:
-	CFGDFS(CFG &cfg) : _cfg(cfg), _visited(cfg) {
+	CFGDFS(const CFG &cfg) : _cfg(cfg), _visited(cfg) {
 	}
 	/*
 	 * Performs the depth first search, returns true if the
@@ -52,8 +53,8 @@ public:
 	void setUserData(void *data) { _userdata = data; }
 	void *getUserData() { return _userdata; }
 private:
-	CFG &_cfg;
-	ListDigraph::NodeMap<bool> _visited;
+	const CFG &_cfg;
+	CFGMap<bool> _visited;
 	CFGDFS_mask_t _mask_fn = NULL;
 	CFGDFS_work_t _work_fn = NULL;
 	CFGDFS_sel_t _sel_fn = NULL;
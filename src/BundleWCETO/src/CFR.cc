@@ -12,16 +12,22 @@ CFR::getSwitching() {
 
 ListDigraph::Node
 CFR::addNode(ListDigraph::Node from_cfg) {
-	ListDigraph::Node rv = CFG::addNode();
-
-	if (fromCFG(from_cfg) != INVALID) {
+	if (from_cfg == INVALID || !_cfg.valid(from_cfg)) {
+		throw runtime_error("CFR::addNode invalid CFG node");
+	}
+	if (_nodes.empty()) {
+		/* The first node is not claimed, see isFirst() */
+		_nodes.push_back(from_cfg);
+		return from_cfg;
+	}
+	if (_members.cfr(from_cfg) != NULL || isFirst(from_cfg)) {
 		throw runtime_error( _cfg.stringNode(from_cfg) + " being added twice");
 	}
 
-	_to_cfg[rv] = from_cfg;
-	_from_cfg.insert(make_pair(from_cfg, rv));
-	
-	return rv;
+	_members.set(from_cfg, this, _nodes.size());
+	_nodes.push_back(from_cfg);
+
+	return from_cfg;
 }
 
 ListDigraph::Node
@@ -33,33 +39,27 @@ CFR::toCFG(ListDigraph::Node node) const {
 	if (!valid(node)) {
 		throw runtime_error(s + "bad value");
 	}
-	return _to_cfg[node];
+	return node;
 }
 
 ListDigraph::Node
-CFR::fromCFG(ListDigraph::Node cfg_node) {
-	if (cfg_node == INVALID) {
+CFR::fromCFG(ListDigraph::Node cfg_node) const {
+	if (!valid(cfg_node)) {
 		return INVALID;
 	}
-	map<ListDigraph::Node, ListDigraph::Node>::iterator mit;
-	mit = _from_cfg.find(cfg_node);
-	if (mit != _from_cfg.end()) {
-		return mit->second;
-	}
-	return INVALID;
+	return cfg_node;
 }
 
 void
 CFR::setInitial(ListDigraph::Node cfr_initial) {
-	ListDigraph::Node cfg_initial = toCFG(cfr_initial);
 	if (cfr_initial == INVALID) {
 		throw runtime_error("CFR::setInitial invalid initial node in the CFG");
 	}
-	_membership = cfg_initial;
-	CFG::setInitial(cfr_initial);
+	_membership = toCFG(cfr_initial);
+	_initial = cfr_initial;
 }
 
-/* Gets and sets the function associated with the instruction */
+/* Gets the function associated with the instruction */
 FunctionCall
 CFR::getFunction(ListDigraph::Node node) const {
 	ListDigraph::Node cfg_node = toCFG(node);
@@ -111,20 +111,6 @@ CFR::getHead(ListDigraph::Node node) const {
 	ListDigraph::Node cfg_node = toCFG(node);
 	ListDigraph::Node cfg_head = _cfg.getHead(cfg_node);
 	return cfg_head;
-
-	#if 0
-	map<ListDigraph::Node, ListDigraph::Node>::const_iterator mit;
-	mit = _cfg_head.find(node);
-	if (mit != _cfg_head.end()) {
-		return mit->second;
-	}
-	return INVALID;
-	#endif
-}
-
-void
-CFR::setHead(ListDigraph::Node cfr_node, ListDigraph::Node cfg_node) {
-	_cfg_head.insert(make_pair(cfr_node, cfg_node));
 }
 
 bool
@@ -154,9 +140,14 @@ CFR::str() const {
 	ListDigraph::Node initial = getInitial();
 	ListDigraph::Node cfg_initial = toCFG(initial);
 
+	int arcs = 0;
+	for (NodeIt nit(*this); nit != INVALID; ++nit) {
+		arcs += countOutArcs(*this, nit);
+	}
+
 	stream << "("
-	       << countNodes(*this) << "v, "
-	       << countArcs(*this) << "e, "
+	       << _nodes.size() << "v, "
+	       << arcs << "e, "
 	       << (initial == INVALID ?
 		   "INVALID" : getCFG()->stringNode(cfg_initial))
 	       << ")";
@@ -165,11 +156,10 @@ CFR::str() const {
 
 uint32_t
 CFR::wceto(uint32_t threads) {
-	#define dout dbg.buf << dbg.start
+	#define dout DBG_OUT(dbg, TRACE_DEBUG)
 	dbg.inc("wceto: ");
 	
 	if (threads == 0) { return 0; }
-	calcTerminal();
 
 	uint32_t loadcost = loadCost();
 	uint32_t exe = exeCost();
@@ -183,60 +173,27 @@ CFR::wceto(uint32_t threads) {
 
 uint32_t
 CFR::exeCost() {
-	calcTerminal();
 	if (_exe != 0) {
 		return _exe;
 	}
-	CFGTopSort topo(*this);
-	topo.sort(getInitial());
-
-	ListDigraph::NodeMap<int> dist(*this);
-	for (ListDigraph::NodeIt nit(*this); nit != INVALID; ++nit) {
-		dist[nit] = 0;
-	}
-
 	/* 
-	 * In the case of a CFR that starts a loop, the first
-	 * instruction may or may not be included twice in the
-	 * topological sort, it depends if the entire loop is
-	 * contained within the CFR
-	 *
-	 * To avoid counting that instruction twice, but avoid a
-	 * constant subtraction a visited map is used.
+	 * In the case of a CFR that starts a loop, the arcs back to
+	 * the first instruction are not part of the longest path, so
+	 * it is only counted once.
 	 */
-	ListDigraph::NodeMap<bool> v(*this);
-	
-	pqueue_t::iterator pit;
-	int weight = 1;
-	int maxd = 0;
-	/* Longest path using the result of the topological sort */
-	for (pit = topo.result.begin(); pit != topo.result.end(); ++pit) {
-		ListDigraph::Node n = *pit;
-		if (v[n]) {
-			continue;
-		}
-		v[n] = true;
-		int max = 0;
-		ListDigraph::InArcIt a(*this, n);
-		for ( ; a != INVALID; ++a) {
-			ListDigraph::Node p = source(a);
-			if (dist[p] > max) {
-				max = dist[p];
-			}
-		}
-		if ((max + weight) > dist[n]) {
-			dist[n] = max + weight;
-		}
-		if (dist[n] > maxd) {
-			/* Cheat, don't bother looking at the terminal */
-			maxd = dist[n];
-		}
-	}
-	_exe = maxd *_cache->latency();
+	LongestPathT<CFR> lp(*this);
+	lp.run(getInitial());
+	_exe = lp.maxDist() * _cache->latency() + _call_exe;
 	
 	return _exe;
 }
 
+void
+CFR::addCall(uint32_t wceto, const ECBs &ecbs) {
+	_call_exe += wceto;
+	_call_ecbs.merge(ecbs);
+}
+
 /**
  * Returns the maximum load cost
  */
@@ -256,30 +213,26 @@ CFR::calcECBs() {
 	if (_ecbs.size() != 0) {
 		return _ecbs.size();
 	}
-	_ecbs.clear();
-	Cache scratch(_cache->getSets(), _cache->getWays(),
-		      _cache->getLineSize(), _cache->latency(),
-		      _cache->memLatency(),  _cache->getPolicy());
-	/* XXX-ct clear the cache and run through valgrind */
-	// scratch.clear();
+	_ecbs = ECBs(_cache->getSets());
+	/* The scratch cache keeps its storage from one CFR to the next */
+	static thread_local Cache scratch(1, 1, 1, 1, 1);
+	scratch.reset(*_cache);
 	scratch.clear();
-	for (ListDigraph::NodeIt nit(*this); nit != INVALID; ++nit) {
+	for (NodeIt nit(*this); nit != INVALID; ++nit) {
 		ListDigraph::Node node = nit;
 		iaddr_t addr = getAddr(node);
 		if (!scratch.present(addr)) {
 			uint32_t index = scratch.setIndex(addr);
-			_ecbs.push_back(index);
+			_ecbs.add(index);
 		}
 		scratch.insert(addr);
 	}
+	_ecbs.merge(_call_ecbs);
 
-	_ecbs.sort();
- 	return _ecbs.size();
+	return _ecbs.size();
 }
 
 ECBs*
 CFR::getECBs() {
-	ECBs *ecbs = new ECBs(_ecbs);
-	ecbs->sort();
-	return ecbs;
+	return new ECBs(_ecbs);
 }
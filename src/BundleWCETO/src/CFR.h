@@ -3,16 +3,67 @@
 
 #include "CFRECBs.h"
 #include "CFG.h"
+#include "CFGMap.h"
 #include "DBG.h"
-#include "CFGTopSort.h"
-#include <lemon/dijkstra.h>
+#include "LongestPath.h"
+#include <vector>
 
-class CFR : public CFG {
+class CFR;
+
+/**
+ * The CFR each instruction of a CFG belongs to.
+ *
+ * One is shared by all the CFRs made from a CFG, so membership and the
+ * position of an instruction in its CFR are found in constant time
+ * without any CFR keeping a map of its own.
+ */
+class CFRMembers {
+public:
+	CFRMembers(const CFG &cfg) : _cfr(cfg, NULL), _index(cfg, -1) {}
+	/* The CFR of the instruction, NULL if it has none */
+	CFR* cfr(ListDigraph::Node node) const { return _cfr[node]; }
+	/* The position of the instruction in its CFR */
+	int index(ListDigraph::Node node) const { return _index[node]; }
+	void set(ListDigraph::Node node, CFR *cfr, int index) {
+		_cfr[node] = cfr;
+		_index[node] = index;
+	}
+private:
+	CFGMap<CFR*> _cfr;
+	CFGMap<int> _index;
+};
+
+/**
+ * @class CFR
+ *
+ * A Conflict Free Region, a view of the instructions of a CFG that
+ * belong to it.
+ *
+ * The CFR does not copy the instructions, its nodes are the CFG nodes
+ * and its arcs are the CFG arcs between them (the induced subgraph).
+ * Only the list of member nodes is stored, membership comes from the
+ * shared CFRMembers, so toCFG() and fromCFG() are constant time.
+ *
+ * The graph is read with LEMON style iterators,
+ *
+ *   for (CFR::NodeIt nit(cfr); nit != INVALID; ++nit)
+ *   for (CFR::OutArcIt a(cfr, node); a != INVALID; ++a)
+ *
+ * and the ids of CFR::id() are dense within the CFR, so NodeMaps the
+ * size of the CFR can be kept in vectors.
+ */
+class CFR {
 public:
-	CFR(CFG &cfg) : CFG(), _cfg(cfg), _to_cfg(*this)
+	typedef ListDigraph::Node Node;
+	typedef ListDigraph::Arc Arc;
+
+	CFR(const CFG &cfg, CFRMembers &members) : _cfg(cfg), _members(members)
 	{
 		_switching = true;
 		_exe = 0;
+		_call_exe = 0;
+		_initial = INVALID;
+		_membership = INVALID;
 	}
 	/* Returns the CFR membership of this node */
 	ListDigraph::Node membership(ListDigraph::Node node) const {
@@ -24,13 +75,8 @@ public:
 		}
 		return _membership;
 	}
-	CFR(CFR &cfr) : CFG(), _cfg(cfr._cfg), _to_cfg(*this)
-	{
-		_switching = true;
-		_exe = 0;
-	}
 	/* Returns a pointer to the CFG which this CFR was extracted from */
-	CFG* getCFG() const { return &_cfg; }
+	const CFG* getCFG() const { return &_cfg; }
 
 	/* Gets and sets the Cache */
 	void setCache(Cache *cache) { _cache = cache; }
@@ -46,52 +92,78 @@ public:
 	uint32_t exeCost();
 	/* Finds the cost for loading the cache with all instructions */
 	uint32_t loadCost();
+	/**
+	 * Adds a call made from *this* CFR to a shared function (see
+	 * CFG::getCallee), summarized by its single thread WCETO and the
+	 * ECBs of the function
+	 *
+	 * Every thread pays the whole WCETO of the function on top of
+	 * the execution cost, and the ECBs of the function are loaded
+	 * with the CFR. Must be called before the costs are calculated.
+	 */
+	void addCall(uint32_t wceto, const ECBs &ecbs);
 
 	/*
 	 * ECB calculation and retrieval
 	 *
-	 * Caller of ECBs() must delete the list.
+	 * Caller of getECBs() must delete the ECBs.
 	 */
 	uint32_t calcECBs();
 	ECBs* getECBs();
-	
+
 	/*
-	 * Override to prevent nodes from being added without having a node in
-	 * the original CFG
+	 * Adds an instruction of the CFG to the CFR, the arcs to and
+	 * from the other members come with it
 	 */
-	ListDigraph::Node addNode() {
-		throw runtime_error("Cannot add a node to a CFR without a CFG node");
-	}
 	ListDigraph::Node addNode(ListDigraph::Node from_cfg);
+	/* True if the CFG node is a member of *this* CFR */
+	bool valid(ListDigraph::Node node) const {
+		if (node == INVALID) {
+			return false;
+		}
+		return _members.cfr(node) == this || isFirst(node);
+	}
 	/* Gets the node in the original CFG from the CFR */
 	ListDigraph::Node toCFG(ListDigraph::Node) const;
 	/* Gets the node in the CFR given the CFG node */
-	ListDigraph::Node fromCFG(ListDigraph::Node);
+	ListDigraph::Node fromCFG(ListDigraph::Node) const;
 
-	/* 
-	 * Overloaded methods
-	 * 
-	 * These ensure that the mapping to the control flow graph is preserved 
-	 */
 	/*
-	 * Override to safely store the CFG head node
+	 * Graph access, in the manner of a LEMON digraph
 	 */
-	
+	/* The position of a member in the CFR, from 0 to maxNodeId() */
+	int id(ListDigraph::Node node) const {
+		if (isFirst(node)) {
+			return 0;
+		}
+		return _members.cfr(node) == this ? _members.index(node) : -1;
+	}
+	int maxNodeId() const { return (int) _nodes.size() - 1; }
+	/* The members, in the order they were added */
+	const vector<ListDigraph::Node>& nodes() const { return _nodes; }
+	ListDigraph::Node source(ListDigraph::Arc arc) const {
+		return _cfg.source(arc);
+	}
+	ListDigraph::Node target(ListDigraph::Arc arc) const {
+		return _cfg.target(arc);
+	}
+
+	class NodeIt;
+	class OutArcIt;
+	class InArcIt;
+	ListDigraph::Node runningNode(const OutArcIt &arc) const;
+	ListDigraph::Node runningNode(const InArcIt &arc) const;
+
+	/* The instruction the CFR begins with */
+	ListDigraph::Node getInitial() const { return _initial; }
 	void setInitial(ListDigraph::Node cfr_initial);
-	/* getInitial will return the node *in* the CFR */
 
-	/* Gets and sets the function associated with the instruction */
+	/* Gets the function associated with the instruction */
 	FunctionCall getFunction(ListDigraph::Node node) const;
-	void setFunction(ListDigraph::Node, FunctionCall const &fcall) {
-		throw runtime_error("CFG::setFunction cannot be called on a CFR node");
-	}
 
-	/* Gets and sets the address of the instruction */
+	/* Gets the address of the instruction */
 	iaddr_t getAddr(ListDigraph::Node node) const;
 	string stringAddr(ListDigraph::Node node) const;
-	void setAddr(ListDigraph::Node, iaddr_t addr) {
-		throw runtime_error("CFG::setAddr cannot be called on a CFR node");
-	}
 
 	/* Finds the instruction with the address and function */
 	ListDigraph::Node find(iaddr_t addr, FunctionCall const &fcall);
@@ -104,18 +176,11 @@ public:
 	 * be contained within the CFR
 	 */
 	ListDigraph::Node getHead(ListDigraph::Node node) const;
-	void setHead(ListDigraph::Node cfr_node, ListDigraph::Node cfg_node);
-	/* Gets and sets if the instruction is a loop head */
+	/* Gets if the instruction is a loop head */
 	bool isHead(ListDigraph::Node node) const;
-	void markHead(ListDigraph::Node node, bool yes=true) {
-		throw runtime_error("CFG::markHead cannot be called on a CFR node");
-	}
-	/* Gets and sets the number of iterations in the loop started at the
+	/* Gets the number of iterations in the loop started at the
 	   instruction */
 	unsigned int getIters(ListDigraph::Node head) const;
-	void setIters(ListDigraph::Node head, unsigned int iters) {
-		throw runtime_error("CFG::setIters cannot be called on a CFR node");
-	}
 
 	string stringNode(ListDigraph::Node node) const;
 	friend std::ostream &operator<< (std::ostream &stream, const CFR& cfr);
@@ -127,9 +192,16 @@ private:
 	 * loop head. This is because the loop head may not be contained within
 	 * the CFR.
 	 */
-	CFG &_cfg;
+	const CFG &_cfg;
+	CFRMembers &_members;
+	/* The members in the order they were added */
+	vector<ListDigraph::Node> _nodes;
+	ListDigraph::Node _initial;
 	uint32_t _exe;
 	ECBs _ecbs;
+	/* Summaries of the calls made from *this* CFR */
+	uint32_t _call_exe;
+	ECBs _call_ecbs;
 	/* A CFR cannot exist without a cache */
 	Cache *_cache;
 	/**
@@ -138,23 +210,116 @@ private:
 	 *  does not. This mapping records if it is switching or pass through
 	 */
 	bool _switching;
-	DBG dbg;
-	
-	/* 
-	 * This is the identifier of the CFR (in the CFG) which all nodes belong
-	 * to, the CFR stores the node from the CFG ie 
-	 *
-	 *    (CFR::valid(_membership) == false)
+	DBG dbg{"cfr"};
+
+	/*
+	 * This is the identifier of the CFR (in the CFG), the CFG node
+	 * of its initial instruction
 	 */
 	ListDigraph::Node _membership;
-	/* CFR node -> CFG node */
-	ListDigraph::NodeMap<ListDigraph::Node> _to_cfg;
-	/* CFG node -> CFR node */
-	map<ListDigraph::Node, ListDigraph::Node> _from_cfg;
-	/* CFR node -> CFG node (that is the head) */
-	map<ListDigraph::Node, ListDigraph::Node> _cfg_head;
 
 	uint32_t maxLoads();
+	/*
+	 * The first node added is not claimed in the CFRMembers, a CFR
+	 * may begin with an instruction labelled as part of another CFR
+	 */
+	bool isFirst(ListDigraph::Node node) const {
+		return !_nodes.empty() && _nodes.front() == node;
+	}
+};
+
+/**
+ * The members of a CFR, the most recently added first as a
+ * ListDigraph lists its nodes
+ */
+class CFR::NodeIt : public ListDigraph::Node {
+public:
+	NodeIt() : _cfr(NULL), _pos(-1) {}
+	NodeIt(Invalid) : ListDigraph::Node(INVALID), _cfr(NULL), _pos(-1) {}
+	explicit NodeIt(const CFR &cfr) : _cfr(&cfr), _pos(cfr.maxNodeId()) {
+		update();
+	}
+	NodeIt& operator++() {
+		--_pos;
+		update();
+		return *this;
+	}
+private:
+	const CFR *_cfr;
+	int _pos;
+
+	void update() {
+		ListDigraph::Node &node = *this;
+		node = _pos < 0 ? ListDigraph::Node(INVALID) : _cfr->_nodes[_pos];
+	}
 };
 
+/**
+ * The arcs from a member to members
+ */
+class CFR::OutArcIt : public ListDigraph::Arc {
+public:
+	OutArcIt() : _cfr(NULL) {}
+	OutArcIt(Invalid) : ListDigraph::Arc(INVALID), _cfr(NULL) {}
+	OutArcIt(const CFR &cfr, ListDigraph::Node node) :
+		_cfr(&cfr), _it(cfr._cfg, node) {
+		skip();
+	}
+	OutArcIt& operator++() {
+		++_it;
+		skip();
+		return *this;
+	}
+private:
+	const CFR *_cfr;
+	ListDigraph::OutArcIt _it;
+
+	void skip() {
+		while (_it != INVALID && !_cfr->valid(_cfr->_cfg.target(_it))) {
+			++_it;
+		}
+		ListDigraph::Arc &arc = *this;
+		arc = _it;
+	}
+};
+
+/**
+ * The arcs to a member from members
+ */
+class CFR::InArcIt : public ListDigraph::Arc {
+public:
+	InArcIt() : _cfr(NULL) {}
+	InArcIt(Invalid) : ListDigraph::Arc(INVALID), _cfr(NULL) {}
+	InArcIt(const CFR &cfr, ListDigraph::Node node) :
+		_cfr(&cfr), _it(cfr._cfg, node) {
+		skip();
+	}
+	InArcIt& operator++() {
+		++_it;
+		skip();
+		return *this;
+	}
+private:
+	const CFR *_cfr;
+	ListDigraph::InArcIt _it;
+
+	void skip() {
+		while (_it != INVALID && !_cfr->valid(_cfr->_cfg.source(_it))) {
+			++_it;
+		}
+		ListDigraph::Arc &arc = *this;
+		arc = _it;
+	}
+};
+
+inline ListDigraph::Node
+CFR::runningNode(const OutArcIt &arc) const {
+	return _cfg.target(arc);
+}
+
+inline ListDigraph::Node
+CFR::runningNode(const InArcIt &arc) const {
+	return _cfg.source(arc);
+}
+
 #endif /* CFR_H */
@@ -15,7 +15,7 @@ CFRDemand::str(string pfx) const {
 	   << " load cost: "
 	   << _ecbs->size() * _cfr.getCache()->memLatency() << endl
 	   << pfx << "ecbs: " << _ecbs->str() << endl
-	   << _twmap->str(pfx);
+	   << _twmap.str(pfx);
 	return ss.str();
 }
 
@@ -25,25 +25,21 @@ CFRDemand::CFRDemand(CFR& cfr) :
 	_exe_cycles = cfr.exeCost();
 	_load_cycles = cfr.loadCost();
 	_ecbs = cfr.getECBs();
-	_twmap = new ThreadWCETOMap();
 }
 CFRDemand::CFRDemand(CFRDemand &src) :
-	_cfr(src._cfr) {
-	_twmap = src.copyWCETOMap();
+	_twmap(src._twmap), _cfr(src._cfr) {
 	_exe_cycles = src._exe_cycles;
 	_load_cycles = src._load_cycles;
 	_ecbs = src.copyECBs();
 }
 CFRDemand::~CFRDemand() {
-	delete _twmap;
-	_twmap = NULL;
 	delete _ecbs;
 	_ecbs = NULL;
 }
 
 ThreadWCETOMap&
 CFRDemand::getWCETOMap() {
-	return *_twmap;
+	return _twmap;
 }
 ThreadWCETOMap*
 CFRDemand::copyWCETOMap() {
@@ -78,6 +74,7 @@ CFRDemand::copyECBs() {
 
 CFRDemand*
 CFRDemandMap::present(CFR *cfr) {
+	std::lock_guard<std::mutex> guard(_lock);
 	CFRDemandMap::iterator it = find(cfr);
 	if (it != end()) {
 		return it->second;
@@ -89,16 +86,28 @@ CFRDemandMap::present(CFR *cfr) {
 #undef PARANOIA
 CFRDemand*
 CFRDemandMap::request(CFR *cfr) {
-	CFRDemand *cfrd = present(cfr);
-	if (cfrd) {
-		return cfrd;
+	bool created;
+	return request(cfr, created);
+}
+
+CFRDemand*
+CFRDemandMap::request(CFR *cfr, bool &created) {
+	/* find or insert under one lock, the demand is built on a miss only */
+	std::unique_lock<std::mutex> guard(_lock);
+	CFRDemandMap::iterator it = find(cfr);
+	created = (it == end());
+	if (!created) {
+		return it->second;
 	}
-	cfrd = new CFRDemand(*cfr);
+	CFRDemand *cfrd = new CFRDemand(*cfr);
 	insert(pair<CFR*, CFRDemand*>(cfr, cfrd));
+	guard.unlock();
 
 #ifdef PARANOIA
-	CFRDemandMap::iterator it = find(cfr);
-	if (it->second != cfrd) {
+	guard.lock();
+	CFRDemandMap::iterator chk = find(cfr);
+	guard.unlock();
+	if (chk->second != cfrd) {
 		throw runtime_error("CFRDemandMap::request mismatch in rval");
 	}
 	cout << "CFRDemandMap::request inserted a new DemandMap ("
@@ -5,6 +5,8 @@
 #include "CFRECBs.h"
 #include "CFR.h"
 
+#include <mutex>
+
 /**
  * Maps a CFR pointer to its different types of demand.
  *
@@ -43,7 +45,7 @@ public:
 
 	string str(string pfx="") const;
 private:
-	ThreadWCETOMap *_twmap;
+	ThreadWCETOMap _twmap;
 	uint32_t _load_cycles;
 	uint32_t _exe_cycles;
 	ECBs *_ecbs;
@@ -73,6 +75,19 @@ public:
 	 * @return a pointer to the DemandMap associated with the CFR. 
 	 */
 	CFRDemand* request(CFR* cfr);
+	/**
+	 * Gets the DemandMap for a CFR, creating it if necessary.
+	 *
+	 * @param[in] cfr the CFR for which the Map is being requested.
+	 * @param[out] created true if this call created the DemandMap,
+	 * only one caller sees it for a given CFR.
+	 *
+	 * @return a pointer to the DemandMap associated with the CFR.
+	 */
+	CFRDemand* request(CFR* cfr, bool &created);
 	string str(string pfx="") const;	
+private:
+	/* present() and request() may be called from several threads */
+	std::mutex _lock;
 };
 #endif /* CFRDEMANDMAP_H */
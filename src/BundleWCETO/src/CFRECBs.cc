@@ -1,4 +1,5 @@
 #include "CFRECBs.h"
+#include <algorithm>
 
 std::ostream &
 operator<<(std::ostream& stream, const ECBs& ecbs) {
@@ -9,90 +10,117 @@ operator<<(std::ostream& stream, const ECBs& ecbs) {
 string
 ECBs::str(string pfx) const {
 	stringstream ss;
-	ECBs::const_iterator it, sit;
 	ss << pfx << "(";
-	uint32_t lcount = 0;
-	for (it = begin(); it != end(); it++) {
-		uint32_t cur = *it;
-		if (it != begin()) {
+	bool first = true;
+	for (uint32_t set = 0; set < _counts.size(); set++) {
+		uint32_t count = _counts[set];
+		if (count == 0) {
+			continue;
+		}
+		if (!first) {
 			ss << ", ";
 		}
-		ss << cur;
-		uint32_t count=0;
-		while (it != end()) {
-			count++;
-			sit = it;
-			sit++;
-			if ((*sit) != cur) {
-				break;
-			}
-			it = sit;
-		} 
+		first = false;
+		ss << set;
 		if (count > 1) {
 			ss << "⨯" << count;
 		}
-		if (it == end()) {
-			break;
-		}
 	}
 	ss << ")";
 	return ss.str();
 }
 
-ECBs::ECBs() {
+ECBs::ECBs() : _size(0) {
 }
 
-ECBs::ECBs(ECBs &src) {
-	insert(begin(), src.begin(), src.end());
+ECBs::ECBs(uint32_t sets) : _counts(sets, 0), _size(0) {
+}
+
+ECBs::ECBs(const ECBs &src) : _counts(src._counts), _size(src._size) {
+}
+
+ECBs::ECBs(const ECBs *src) : _counts(src->_counts), _size(src->_size) {
+}
+
+void
+ECBs::add(uint32_t set) {
+	if (set >= _counts.size()) {
+		_counts.resize(set + 1, 0);
+	}
+	_counts[set]++;
+	_size++;
 }
 
-ECBs::ECBs(ECBs *src) {
-	insert(begin(), src->begin(), src->end());
+void
+ECBs::clear() {
+	fill(_counts.begin(), _counts.end(), 0);
+	_size = 0;
 }
 
+void
+ECBs::merge(const ECBs &other) {
+	if (other._counts.size() > _counts.size()) {
+		_counts.resize(other._counts.size(), 0);
+	}
+	uint32_t *dst = _counts.data();
+	const uint32_t *src = other._counts.data();
+	size_t n = other._counts.size();
+	for (size_t i = 0; i < n; i++) {
+		dst[i] += src[i];
+	}
+	_size += other._size;
+}
+
+void
+ECBs::intersect(const ECBs &other) {
+	size_t n = min(_counts.size(), other._counts.size());
+	uint32_t *dst = _counts.data();
+	const uint32_t *src = other._counts.data();
+	for (size_t i = 0; i < n; i++) {
+		dst[i] = min(dst[i], src[i]);
+	}
+	fill(_counts.begin() + n, _counts.end(), 0);
+	recount();
+}
+
+void
+ECBs::unique() {
+	uint32_t *dst = _counts.data();
+	size_t n = _counts.size();
+	for (size_t i = 0; i < n; i++) {
+		dst[i] = min(dst[i], (uint32_t) 1);
+	}
+	recount();
+}
+
+void
+ECBs::dupesOnly() {
+	uint32_t *dst = _counts.data();
+	size_t n = _counts.size();
+	for (size_t i = 0; i < n; i++) {
+		dst[i] = dst[i] > 1 ? dst[i] : 0;
+	}
+	recount();
+}
 
 uint32_t
-ECBs::dupeCount() {
+ECBs::dupeCount() const {
 	uint32_t rval = 0;
-	ECBs u(*this);
-
-	sort();
-	u.unique();
-	u.sort();
-	ECBs::iterator eit = begin();
-	for (ECBs::iterator uit = u.begin(); uit != u.end(); ++uit) {
-		uint32_t value = *uit;
-		uint32_t count = 0;
-		while (eit != end() && value == *eit) {
-			count++;
-			eit++;
-		}
-		if (count > 1) {
-			rval += count;
-		}
+	const uint32_t *src = _counts.data();
+	size_t n = _counts.size();
+	for (size_t i = 0; i < n; i++) {
+		rval += src[i] > 1 ? src[i] : 0;
 	}
 	return rval;
 }
 
 void
-ECBs::dupesOnly() {
-	ECBs u(*this);
-	ECBs dupes;
-	sort();
-	u.unique();
-	u.sort();
-	ECBs::iterator eit = begin();
-	for (ECBs::iterator uit = u.begin(); uit != u.end(); ++uit) {
-		uint32_t value = *uit;
-		uint32_t count = 0;
-		while (eit != end() && value == *eit) {
-			count++;
-			eit++;
-		}
-		for (int i=0; count > 1 && i < count; i++) {
-			dupes.push_back(value);
-		}
+ECBs::recount() {
+	uint32_t total = 0;
+	const uint32_t *src = _counts.data();
+	size_t n = _counts.size();
+	for (size_t i = 0; i < n; i++) {
+		total += src[i];
 	}
-	clear();
-	insert(begin(), dupes.begin(), dupes.end());
+	_size = total;
 }
@@ -4,23 +4,77 @@
 #include<sstream>
 #include<iostream>
 #include<cstdint>
-#include<list>
+#include<vector>
 #include<stdint.h>
 using namespace std;
 
 /**
- * ECBs are a (multi) list of cache set indexes
+ * ECBs are a (multi) set of cache set indexes
+ *
+ * They are stored as the number of times each cache set index is
+ * present, in a vector sized to the number of cache sets. The set
+ * operations are simple loops over the counts.
  */
-class ECBs : public list<uint32_t> {
+class ECBs {
 public:
 	friend std::ostream &operator<<(std::ostream&, const ECBs&);
 	ECBs ();
-	ECBs (ECBs &src);
-	ECBs (ECBs *src);
+	/**
+	 * @param[in] sets the number of cache sets, grown as needed
+	 */
+	ECBs (uint32_t sets);
+	ECBs (const ECBs &src);
+	ECBs (const ECBs *src);
+	/**
+	 * Adds one occurence of a cache set index
+	 */
+	void add(uint32_t set);
+	/**
+	 * Returns the number of occurences of a cache set index
+	 */
+	uint32_t count(uint32_t set) const {
+		return set < _counts.size() ? _counts[set] : 0;
+	}
+	/**
+	 * Returns the number of ECBs, counting every occurence
+	 */
+	uint32_t size() const { return _size; }
+	bool empty() const { return _size == 0; }
+	void clear();
+	/**
+	 * Adds the occurences of other to these ECBs
+	 */
+	void merge(const ECBs &other);
+	/**
+	 * Keeps the occurences common to both, the lower of the two
+	 * counts of every index
+	 */
+	void intersect(const ECBs &other);
+	/**
+	 * Keeps a single occurence of every index
+	 */
+	void unique();
+	/**
+	 * Keeps only the indexes that occur more than once
+	 */
 	void dupesOnly();
-	uint32_t dupeCount();
+	/**
+	 * Returns the number of occurences of indexes that occur more
+	 * than once
+	 *
+	 * Examples:
+	 * (1, 2) -- returns 0
+	 * (1, 1) -- returns 2
+	 * (1, 1, 2, 2, 2) -- returns 5
+	 */
+	uint32_t dupeCount() const;
 
 	string str(string prefix="") const;
+private:
+	void recount();
+
+	vector<uint32_t> _counts;
+	uint32_t _size;
 };
 
 #endif /* CFRECBS_H */
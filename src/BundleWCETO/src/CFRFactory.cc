@@ -18,50 +18,70 @@ CFRFactory::~CFRFactory() {
 	}
 	_cfrs.clear();
 	xlog.close();
-	bcfr.close();
 	prdc.close();
-	preenlog.close();
 }
 
-#define dout dbg.buf << dbg.start
+void
+CFRFactory::reset(string log_pfx) {
+	delete cfrg;
+	map<ListDigraph::Node, CFR*>::iterator mit;
+	for (mit = _cfrs.begin(); mit != _cfrs.end(); ++mit) {
+		/* The next CFRs may be allocated where these were */
+		const vector<ListDigraph::Node> &nodes = mit->second->nodes();
+		for (size_t i = 0; i < nodes.size(); i++) {
+			_members.set(nodes[i], NULL, -1);
+		}
+		delete mit->second;
+	}
+	_cfrs.clear();
+	_cfg_to_cfr.clear();
+	cfrg = new CFRG(_cfg, log_pfx);
+	xlog.open(log_pfx + "asstx.log", "cfrfactory", TRACE_DEBUG);
+	prdc.open(log_pfx + "produce.log", "cfrfactory", TRACE_INFO);
+}
+
+/* The phases of produce(), written to produce.log */
+#define dout DBG_OUT(dbg, TRACE_INFO)
 
 void
 CFRFactory::produce_prep() {
 	dout << "Clearing initial state" << endl;
 	visitClear();
-	for (ListDigraph::NodeIt nit(_cfg); nit != INVALID; ++nit) {
-		ListDigraph::Node node = nit;
-		_cfr_addr[node] = INVALID;
+	for (size_t i = 0; i < _labeled.size(); i++) {
+		_cfr_addr[_labeled[i]] = INVALID;
 	}
+	_labeled.clear();
 }
 
 void
 CFRFactory::produce_assign() {
 	dbg.inc("CFRF-assn: ");
 	dout << "begin" << endl;
-	ListDigraph::Node initial = _cfg.getInitial();
+	ListDigraph::Node initial = _entry;
 	dbg.flush(prdc);
 	
 	NodeList next_cfrs;
 	next_cfrs.push_back(initial);
+	/* Every CFR starts from the level's cache, reuse one copy */
+	Cache copy(_cache);
 	dbg.inc("◌ ");
 	do {
 		ListDigraph::Node cur = next_cfrs.front(); next_cfrs.pop_front();
-		string nstr = _cfg.stringNode(cur);
-		dout << nstr << " begin" << endl;
+		dout << _cfg.stringNode(cur) << " begin" << endl;
 		if (visited(cur)) {
-			dout << nstr << " already begins a CFR, done." << endl;
+			dout << _cfg.stringNode(cur) << " already begins a CFR, done."
+			     << endl;
 			dbg.flush(prdc);
 			continue;
 		}
 		visit(cur);
-		Cache copy(_cache);
+		copy.reset(_cache);
 		dbg.flush(prdc);
 		NodeList xflicts = labelCFR(cur, copy);
 		for (ListDigraph::Node &node : xflicts) {
 			next_cfrs.push_back(node);
 		}
-		dout << nstr << " end" << endl;
+		dout << _cfg.stringNode(cur) << " end" << endl;
 	} while(!next_cfrs.empty());
 	dbg.dec();
 	dout << "end" << endl;
@@ -69,8 +89,29 @@ CFRFactory::produce_assign() {
 
 	#ifdef PARANOIA
 	bool puke=false;
-	for (ListDigraph::NodeIt nit(_cfg); nit != INVALID; ++nit) {
-		ListDigraph::Node node = nit;
+	NodeList nodes;
+	if (_cfg.isShared()) {
+		/* The function of the entry, without the others */
+		NodeList nexts;
+		nexts.push_back(_entry);
+		walkClear();
+		while (!nexts.empty()) {
+			ListDigraph::Node cur = nexts.front(); nexts.pop_front();
+			if (!walk(cur)) {
+				continue;
+			}
+			nodes.push_back(cur);
+			ListDigraph::OutArcIt a(_cfg, cur);
+			for (; a != INVALID; ++a) {
+				nexts.push_back(_cfg.runningNode(a));
+			}
+		}
+	} else {
+		for (ListDigraph::NodeIt nit(_cfg); nit != INVALID; ++nit) {
+			nodes.push_back(nit);
+		}
+	}
+	for (ListDigraph::Node &node : nodes) {
 		if (_cfr_addr[node] == INVALID) {
 			puke = true;
 			dout << _cfg.stringNode(node) << " no CFR" << endl;
@@ -86,7 +127,7 @@ void
 CFRFactory::produce_create() {
 	dbg.inc("CFRF-create: ");
 	dout << "begin" << endl;
-	ListDigraph::Node initial = _cfg.getInitial();
+	ListDigraph::Node initial = _entry;
 	dbg.flush(prdc);
 	visitClear();
 	
@@ -95,22 +136,21 @@ CFRFactory::produce_create() {
 	dbg.inc("⬍ ");
 	do {
 		ListDigraph::Node cur = next_cfrs.front(); next_cfrs.pop_front();
-		string nstr = _cfg.stringNode(cur);
-		dout << nstr << " begin" << endl;
+		dout << _cfg.stringNode(cur) << " begin" << endl;
 		dbg.flush(prdc);
 		if (visited(cur)) {
-			dout << nstr << " already visited, done." << endl;
+			dout << _cfg.stringNode(cur) << " already visited, done."
+			     << endl;
 			dbg.flush(prdc);
 			continue;
 		}
 		visit(cur);
 		NodeList nexts = expandCFR(cur);
 		for (ListDigraph::Node &node : nexts) {
-			string nstr = _cfg.stringNode(node);
-			dout << "+ " << nstr << endl;
+			dout << "+ " << _cfg.stringNode(node) << endl;
 			next_cfrs.push_back(node);
 		}
-		dout << nstr << " end" << endl;
+		dout << _cfg.stringNode(cur) << " end" << endl;
 	} while(!next_cfrs.empty());
 	dbg.dec();
 
@@ -122,7 +162,7 @@ void
 CFRFactory::produce_link() {
 	dbg.inc("CFRF-link: ");
 	dout << "begin" << endl;
-	ListDigraph::Node initial = _cfg.getInitial();
+	ListDigraph::Node initial = _entry;
 	dbg.flush(prdc);
 	visitClear();
 	
@@ -131,10 +171,10 @@ CFRFactory::produce_link() {
 	dbg.inc("❊ ");
 	do {
 		ListDigraph::Node cur = next_cfrs.front(); next_cfrs.pop_front();
-		string nstr = _cfg.stringNode(cur);
 		dbg.flush(prdc);
 		if (visited(cur)) {
-			dout << nstr << " already visited, done." << endl;
+			dout << _cfg.stringNode(cur) << " already visited, done."
+			     << endl;
 			dbg.flush(prdc);
 			continue;
 		}
@@ -190,12 +230,11 @@ CFRFactory::produce() {
 /**
  * Labels instructions starting with the given entry point.
  */
-#define dout dbg.buf << dbg.start
+#define dout DBG_OUT(dbg, TRACE_DEBUG)
 NodeList
 CFRFactory::labelCFR(ListDigraph::Node entry, Cache &cache) {
 	dbg.inc("labelCFR ✇: ");
-	string estr = _cfg.stringNode(entry);
-	dout << estr << " begin" << endl;
+	dout << _cfg.stringNode(entry) << " begin" << endl;
 	dbg.inc("✇: ");
 
 	/*
@@ -205,7 +244,7 @@ CFRFactory::labelCFR(ListDigraph::Node entry, Cache &cache) {
 	 */
 	ListDigraph::Node marker = INVALID; /* Case 1 */
 	if (_cfr_addr[entry] != INVALID) {  /* Case 2 */
-		dout << estr << " breaks CFR "
+		dout << _cfg.stringNode(entry) << " breaks CFR "
 		     << _cfg.stringNode(_cfr_addr[entry]) << endl;
 		marker = _cfr_addr[entry];
 	}
@@ -213,108 +252,110 @@ CFRFactory::labelCFR(ListDigraph::Node entry, Cache &cache) {
 	/* This CFR may also be a loop head */
 	bool loopt = false;
 	if (_cfg.isHead(entry)) {
-		dout << estr << " is a loop head" << endl;
+		dout << _cfg.stringNode(entry) << " is a loop head" << endl;
 		loopt = true;
 	}
 
 	NodeList xflicts, nexts;
-	ListDigraph::NodeMap<bool> v(_cfg);
+	walkClear();
 	nexts.push_front(entry);
 	do {
 		ListDigraph::Node cur = nexts.front(); nexts.pop_front();
-		string cstr = _cfg.stringNode(cur);
-		if (v[cur]) {
-			dout << cstr << " already visited, skipping." << endl;
+		if (!walk(cur)) {
+			dout << _cfg.stringNode(cur)
+			     << " already visited, skipping." << endl;
 			continue;
 		}
-		v[cur] = true;
 		if (loopt && !_cfg.inLoop(entry, cur)) {
-			dout << cstr << " out of loop, added to xflicts" << endl;
+			dout << _cfg.stringNode(cur)
+			     << " out of loop, added to xflicts" << endl;
 			xflicts.push_back(cur);
 			continue;
 		}
 		if (_cfg.isHead(cur) && cur != entry) {
-			dout << cstr << " is a loop, added to xflicts" << endl;
+			dout << _cfg.stringNode(cur)
+			     << " is a loop, added to xflicts" << endl;
 			xflicts.push_back(cur);
 			continue;
 		}
 		if (_cfr_addr[cur] != marker) {
 			/* Not in our CFR scope */
-			string cfrstr = _cfg.stringNode(_cfr_addr[cur]);
-			dout << cstr << " in different CFR " << cfrstr << endl;
-			dout << cstr << " added to xflicts" << endl;
+			dout << _cfg.stringNode(cur) << " in different CFR "
+			     << _cfg.stringNode(_cfr_addr[cur]) << endl;
+			dout << _cfg.stringNode(cur) << " added to xflicts" << endl;
 			xflicts.push_back(cur);
 			continue;
 		}
 		if (conflicts(cur, cache)) {
-			dout << cstr << " conflicts, adding to xflicts." << endl;
+			dout << _cfg.stringNode(cur)
+			     << " conflicts, adding to xflicts." << endl;
 			xflicts.push_back(cur);
 			continue;
 		}
 		cache.insert(_cfg.getAddr(cur));
-		dout << "+ " << cstr << endl;
+		dout << "+ " << _cfg.stringNode(cur) << endl;
+		if (marker == INVALID) {
+			_labeled.push_back(cur);
+		}
 		_cfr_addr[cur] = entry;
+		/* The callee may evict anything, a return begins a CFR */
+		bool call = _cfg.getCallee(cur) != INVALID;
 		for (ListDigraph::OutArcIt a(_cfg, cur); a != INVALID; ++a) {
 			ListDigraph::Node kid = _cfg.runningNode(a);
+			if (call) {
+				dout << _cfg.stringNode(kid)
+				     << " returned to, added to xflicts" << endl;
+				xflicts.push_back(kid);
+				continue;
+			}
 			nexts.push_back(kid);
 		}
 	} while(!nexts.empty());
 
 	dbg.dec();
-	dout << estr << " end" << endl;
+	dout << _cfg.stringNode(entry) << " end" << endl;
 	dbg.dec(); dbg.flush(xlog);
 
 	return xflicts;
 }
 #undef dout
 
-#define dout dbg.buf << dbg.start
+#define dout DBG_OUT(dbg, TRACE_DEBUG)
 NodeList
 CFRFactory::expandCFR(ListDigraph::Node entry) {
 	dbg.inc("expandCFR ⬍: ");
-	string estr = _cfg.stringNode(entry);
-	dout << estr << " begin" << endl;
+	dout << _cfg.stringNode(entry) << " begin" << endl;
 	dbg.inc("⬍: ");
 
 	CFR *cfr = addCFR(entry);
-	ListDigraph::Node cfr_entry = cfr->getInitial();
 
 	NodeList next_cfr, nexts;
-	ListDigraph::NodeMap<bool> v(_cfg);
+	walkClear();
 	nexts.push_front(entry);
 	do {
 		ListDigraph::Node cur = nexts.front(); nexts.pop_front();
-		ListDigraph::Node cfr_node =
-		    cfr->find(_cfg.getAddr(cur), _cfg.getFunction(cur));
-		string cstr = _cfg.stringNode(cur);
-		if (v[cur]) {
-			dout << cstr << " already visited, skipping." << endl;
+		if (!walk(cur)) {
+			dout << _cfg.stringNode(cur) << " already visited, skipping."
+			     << endl;
 			continue;
 		}
-		v[cur] = true;
 		for (ListDigraph::OutArcIt a(_cfg, cur); a != INVALID; ++a) {
 			ListDigraph::Node kid = _cfg.runningNode(a);
-			string ks = _cfg.stringNode(kid);
 			if (_cfr_addr[kid] != entry) {
-				dout << ks << " in next CFR." << endl;
+				dout << _cfg.stringNode(kid) << " in next CFR." << endl;
 				next_cfr.push_back(kid);
 				continue;
 			}
-			ListDigraph::Node cfr_kid;
-			if (kid == entry) {
-				/* Finishing a loop */
-				cfr_kid = cfr_entry;
-			} else {
-				cfr_kid = cfr->fromCFG(kid);
-				if (cfr_kid == INVALID) {
-					cfr_kid = cfr->addNode(kid);
-				}
+			/* The arc is part of the CFR once both ends are */
+			if (!cfr->valid(kid)) {
+				cfr->addNode(kid);
 			}
-			dout << cstr << " → " << ks << endl;
-			cfr->addArc(cfr_node, cfr_kid);
+			dout << _cfg.stringNode(cur) << " → " << _cfg.stringNode(kid)
+			     << endl;
 			nexts.push_back(kid);
 		}
 	} while(!nexts.empty());
+	addCalls(cfr);
 
 	dbg.dec();
 	dout << *cfr << " end" << endl;
@@ -325,7 +366,8 @@ CFRFactory::expandCFR(ListDigraph::Node entry) {
 
 void
 CFRFactory::ensureArc(CFR* source, CFR* target) {
-	#define dout dbg.buf << dbg.start
+	/* Part of produce_link(), written to produce.log */
+	#define dout DBG_OUT(dbg, TRACE_INFO)
 	dbg.inc("⌒: ");
 	ListDigraph::Node cfrgs, cfrgt;
 	cfrgs = cfrg->findNode(source);
@@ -347,17 +389,33 @@ CFRFactory::ensureArc(CFR* source, CFR* target) {
 
 void
 CFRFactory::visit(ListDigraph::Node node, bool yes) {
-	_visited[node] = yes;
+	_visited[node] = yes ? _visit : 0;
 }
 bool
 CFRFactory::visited(ListDigraph::Node node) {
-	return _visited[node];
+	return _visited[node] == _visit;
 }
 void
 CFRFactory::visitClear() {
-	for (ListDigraph::NodeIt nit(_cfg); nit != INVALID; ++nit) {
-		ListDigraph::Node node = nit;
-		visit(node, false);
+	if (++_visit == 0) {
+		/* The marks wrapped, older marks could match again */
+		_visited.fill(0);
+		_visit = 1;
+	}
+}
+bool
+CFRFactory::walk(ListDigraph::Node node) {
+	if (_walked[node] == _walk) {
+		return false;
+	}
+	_walked[node] = _walk;
+	return true;
+}
+void
+CFRFactory::walkClear() {
+	if (++_walk == 0) {
+		_walked.fill(0);
+		_walk = 1;
 	}
 }
 
@@ -367,7 +425,7 @@ CFRFactory::addCFR(ListDigraph::Node cfg_node) {
 	if (new_cfr != NULL) {
 		return new_cfr;
 	}
-	new_cfr = new CFR(_cfg);
+	new_cfr = new CFR(_cfg, _members);
 	ListDigraph::Node initial = new_cfr->addNode(cfg_node);
 	new_cfr->setInitial(initial);
 	new_cfr->setCache(&_cache);
@@ -396,6 +454,30 @@ CFRFactory::addCFR(ListDigraph::Node cfg_node) {
 	return new_cfr;
 }
 
+void
+CFRFactory::addCalls(CFR *cfr) {
+	if (!_cfg.isShared()) {
+		return;
+	}
+	const vector<ListDigraph::Node> &nodes = cfr->nodes();
+	for (size_t i = 0; i < nodes.size(); i++) {
+		ListDigraph::Node callee = _cfg.getCallee(nodes[i]);
+		if (callee == INVALID) {
+			continue;
+		}
+		string what = "No summary for the function called by "
+			+ _cfg.stringNode(nodes[i]);
+		if (_summaries == NULL) {
+			throw runtime_error(what);
+		}
+		CallSummaries::const_iterator it = _summaries->find(callee);
+		if (it == _summaries->end()) {
+			throw runtime_error(what);
+		}
+		cfr->addCall(it->second.wceto, it->second.ecbs);
+	}
+}
+
 CFR*
 CFRFactory::getCFR(ListDigraph::Node cfg_node) {
 	NodeCFRMap::iterator cfrit = _cfrs.find(cfg_node);
@@ -7,8 +7,6 @@
 #include "CFRG.h"
 #include "DBG.h"
 #include "CFGDFS.h"
-#include "CFGTopSort.h"
-#include "PQueue.h"
 #include <map>
 using namespace std;
 
@@ -23,18 +21,61 @@ public:
 	void replace(ListDigraph::Node, CFR*);
 };
 
+/**
+ * A shared function as seen by its callers, see SummaryFactory
+ */
+struct CallSummary {
+	/* WCETO of one thread through the function */
+	uint32_t wceto;
+	/* ECBs of every CFR of the function */
+	ECBs ecbs;
+};
+
+/* Entry of a shared function -> its summary */
+typedef map<ListDigraph::Node, CallSummary> CallSummaries;
+
 class CFRFactory {
 public:
-	CFRFactory(CFG &cfg, Cache &cache) : _cfg(cfg), _cache(cache),
-		_initial(cfg), _visited(cfg) {
-		cfrg = new CFRG(cfg);
-		xlog.open("asstx.log");
-		bcfr.open("buildcfr.log");
-		prdc.open("produce.log");
-		preenlog.open("preen.log");
+	/**
+	 * @param[in] log_pfx prefix of the log file names, analyses
+	 *   running at the same time need distinct prefixes
+	 */
+	CFRFactory(const CFG &cfg, Cache &cache, string log_pfx="") : _cfg(cfg),
+		_cache(cache), _entry(cfg.getInitial()), _summaries(NULL),
+		_visited(cfg, 0), _visit(1), _walked(cfg, 0), _walk(1),
+		_cfr_addr(cfg, INVALID), _members(cfg), dbg("cfrfactory") {
+		cfrg = NULL;
+		reset(log_pfx);
 	}
 	~CFRFactory();
+	/**
+	 * Drops the CFRs and the CFRG of the last produce(), the next
+	 * produce() starts over with its log files under log_pfx
+	 *
+	 * The per instruction state is kept and only the instructions
+	 * the last produce() reached are cleared, so one factory can
+	 * divide the functions of a shared CFG (see CFG::isShared) one
+	 * after the other in time proportional to each function.
+	 */
+	void reset(string log_pfx="");
 	
+	/**
+	 * Sets the instruction the CFRs start from, the initial
+	 * instruction of the CFG by default
+	 *
+	 * With shared functions (see CFG::isShared) only the function
+	 * of the entry is divided into CFRs.
+	 */
+	void setEntry(ListDigraph::Node entry) { _entry = entry; }
+	/**
+	 * Sets the summaries of the functions called by a CFG with
+	 * shared functions, each call adds the summary of its callee to
+	 * the CFR making it (see CFR::addCall)
+	 */
+	void setSummaries(const CallSummaries *summaries) {
+		_summaries = summaries;
+	}
+
 	/* Gets the CFR of an instruction */
 	CFR* getCFR(ListDigraph::Node cfg_node);
 	NodeCFRMap produce();
@@ -43,19 +84,32 @@ public:
 	CFRG *getCFRG() { return cfrg; }
 	bool debugOn = false;
 private:
-	CFG &_cfg;
+	const CFG &_cfg;
 	Cache &_cache;
 	CFRG *cfrg;
+	ListDigraph::Node _entry;
+	const CallSummaries *_summaries;
 	
-	ListDigraph::NodeMap<bool> _initial;
-	ListDigraph::NodeMap<bool> _visited;
+	/*
+	 * The instructions visited by a phase of produce() are those
+	 * marked with _visit, the labelCFR() and expandCFR() walks mark
+	 * theirs with _walk. Clearing either only changes the mark.
+	 */
+	CFGMap<uint32_t> _visited;
+	uint32_t _visit;
+	CFGMap<uint32_t> _walked;
+	uint32_t _walk;
 
 	/*
 	 * Maps from the CFG node -> CFG node that begins the CFR the
 	 * node is a part of
 	 */ 
-	NodeNodeMap _cfr_addr;
+	CFGMap<ListDigraph::Node> _cfr_addr;
+	/* The instructions given a CFR in _cfr_addr */
+	vector<ListDigraph::Node> _labeled;
 	
+	/* Any instruction in the CFG -> its CFR, shared by the CFRs */
+	CFRMembers _members;
 	/* Initial instruction in the CFG -> CFR */
 	NodeCFRMap _cfrs;
 	/* Any instruction in CFG -> CFR */
@@ -70,15 +124,20 @@ private:
 	void visit(ListDigraph::Node node, bool yes=true);
 	bool visited(ListDigraph::Node node);
 	void visitClear();
+	/* Marks the instruction in the current walk, false if it was */
+	bool walk(ListDigraph::Node node);
+	void walkClear();
 
 	/* Adds a CFR starting at the given node */
 	CFR* addCFR(ListDigraph::Node node);
+	/* Adds the summaries of the calls made from the CFR */
+	void addCalls(CFR *cfr);
 
 	stringstream _debug;
 	string _path, _indent;
 
 	DBG dbg;
-	ofstream xlog, bcfr, prdc, preenlog;
+	TraceFile xlog, prdc;
 
 	void produce_prep();
 	void produce_assign();
@@ -1,32 +1,21 @@
 #include "CFRG.h"
 #include "CFRGDFS.h"
 
+#include <algorithm>
+
 static string
 cfr_desc(CFRG &cfrg, ListDigraph::Node cfr_node) {
 	if (cfr_node == INVALID) {
 		return "INVALID";
 	}
-	CFG *cfg = cfrg.getCFG();
+	const CFG *cfg = cfrg.getCFG();
 	CFR *cfr = cfrg.findCFR(cfr_node);
 	ListDigraph::Node cfr_initial = cfr->getInitial();
 	ListDigraph::Node cfg_initial = cfr->toCFG(cfr_initial);
 	
 	return cfg->stringNode(cfg_initial);
 }
-static string
-debug_queue(pqueue_t &pqueue, CFRG &cfrg, ListDigraph::NodeMap<int> &dists) {
-	pqueue_t::iterator it;
-	stringstream ss;
-	ss << "PRIORITY QUEUE SIZE: " << pqueue.size() << endl;
-	for (it = pqueue.begin(); it != pqueue.end(); ++it) {
-		ListDigraph::Node node = *it;
-		ss << "Dist: " << dists[node]
-		     << " -- " << cfr_desc(cfrg, node) << endl;
-	}
-	return ss.str();
-}
-
-#define dout dbg.buf << dbg.start
+#define dout DBG_OUT(dbg, TRACE_INFO)
 ListDigraph::Node
 CFRG::addNode(CFR *cfr) {
 	map<CFR*, ListDigraph::Node>::iterator mit =
@@ -411,94 +400,6 @@ CFRG::doLoopOffsets(ListDigraph::NodeMap<int> &loopOffset) {
 	}
 }
 
-/**
- * The pqueue_t may contain more than one node with the same distance (which
- * determines its key value). This method returns an iterator to the exact node
- * passed in.
- *
- * @param[in] pqueue the queue being searched
- * @param[in] target the node being searched for
- *
- * @return an iterator pointing to the target, or an iterator that is equal to
- *  pqueue.end() 
- */
-static pqueue_t::iterator 
-pqfind(pqueue_t &pqueue, ListDigraph::Node &target) {
-	pqueue_t::iterator pit;
-
-	pit = pqueue.find(target);
-	while (pit != pqueue.end() && *pit != target) {
-		++pit;
-	}
-
-	return pit;
-}
-
-/**
- * Finds the longest path from the source to the target
- *
- * The result is stored in distances, a mapping from node to it's
- * distance from the source.
- */
-void
-CFRG::dijk(ListDigraph::Node source, ListDigraph::Node target,
-	   ListDigraph::NodeMap<int> &distances,
-	   node_map_t &prev) {
-	pqueue_t pqueue((NodeCompLT(distances)));
-	ListDigraph::Node cur;
-	prev.clear();
-
-	ListDigraph::NodeIt nit(*this);
-	for ( ; nit != INVALID; ++nit) {
-		cur = nit;
-		distances[cur] = INT_MAX;
-		pqueue.insert(cur);
-	}
-
-	pqueue_t::iterator sit = pqfind(pqueue, source);
-	pqueue.erase(sit);
-	distances[source] = 0;
-	pqueue.insert(source);
-	
-	while (!pqueue.empty()) {
-		pqueue_t::iterator it = pqueue.begin();
-		ListDigraph::Node node = *it;
-		pqueue.erase(it);
-
-		if (target == node) {
-			/* Found the target, search is complete */
-			return;
-		}
-
-		for (ListDigraph::OutArcIt ait(*this, node); ait != INVALID;
-		     ++ait) {
-			ListDigraph::Node tgt = ListDigraph::target(ait);
-			it = pqfind(pqueue, tgt);
-			if (it == pqueue.end()) {
-				/* This node has been handled */
-				continue; 
-			}
-			int arc_cost = -1; /* Constant */
-
-			bool insert = false;
-			int alt = arc_cost + distances[node];
-			if (distances[tgt] == INT_MAX) {
-				distances[tgt] = alt;
-				insert = true;
-			}
-			if (distances[tgt] > alt) {
-				distances[tgt] = alt;
-				insert = true;
-			}
-			if (insert) {
-				pqueue.erase(it);
-				pqueue.insert(tgt);
-				prev[tgt] = node;
-			}
-		}
-	}
-}
-
 /**
  * CFR must begin with the loop head instruction
  */
@@ -510,54 +411,27 @@ getCFGLoopHead(CFR *cfr) {
 	return cfg_head;
 }
 
-class OrderData {
-public:
-	OrderData(ListDigraph::NodeMap<int> &d) :
-		distances(d), pqueue((NodeCompGR(d))) {
-	}
-	int finish=0;
-	ListDigraph::NodeMap<int> &distances;
-	pqueue_gr_t pqueue;
-};
-
-static bool
-order_dfs_fin(CFRG &cfrg, CFR *cfr, void *userdata) {
-	OrderData *data = (OrderData *) userdata;
-	ListDigraph::Node cfrg_node = cfrg.findNode(cfr);
-	data->distances[cfrg_node] = data->finish;
-	data->finish += 1;
-	data->pqueue.insert(cfrg_node);
-
-	return true;
-}
-
-
 void CFRG::_order(ListDigraph::Node source,
 		      ListDigraph::NodeMap<int> &distances,
 		      node_map_t &prev) {
 	dbg.inc("→ _ordern: ");
 	dout << "Source: " << cfr_desc(*this, source) << endl;
-	OrderData data(distances);
-	CFRGDFS dfs(*this);
-	dfs.setUserData(&data);
-	dfs.setFin(order_dfs_fin);
-	dfs.recSearch(findCFR(source));
+	LongestPath lp(*this);
+	lp.run(source);
+	const vector<ListDigraph::Node> &result = lp.order();
+	vector<ListDigraph::Node>::const_iterator it;
 
-	pqueue_t result(distances);
-	pqueue_gr_t::iterator git;
 	dout << "Initial order: " << endl;
 	dbg.inc("→ _ordern: ");
 	int c=0;
-	for (git = data.pqueue.begin(); git != data.pqueue.end(); ++git, ++c) {
-		ListDigraph::Node cfrg_node = *git;
+	for (it = result.begin(); it != result.end(); ++it, ++c) {
+		ListDigraph::Node cfrg_node = *it;
+		/* The DFS finish time */
 		dout << cfr_desc(*this, cfrg_node) << " dist: "
-		     << distances[cfrg_node] << endl;
-		distances[cfrg_node] = c;
-		result.insert(cfrg_node);
+		     << result.size() - 1 - c << endl;
 	}
 	dbg.dec();
 
-	pqueue_t::iterator it;
 	dout << "Topological order: " << endl;
 	dbg.inc("→ _ordern: ");
 	for (it = result.begin(); it != result.end(); ++it) {
@@ -569,6 +443,23 @@ void CFRG::_order(ListDigraph::Node source,
 	dbg.dec();
 	dbg.flush(ord);
 
+	/*
+	 * The members of each loop (those whose innermost head it is)
+	 * that follow the head in topological order, indexed by the
+	 * head's id
+	 */
+	vector<vector<ListDigraph::Node> > members(maxNodeId() + 1);
+	for (c = 0; c < (int) result.size(); c++) {
+		ListDigraph::Node head = getHeadNode(result[c]);
+		if (head == INVALID) {
+			continue;
+		}
+		int pos = lp.position(head);
+		if (pos >= 0 && pos < c) {
+			members[id(head)].push_back(result[c]);
+		}
+	}
+
 	dout << "Adjustment Pass: " << endl;
 	dbg.inc("→ _ordern: ");
 	for (it = result.begin(); it != result.end(); ++it) {
@@ -581,7 +472,7 @@ void CFRG::_order(ListDigraph::Node source,
 			continue;
 		}
 		/* Only top-most heads */
-		topoAdj(result, cfrg_node, distances);
+		topoAdj(members, cfrg_node, distances);
 		dout << cfr_desc(*this, cfrg_node) << " adjustment: "
 		     << distances[cfrg_node] << endl;
 	}
@@ -604,13 +495,12 @@ void CFRG::_order(ListDigraph::Node source,
 	}
 	dbg.dec();
 
-	/* Sort by distance */
-	ListDigraph::NodeMap<int> sortd(*this);
-	pqueue_t sorting(sortd);
-	for (it = result.begin(); it != result.end(); ++it) {
-		sortd[*it] = distances[*it];
-		sorting.insert(*it);
-	}
+	/* Sort by distance, ties keep their topological order */
+	vector<ListDigraph::Node> sorting(result);
+	stable_sort(sorting.begin(), sorting.end(),
+		    [&distances](ListDigraph::Node a, ListDigraph::Node b) {
+			    return distances[a] < distances[b];
+		    });
 
 	dout << "Uniqueness Pass: " << endl;
 	dbg.inc("→ _ordern: ");
@@ -626,7 +516,7 @@ void CFRG::_order(ListDigraph::Node source,
 		if (isHead(cfrg_node)) {
 			uadj += 1;
 		}
-		dbg.buf << distances[cfrg_node] << endl;
+		DBG_BUF(dbg, TRACE_INFO) << distances[cfrg_node] << endl;
 	}
 	dbg.dec();
 
@@ -666,22 +556,16 @@ CFRG::topoMax(ListDigraph::Node cfrg_node, ListDigraph::NodeMap<int> &dist) {
  * cfrg_node - the CFRG loop head
  */
 void
-CFRG::topoAdj(pqueue_t &pq, ListDigraph::Node cfrg_node,
-	      ListDigraph::NodeMap<int> &dist) {
-	pqueue_t::iterator it = pq.begin();
-	while (*it != cfrg_node) {
-		it++;
-	}
-	/* it now at cfrg_node */
+CFRG::topoAdj(vector<vector<ListDigraph::Node> > &members,
+	      ListDigraph::Node cfrg_node, ListDigraph::NodeMap<int> &dist) {
+	vector<ListDigraph::Node> &loop = members[id(cfrg_node)];
+	vector<ListDigraph::Node>::iterator it;
 	int weight = 1;
-	while (++it != pq.end()) {
+	for (it = loop.begin(); it != loop.end(); ++it) {
 		ListDigraph::Node next = *it;
-		if (cfrg_node != getHeadNode(next)) {
-			continue;
-		}
 		/* next is in *a* loop below cfrg_node */
 		if (isHead(next)) {
-			topoAdj(pq, next, dist);
+			topoAdj(members, next, dist);
 		}
 		/* 
 		 * next's innermost head is cfrg_node, it's time to
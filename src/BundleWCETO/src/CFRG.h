@@ -10,23 +10,24 @@
 #include "BundleTypes.h"
 #include "CFG.h"
 #include "CFR.h"
-#include "PQueue.h"
+#include "LongestPath.h"
 using namespace lemon;
 
 typedef list<CFR*> CFRList;
 class CFRG : public ListDigraph {
 public:
-	CFRG(CFG &cfg) : _cfg(cfg), _gen(*this) {
-		ord.open("order.log");
-		ilo.open("ilo.log");
-		sil.open("sil.log");
+	CFRG(const CFG &cfg, string log_pfx="") : _cfg(cfg), _gen(*this),
+		_log_pfx(log_pfx), dbg("cfrg") {
+		ord.open(log_pfx + "order.log", "cfrg", TRACE_INFO);
 	}
 	~CFRG() {
 		ord.close();
-		sil.close();
-		ilo.close();
 	}
-	CFG * getCFG() {
+	/* The prefix of the log file names of this analysis */
+	const string& getLogPrefix() const {
+		return _log_pfx;
+	}
+	const CFG * getCFG() {
 		return &_cfg;
 	}
 	
@@ -177,10 +178,6 @@ public:
 
 	/* Below here could be factored, it's about ordering and generations */
 	void order();
-	void dijk(ListDigraph::Node source,
-		  ListDigraph::Node target,
-		  ListDigraph::NodeMap<int> &distances,
-		  node_map_t &prev);
 	void _order(ListDigraph::Node source,
 		    ListDigraph::NodeMap<int> &distances,
 		    node_map_t &prev);
@@ -188,7 +185,7 @@ public:
 	/* Debugging function */
 	void dupeCheck();
 private:
-	CFG &_cfg;
+	const CFG &_cfg;
 	CFR *_initial = NULL;
 	CFR *_terminal = NULL;
 	/* Stores the CFR pointer and the CFRG node with it */
@@ -199,7 +196,8 @@ private:
 
 	void doLoopOffsets(ListDigraph::NodeMap<int> &loopOffset);
 	int topoMax(ListDigraph::Node cfrg_node, ListDigraph::NodeMap<int> &dist);
-	void topoAdj(pqueue_t &pq, ListDigraph::Node cfrg_node,
+	void topoAdj(vector<vector<ListDigraph::Node> > &members,
+		     ListDigraph::Node cfrg_node,
 		     ListDigraph::NodeMap<int> &dist);
 	string _indent = "";
 	stack<string> _indent_stack;
@@ -211,8 +209,9 @@ private:
 		_indent = _indent_stack.top();
 		_indent_stack.pop();
 	}
+	string _log_pfx;
 	DBG dbg;
-	ofstream ord, ilo, sil;
+	TraceFile ord;
 };
 
 
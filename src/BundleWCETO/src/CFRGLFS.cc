@@ -1,34 +1,199 @@
 #include "CFRGLFS.h"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 void
 CFRGLFS::search(CFR *start, CFR *end) {
-	ListDigraph::NodeMap<bool> visited(_cfrg);
-
-	list<CFR*> q;
-	q.push_front(start);
+	Frontier f;
+	prepare(start, f);
 
-	do {
-		step(q, visited);
-		CFR *next = q.front();
-		if (next == end) {
+	if (_workers > 1) {
+		searchParallel(f, end);
+		return;
+	}
+	while (!f.ready.empty() || refill(f)) {
+		CFR *current = f.ready.front();
+		if (current == end) {
 			return;
 		}
-	} while (!q.empty());
+		f.ready.pop_front();
+		if (visit(current)) {
+			f.progress = true;
+			release(current, f);
+		} else {
+			f.parked.push_back(current);
+		}
+	}
+}
+
+void
+CFRGLFS::searchParallel(Frontier &f, CFR *end) {
+	mutex lock;
+	condition_variable changed;
+	unsigned int running = 0;
+	bool done = false;
+	exception_ptr error;
+
+	auto worker = [&]() {
+		unique_lock<mutex> guard(lock);
+		while (true) {
+			/* Only refill once nothing in flight can release */
+			while (!done && f.ready.empty() && running > 0) {
+				changed.wait(guard);
+			}
+			if (!done && f.ready.empty()) {
+				try {
+					done = !refill(f);
+				} catch (...) {
+					error = current_exception();
+					done = true;
+				}
+			}
+			if (!done && f.ready.front() == end) {
+				done = true;
+			}
+			if (done) {
+				changed.notify_all();
+				return;
+			}
+			CFR *current = f.ready.front();
+			f.ready.pop_front();
+			running++;
+
+			guard.unlock();
+			bool visited = false;
+			try {
+				visited = visit(current);
+			} catch (...) {
+				guard.lock();
+				if (!error) {
+					error = current_exception();
+				}
+				done = true;
+				running--;
+				changed.notify_all();
+				return;
+			}
+			guard.lock();
+
+			running--;
+			if (visited) {
+				f.progress = true;
+				release(current, f);
+			} else {
+				f.parked.push_back(current);
+			}
+			changed.notify_all();
+		}
+	};
 
+	vector<thread> threads;
+	for (unsigned int i=1; i < _workers; i++) {
+		threads.push_back(thread(worker));
+	}
+	worker();
+	for (size_t i=0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+	if (error) {
+		rethrow_exception(error);
+	}
 }
 
 /**
- * Advances the search by one node
+ * Counts the predecessors of every node reachable from the start,
+ * arcs closing a loop are marked and not counted. The start is
+ * released.
  */
 void
-CFRGLFS::step(list<CFR*> &q, ListDigraph::NodeMap<bool> &visited) {
-	CFR *current = q.front();
-	q.pop_front();
+CFRGLFS::prepare(CFR *start, Frontier &f) {
+	f.waiting.assign(_cfrg.maxNodeId() + 1, 0);
+	f.back.assign(_cfrg.maxArcId() + 1, false);
+	f.progress = false;
 
-	ListDigraph::Node cur_node = _cfrg.findNode(current);
-	if (visited[cur_node]) {
-		return;
+	ListDigraph::Node start_node = _cfrg.findNode(start);
+	vector<bool> reached(_cfrg.maxNodeId() + 1, false);
+	list<ListDigraph::Node> stack;
+	stack.push_back(start_node);
+	reached[_cfrg.id(start_node)] = true;
+	while (!stack.empty()) {
+		ListDigraph::Node node = stack.back();
+		stack.pop_back();
+		f.reach.push_back(node);
+		for (ListDigraph::OutArcIt ait(_cfrg, node); ait != INVALID;
+		     ++ait) {
+			ListDigraph::Node succ = _cfrg.target(ait);
+			if (!reached[_cfrg.id(succ)]) {
+				reached[_cfrg.id(succ)] = true;
+				stack.push_back(succ);
+			}
+		}
+	}
+
+	for (size_t i=0; i < f.reach.size(); i++) {
+		ListDigraph::Node node = f.reach[i];
+		bool head = _cfrg.isHead(node);
+		CFR *cfr = _cfrg.findCFR(node);
+		for (ListDigraph::InArcIt iat(_cfrg, node); iat != INVALID;
+		     ++iat) {
+			ListDigraph::Node pred = _cfrg.source(iat);
+			if (!reached[_cfrg.id(pred)]) {
+				continue;
+			}
+			if (head && _cfrg.inDerivedLoop(cfr,
+			    _cfrg.findCFR(pred))) {
+				f.back[_cfrg.id(iat)] = true;
+				continue;
+			}
+			f.waiting[_cfrg.id(node)]++;
+		}
 	}
 
+	f.ready.push_back(start);
+	f.waiting[_cfrg.id(start_node)] = -1;
+}
+
+/**
+ * Called once the ready list is empty and no node is being visited
+ *
+ * @return false when every reachable node has been visited
+ */
+bool
+CFRGLFS::refill(Frontier &f) {
+	if (f.parked.empty()) {
+		/*
+		 * Nodes in a cycle not closed by a loop head are never
+		 * released, let the test decide for them.
+		 */
+		for (size_t i=0; i < f.reach.size(); i++) {
+			int id = _cfrg.id(f.reach[i]);
+			if (f.waiting[id] > 0) {
+				f.waiting[id] = -1;
+				f.parked.push_back(_cfrg.findCFR(f.reach[i]));
+			}
+		}
+		if (f.parked.empty()) {
+			return false;
+		}
+	}
+	if (!f.progress) {
+		throw runtime_error("CFRGLFS::search no CFR passes the test");
+	}
+	f.ready.swap(f.parked);
+	f.progress = false;
+	return true;
+}
+
+/**
+ * Visits a released node
+ *
+ * @return false if the node did not pass the test
+ */
+bool
+CFRGLFS::visit(CFR *current) {
 	bool passes_filter=true;
 	if (_filt_fn && ! _filt_fn(_cfrg, current, _ud)) {
 		/* Didn't pass the filter, all done, do not requeue */
@@ -38,8 +203,7 @@ CFRGLFS::step(list<CFR*> &q, ListDigraph::NodeMap<bool> &visited) {
 	if (passes_filter) {
 		if (_test_fn && ! _test_fn(_cfrg, current, _ud)) {
 			/* Did not pass the test */
-			q.push_back(current);
-			return;
+			return false;
 		}
 	}
 
@@ -48,15 +212,26 @@ CFRGLFS::step(list<CFR*> &q, ListDigraph::NodeMap<bool> &visited) {
 			_work_fn(_cfrg, current, _ud);
 		}
 	}
-	visited[cur_node] = true;
+	return true;
+}
 
+/**
+ * Releases the successors of a visited node which have no
+ * predecessors left to wait for
+ */
+void
+CFRGLFS::release(CFR *current, Frontier &f) {
+	ListDigraph::Node cur_node = _cfrg.findNode(current);
 	ListDigraph::OutArcIt ait(_cfrg, cur_node);
 	for ( ; ait != INVALID; ++ait) {
-		ListDigraph::Node succ = _cfrg.target(ait);
-		if (visited[succ]) {
+		if (f.back[_cfrg.id(ait)]) {
 			continue;
 		}
-		CFR *succ_cfr = _cfrg.findCFR(succ);
-		q.push_back(succ_cfr);
+		ListDigraph::Node succ = _cfrg.target(ait);
+		int &waiting = f.waiting[_cfrg.id(succ)];
+		if (waiting > 0 && --waiting == 0) {
+			waiting = -1;
+			f.ready.push_back(_cfrg.findCFR(succ));
+		}
 	}
 }
@@ -5,6 +5,7 @@
 #include <lemon/list_graph.h>
 
 #include "CFRG.h"
+#include <vector>
 
 /**
  * For lack of a better name, I am calling this a "List First Search"
@@ -12,8 +13,20 @@
  * is ready to be worked before the operation is performed.
  *
  * Visiting a node is divided into two parts, the test and the
- * search. To be searched a node must pass its test. If a node does
- * not pass its test, it is placed at the end of the list.
+ * search. To be searched a node must pass its test.
+ *
+ * Nodes are released to the list exactly once, when every
+ * predecessor reachable from the start has been visited. Arcs from
+ * within a loop back to its head are not waited on. A node that
+ * still does not pass its test is set aside and retried once other
+ * nodes have been visited.
+ *
+ * Nodes rejected by the filter are not worked, but are visited and
+ * release their successors.
+ *
+ * With more than one worker, released nodes are tested and worked
+ * on several threads at once. The callbacks must then be safe to
+ * call concurrently for nodes that do not depend on each other.
  */
 typedef bool (*lfs_filt_t)(CFRG &, CFR *cfr, void *userdata);
 typedef bool (*lfs_test_t)(CFRG &, CFR *cfr, void *userdata);
@@ -24,9 +37,11 @@ public:
 	CFRGLFS(CFRG &cfrg) : _cfrg(cfrg) {
 		_test_fn = NULL;
 		_work_fn = NULL;
+		_workers = 1;
 	}
 	CFRGLFS(CFRG &cfrg, lfs_filt_t lfn=NULL, lfs_test_t tfn=NULL,
 		lfs_work_t wfn=NULL, void *userdata=NULL) : _cfrg(cfrg) {
+		_workers = 1;
 		setFilter(lfn);
 		setTest(tfn);
 		setWork(wfn);
@@ -44,14 +59,48 @@ public:
 	void setData(void *userdata) {
 		_ud = userdata;
 	}
+	/**
+	 * Sets the number of threads visiting nodes, 1 by default
+	 */
+	void setWorkers(unsigned int workers) {
+		_workers = workers == 0 ? 1 : workers;
+	}
+	/**
+	 * Visits every node reachable from start, stopping before end
+	 * is visited.
+	 *
+	 * @throws runtime_error if the remaining nodes never pass
+	 * their test
+	 */
 	void search(CFR *start, CFR *end=NULL);
 private:
+	/*
+	 * The state of a search. Node and arc maps are indexed by
+	 * id so concurrent searches do not register maps with the
+	 * graph.
+	 */
+	struct Frontier {
+		/* Unvisited predecessors, -1 once released */
+		vector<int> waiting;
+		/* Arcs closing a loop, not waited on */
+		vector<bool> back;
+		vector<ListDigraph::Node> reach;
+		/* Released nodes, and those that failed the test */
+		list<CFR*> ready, parked;
+		bool progress;
+	};
+
 	CFRG &_cfrg;
 	lfs_filt_t _filt_fn;
 	lfs_test_t _test_fn;
 	lfs_work_t _work_fn;
 	void *_ud;
+	unsigned int _workers;
 
-	void step(list<CFR*> &q, ListDigraph::NodeMap<bool> &visited);
+	void prepare(CFR *start, Frontier &f);
+	bool refill(Frontier &f);
+	bool visit(CFR *current);
+	void release(CFR *current, Frontier &f);
+	void searchParallel(Frontier &f, CFR *end);
 };
 #endif
@@ -339,10 +339,11 @@ lfs_work(CFRG &cfrg, CFR *cfr, void *userdata) {
 	CFR *head_cfr = data->lud_head_cfr;
 
 	dbg.inc("lfs_work: ");
-	dbg.buf << "headcfr: " << *head_cfr << dbg.cont
+	DBG_BUF(dbg, TRACE_DEBUG) << "headcfr: " << *head_cfr << dbg.cont
 		<< "current cfr: " << *cfr << dbg.cont;
 	if (head_cfr != cfr && cfrg.isHead(cfrg.findNode(cfr))) {
-		dbg.buf << "current cfr belongs to another loop" << endl;
+		DBG_BUF(dbg, TRACE_DEBUG) << "current cfr belongs to another loop"
+			<< endl;
 		/*
 		 * The current CFR is a loop head, so it must have
 		 * its LoopWCETO calculated first.
@@ -358,7 +359,8 @@ lfs_work(CFRG &cfrg, CFR *cfr, void *userdata) {
 		uint32_t wcet = cfr->wceto(i) - cfr->wceto(i - 1);
 		wmap->insert(make_pair(i, wcet));
 	}
-	dbg.buf << *cfr << " individual contribution" << dbg.cont
+	DBG_BUF(dbg, TRACE_DEBUG) << *cfr << " individual contribution"
+		<< dbg.cont
 		<< *wmap << dbg.cont;
 	/* wmap contains the WCETO for the isolated execution of this CFR */
 
@@ -366,7 +368,8 @@ lfs_work(CFRG &cfrg, CFR *cfr, void *userdata) {
 	   only be calculated at the very end. */
 	if (head_cfr == cfr) {
 		(*scratch)[cfr] = wmap;
-		dbg.buf << "handled the first CFR of the loop, returning"
+		DBG_BUF(dbg, TRACE_DEBUG)
+			<< "handled the first CFR of the loop, returning"
 			<< dbg.cont
 			<< "stored " << wmap << " with key " << cfr << dbg.cont
 			<< "returning, current table for " << *cfr << endl
@@ -383,7 +386,7 @@ lfs_work(CFRG &cfrg, CFR *cfr, void *userdata) {
 	}
 	/* Store the result in the scratch table for the search */
 	(*scratch)[cfr] = wmap;
-	dbg.buf <<  "result after addMaxPreds: " << dbg.cont
+	DBG_BUF(dbg, TRACE_DEBUG) <<  "result after addMaxPreds: " << dbg.cont
 		<< *wmap << dbg.cont
 		<< "stored " << wmap << " with key " << cfr << dbg.cont
 		<< "returning, current table for " << *cfr << dbg.cont
@@ -415,7 +418,7 @@ CFRGWCETOFactory::LoopWCETO(CFR *cfr) {
 	 * begins at the head
 	 */
 	cout << prefix << "handling " << *cfr << endl;
-	CFG *cfg = cfr->getCFG();
+	const CFG *cfg = cfr->getCFG();
 	if (!_cfrg.isHead(_cfrg.findNode(cfr))) {
 		cout << prefix << "this call is not the start of the loop"
 		     << " will use the CFG head" << endl;
@@ -50,7 +50,7 @@ typedef struct {
 
 class CFRGWCETOFactory {
 public:
-	CFRGWCETOFactory(CFRG &cfrg) : _cfrg(cfrg) {
+	CFRGWCETOFactory(CFRG &cfrg) : dbg("cfrgwceto"), _cfrg(cfrg) {
 		
 	}
 	~CFRGWCETOFactory();
@@ -39,7 +39,7 @@ DOTFactory::produce() {
 
 	dot << "digraph G {" << endl;
 	ListDigraph::Node root = _cfg.getInitial();
-	ListDigraph::NodeMap<bool> visited(_cfg, false);
+	CFGMap<bool> visited(_cfg, false);
 	stack<ListDigraph::Node> calls, subsq;
 	stack<string> edges;
 
@@ -129,7 +129,7 @@ DOTFactory::produce() {
 void
 DOTFactory::loopDOT(ListDigraph::Node head, ofstream &os,
     stack<ListDigraph::Node> &calls, stack<ListDigraph::Node> &subsq,
-    ListDigraph::NodeMap<bool> &visited) {
+    CFGMap<bool> &visited) {
 	stack<ListDigraph::Node> kids;
 	stack<string> edges;
 
@@ -346,7 +346,7 @@ void
 DOTFactory::labelNodesCFR(CFR *cfr) {
 	ListDigraph::Node initial = cfr->getInitial();
 	string label = cfr->stringAddr(initial);
-	for (ListDigraph::NodeIt nit(*cfr); nit != INVALID; ++nit) {
+	for (CFR::NodeIt nit(*cfr); nit != INVALID; ++nit) {
 		ListDigraph::Node cfr_node = nit;
 		ListDigraph::Node cfg_node = cfr->toCFG(cfr_node);
 		_cfr[cfg_node] = label;
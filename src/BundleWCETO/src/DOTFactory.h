@@ -2,6 +2,7 @@
 #define DOTFACTORY_H
 
 #include "CFG.h"
+#include "CFGMap.h"
 #include "CFR.h"
 #include<fstream>
 using namespace std;
@@ -11,7 +12,7 @@ using namespace std;
  */
 class DOTFactory {
 public:
- 	DOTFactory(CFG &cfg) : _cfg(cfg), _color(cfg), _cfr(cfg) { }
+ 	DOTFactory(const CFG &cfg) : _cfg(cfg), _color(cfg), _cfr(cfg) { }
   
 	/* Gets and sets the path of the DOT file */
 	string getPath() { return _path; }
@@ -35,14 +36,14 @@ public:
 	
 private:
 	Cache *_cache = NULL;
-	ListDigraph::NodeMap<string> _color;
-	ListDigraph::NodeMap<string> _cfr;
+	CFGMap<string> _color;
+	CFGMap<string> _cfr;
 	stringstream _debug;
 	string _path, _indent;
 
 	void loopDOT(ListDigraph::Node head, ofstream &os,
 		     stack<ListDigraph::Node> &calls, stack<ListDigraph::Node> &subsq,
-		     ListDigraph::NodeMap<bool> &visited);	
+		     CFGMap<bool> &visited);	
 	ListDigraph::Node nodeDOT(ofstream &os, ListDigraph::Node node);
 	string edgeDOT(ListDigraph::Node u, ListDigraph::Node port_u,
 		       ListDigraph::Node v, ListDigraph::Node port_v);
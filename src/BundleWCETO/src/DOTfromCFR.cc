@@ -103,7 +103,7 @@ DOTfromCFR::loopDOT(ListDigraph::Node cfr_head, ofstream &os,
 		return;
 	}
 	ListDigraph::Node cfg_head = _cfr.toCFG(cfr_head);
-	CFG *cfg = _cfr.getCFG();
+	const CFG *cfg = _cfr.getCFG();
 	os << "subgraph cluster_loop_" << cfg->stringAddr(cfg_head) << "{" << endl
 	   << "graph [label =\"loop [" << cfg->getIters(cfg_head) << "]\"];"
 	   << endl;
@@ -194,7 +194,7 @@ DOTfromCFR::nodeDOT(ofstream &os, ListDigraph::Node node) {
 	_debug << _indent << pre << _cfr.stringNode(node) << " out arcs "
 	       << count << endl;
 	while (countOutArcs(_cfr, last) == 1) {
-		ListDigraph::OutArcIt a(_cfr, last);
+		CFR::OutArcIt a(_cfr, last);
 		ListDigraph::Node next = _cfr.runningNode(a);
 
 		_debug << _indent << pre << _cfr.stringNode(last) << " --> "
@@ -224,6 +224,22 @@ DOTfromCFR::nodeDOT(ofstream &os, ListDigraph::Node node) {
 	return last;
 }
 
+void
+DOTfromCFR::succ(ListDigraph::Node node, stack<ListDigraph::Node> &followers) {
+	while (!followers.empty()) {
+		followers.pop();
+	}
+	/* Pushed in reverse, so they are taken in the order of the arcs */
+	vector<ListDigraph::Node> kids;
+	for (CFR::OutArcIt a(_cfr, node); a != INVALID; ++a) {
+		kids.push_back(_cfr.runningNode(a));
+	}
+	while (!kids.empty()) {
+		followers.push(kids.back());
+		kids.pop_back();
+	}
+}
+
 string
 DOTfromCFR::nodeLabel(ListDigraph::Node node) {
 	stringstream label;
@@ -271,7 +287,7 @@ DOTfromCFR::nodeDOTrow(ListDigraph::Node node) {
 		color = "#FFFFFF";
 	}
 
-	CFG *cfg = _cfr.getCFG();
+	const CFG *cfg = _cfr.getCFG();
 	string cfrs =
 		cfg->stringAddr(_cfr.membership(node));
 
@@ -5,24 +5,26 @@
 
 class DOTfromCFR : public DOTFactory {
 public:
-	DOTfromCFR(CFR &cfr) : DOTFactory(cfr), _cfr(cfr), _visited(_cfr) { }
+	DOTfromCFR(CFR &cfr) : DOTFactory(*cfr.getCFG()), _cfr(cfr),
+		_visited(cfr.maxNodeId() + 1, false) { }
 	void produce();
+	/* The instructions following the node in the CFR */
+	void succ(ListDigraph::Node node, stack<ListDigraph::Node> &followers);
 private:
 	CFR &_cfr;
-	ListDigraph::NodeMap<bool> _visited;
+	/* Indexed by the CFR id */
+	vector<bool> _visited;
 	string _indent;
 	stringstream _debug;
 
 	void clearVisited() {
-		for (ListDigraph::NodeIt nit(_cfr); nit != INVALID; ++nit) {
-			_visited[nit] = false;
-		}
+		_visited.assign(_visited.size(), false);
 	}
 	bool visited(ListDigraph::Node node) {
-		return _visited[node];
+		return _visited[_cfr.id(node)];
 	}
 	void visit(ListDigraph::Node node, bool yes=true) {
-		_visited[node] = yes;
+		_visited[_cfr.id(node)] = yes;
 	}
 
 	void loopDOT(ListDigraph::Node head, ofstream &os,
@@ -2,7 +2,7 @@
 
 static string
 CFRDOTid(CFR &cfr) {
-	CFG *cfg = cfr.getCFG();
+	const CFG *cfg = cfr.getCFG();
 	ListDigraph::Node cfr_initial = cfr.getInitial();
 	ListDigraph::Node cfg_node = cfr.toCFG(cfr_initial);
 
@@ -17,7 +17,7 @@ CFRDOTid(CFR &cfr) {
 
 static string
 CFRDOT(CFR &cfr, WCETOFactory &fact, int generation, unsigned int threads) {
-	CFG *cfg = cfr.getCFG();
+	const CFG *cfg = cfr.getCFG();
 	ListDigraph::Node cfr_initial = cfr.getInitial();
 	ListDigraph::Node cfg_node = cfr.toCFG(cfr_initial);
 	string switching = "Yes";
@@ -0,0 +1,53 @@
+#include "JobPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <sstream>
+#include <thread>
+
+void
+JobPool::run(ostream &out) {
+	if (_workers == 1 || _jobs.size() < 2) {
+		/* Nothing to gain, run in place */
+		for (size_t i=0; i < _jobs.size(); i++) {
+			_jobs[i](out);
+		}
+		_jobs.clear();
+		return;
+	}
+
+	vector<stringstream> outs(_jobs.size());
+	vector<exception_ptr> errors(_jobs.size());
+	atomic<size_t> next(0);
+
+	auto worker = [&]() {
+		size_t i;
+		while ((i = next++) < _jobs.size()) {
+			try {
+				_jobs[i](outs[i]);
+			} catch (...) {
+				errors[i] = current_exception();
+			}
+		}
+	};
+
+	size_t n_threads = min((size_t) _workers, _jobs.size());
+	vector<thread> threads;
+	for (size_t i=0; i < n_threads; i++) {
+		threads.push_back(thread(worker));
+	}
+	for (size_t i=0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+
+	for (size_t i=0; i < _jobs.size(); i++) {
+		out << outs[i].str();
+	}
+	_jobs.clear();
+	for (size_t i=0; i < errors.size(); i++) {
+		if (errors[i]) {
+			rethrow_exception(errors[i]);
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include <functional>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+/**
+ * Runs independent jobs on a fixed number of worker threads
+ *
+ * Each job writes its status output to its own stream. With more
+ * than one worker the streams are buffered and written out in the
+ * order the jobs were added, so the output does not depend on
+ * scheduling.
+ *
+ * Usage:
+ *   JobPool pool(4);
+ *   pool.add([&](ostream &out) { out << "working" << endl; });
+ *   pool.run(cout);
+ */
+class JobPool {
+public:
+	typedef function<void(ostream&)> Job;
+
+	JobPool(unsigned int workers=1) : _workers(workers) {
+		if (_workers == 0) {
+			_workers = 1;
+		}
+	}
+	void add(Job job) { _jobs.push_back(job); }
+	size_t size() { return _jobs.size(); }
+	/**
+	 * Runs every job, then clears the pool.
+	 *
+	 * If a job throws the remaining jobs still run, and the
+	 * exception of the first (in order) failed job is rethrown.
+	 *
+	 * @param[in] out where the jobs' output is written
+	 */
+	void run(ostream &out);
+private:
+	unsigned int _workers;
+	vector<Job> _jobs;
+};
+
+#endif /* JOB_POOL_H */
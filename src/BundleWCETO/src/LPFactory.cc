@@ -2,71 +2,128 @@
 
 void
 LPFactory::produce() {
-	ofstream lpf(_path.c_str());
+	_lp.clear();
+	_vars.clear();
+	_false_vars.clear();
+	_flows.clear();
+	_cost_rows.clear();
+	_threads_row = -1;
 
-	lpf << makeObjective() << endl;
-
-	lpf << "/* m = # of threads */" << endl;
-	lpf << "m = " << _threads << ";" << endl;
+	makeObjective();
 
 	for (ListDigraph::NodeIt nit(*_cfrg); nit != INVALID; ++nit) {
 		ListDigraph::Node cfr_node = nit;
 		CFR *cfr = _cfrg->findCFR(cfr_node);
 		switch (findType(cfr)) {
 		case PLAIN:
-			lpf << "/* PLAIN " << cfr->str() << "*/" << endl;
-			lpf << makeWCETO(cfr) << endl;
-			lpf << makePredThread(cfr) << endl;
-			lpf << makeSuccThread(cfr) << endl;
-			lpf << makeBin(cfr) << endl << endl;
+			if (dumping()) {
+				comment("PLAIN " + cfr->str());
+			}
+			makeWCETO(cfr);
+			makePredThread(cfr);
+			makeSuccThread(cfr);
+			makeBin(cfr);
 			break;
 		case LOOP:
-			lpf << "/* LOOP HEAD " << cfr->str() << "*/" << endl;
-			lpf << makeLoopWCETO(cfr) << endl;
-			lpf << makeLoopPredThread(cfr) << endl;
-			lpf << makeLoopSuccThread(cfr) << endl;
-			lpf << makeLoopBin(cfr) << endl << endl;			
+			if (dumping()) {
+				comment("LOOP HEAD " + cfr->str());
+			}
+			makeLoopWCETO(cfr);
+			makeLoopPredThread(cfr);
+			makeLoopSuccThread(cfr);
+			makeLoopBin(cfr);
 			break;
 		case SKIP:
-			lpf << "/* INNER " << cfr->str() << "*/" << endl;
-			lpf << makeInnerWCETO(cfr) << endl;
-			lpf << makeInnerPredThread(cfr) << endl;
-			lpf << makeInnerSuccThread(cfr) << endl;
-			lpf << makeInnerBin(cfr) << endl << endl;
+			if (dumping()) {
+				comment("INNER " + cfr->str());
+			}
+			makeInnerWCETO(cfr);
+			makeInnerPredThread(cfr);
+			makeInnerSuccThread(cfr);
+			makeInnerBin(cfr);
 			break;
 		default:
-			throw runtime_error("Unknown type");			
+			throw runtime_error("Unknown type");
 		}
-		
 	}
 
-	lpf << "/* -- Variable Types -- */" << endl;
-	lpf << "bin b";
-	for (ListDigraph::NodeIt nit(*_cfrg); nit != INVALID; ++nit) {
-		ListDigraph::Node cfr_node = nit;
-		CFR *cfr = _cfrg->findCFR(cfr_node);
-		lpf << "," << endl << "\t" << makeId(cfr) << ".b";
-		if (_cfrg->isHeadCFR(cfr)) {
-			lpf << "," << endl << "\t" << makeFalseId(cfr) << ".b";
+	if (dumping()) {
+		_lp.write(_path);
+	}
+}
+
+void
+LPFactory::write() {
+	update();
+	_lp.write(_path);
+}
+
+void
+LPFactory::solve() {
+	update();
+	_lp.solve();
+}
+
+LPTable
+LPFactory::solveGrid(const vector<uint32_t> &threads,
+		     const vector<uint32_t> &bundle_ctxs,
+		     const vector<uint32_t> &thread_ctxs) {
+	uint32_t m = _threads, bundle_ctx = _bundle_ctx;
+	uint32_t thread_ctx = _thread_ctx;
+	LPTable table;
+
+	for (size_t i = 0; i < bundle_ctxs.size(); i++) {
+		for (size_t j = 0; j < thread_ctxs.size(); j++) {
+			for (size_t k = 0; k < threads.size(); k++) {
+				LPPoint point;
+				point.threads = threads[k];
+				point.bundle_ctx = bundle_ctxs[i];
+				point.thread_ctx = thread_ctxs[j];
+				setThreads(point.threads);
+				setBundleCTX(point.bundle_ctx);
+				setThreadCTX(point.thread_ctx);
+				solve();
+				point.objective = objective();
+				table.push_back(point);
+			}
 		}
-		
 	}
-	lpf << ";" << endl;
-	lpf.close();
+	setThreads(m);
+	setBundleCTX(bundle_ctx);
+	setThreadCTX(thread_ctx);
+	return table;
+}
+
+double
+LPFactory::cost(CFR *cfr) const {
+	map<CFR*, Vars>::const_iterator it = _vars.find(cfr);
+	return it == _vars.end() ? 0 : _lp.value(it->second.c);
+}
+
+double
+LPFactory::loopCost(CFR *cfr) const {
+	map<CFR*, Vars>::const_iterator it = _false_vars.find(cfr);
+	return it == _false_vars.end() ? 0 : _lp.value(it->second.c);
+}
+
+double
+LPFactory::threads(CFR *cfr) const {
+	map<CFR*, Vars>::const_iterator it = _vars.find(cfr);
+	return it == _vars.end() ? 0 : _lp.value(it->second.t);
+}
+
+bool
+LPFactory::selected(CFR *cfr) const {
+	map<CFR*, Vars>::const_iterator it = _vars.find(cfr);
+	return it != _vars.end() && _lp.value(it->second.b) > 0.5;
 }
 
 string
 LPFactory::makeId(CFR *cfr) {
-	CFG *cfg = cfr->getCFG();
+	const CFG *cfg = cfr->getCFG();
 	ListDigraph::Node cfr_initial = cfr->getInitial();
 	ListDigraph::Node cfg_node = cfr->toCFG(cfr_initial);
 
-	FunctionCall call = cfg->getFunction(cfg_node);
-	string fstr = call.str();
-	replace(fstr.begin(), fstr.end(), ' ', '_');
-	replace(fstr.begin(), fstr.end(), ':', '_');
-	fstr.erase(std::remove(fstr.begin(), fstr.end(), ','), fstr.end());
-	
 	stringstream _id;
 	_id << "n" << cfg->id(cfg_node) << "_" << cfg->stringAddr(cfg_node);
 
@@ -75,7 +132,7 @@ LPFactory::makeId(CFR *cfr) {
 
 string
 LPFactory::makeFalseId(CFR *cfr) {
-	CFG *cfg = cfr->getCFG();
+	const CFG *cfg = cfr->getCFG();
 	ListDigraph::Node cfr_initial = cfr->getInitial();
 	ListDigraph::Node cfg_node = cfr->toCFG(cfr_initial);
 
@@ -85,36 +142,121 @@ LPFactory::makeFalseId(CFR *cfr) {
 	return _id.str();
 }
 
-string
-LPFactory::makeObjective() {
-	stringstream obj;
-	obj << "max: 0 ";
+const LPFactory::Vars&
+LPFactory::vars(CFR *cfr) {
+	map<CFR*, Vars>::iterator it = _vars.find(cfr);
+	if (it != _vars.end()) {
+		return it->second;
+	}
+	Vars &v = _vars[cfr];
+	addVars(v, dumping() ? makeId(cfr) : "");
+	return v;
+}
+
+const LPFactory::Vars&
+LPFactory::falseVars(CFR *cfr) {
+	map<CFR*, Vars>::iterator it = _false_vars.find(cfr);
+	if (it != _false_vars.end()) {
+		return it->second;
+	}
+	Vars &v = _false_vars[cfr];
+	addVars(v, dumping() ? makeFalseId(cfr) : "");
+	return v;
+}
+
+void
+LPFactory::addVars(Vars &v, string id) {
+	v.c = _lp.addVar();
+	v.b = _lp.addVar(true);
+	v.t = _lp.addVar();
+	v.id = id;
+	if (dumping()) {
+		_lp.setName(v.c, id + ".c");
+		_lp.setName(v.b, id + ".b");
+		_lp.setName(v.t, id + ".t");
+	}
+}
+
+int
+LPFactory::flow(const Vars &src, const Vars &dst) {
+	pair<int, int> key(src.t, dst.t);
+	map<pair<int, int>, int>::iterator it = _flows.find(key);
+	if (it != _flows.end()) {
+		return it->second;
+	}
+	int col = _lp.addVar();
+	if (dumping()) {
+		_lp.setName(col, src.id + "." + dst.id + ".t");
+	}
+	_flows[key] = col;
+	return col;
+}
+
+void
+LPFactory::comment(const string &text) {
+	if (dumping()) {
+		_lp.addComment(text);
+	}
+}
+
+int
+LPFactory::addRow(LPModel::op_t op, double rhs, const char *text) {
+	if (dumping()) {
+		_lp.addComment(text);
+	}
+	return _lp.addRow(op, rhs);
+}
 
+void
+LPFactory::addCost(int row, const Vars &v, double load, double exe) {
+	CostRow cost;
+	cost.row = row;
+	cost.b = v.b;
+	cost.t = v.t;
+	cost.load = load;
+	cost.exe = exe;
+	_cost_rows.push_back(cost);
+	_lp.addTerm(row, v.b, -load - _bundle_ctx);
+	_lp.addTerm(row, v.t, -exe - _thread_ctx);
+}
+
+void
+LPFactory::update() {
+	vector<CostRow>::iterator it;
+	for (it = _cost_rows.begin(); it != _cost_rows.end(); ++it) {
+		_lp.setTerm(it->row, it->b, -it->load - _bundle_ctx);
+		_lp.setTerm(it->row, it->t, -it->exe - _thread_ctx);
+	}
+	if (_threads_row >= 0) {
+		_lp.setRhs(_threads_row, _threads);
+	}
+}
+
+void
+LPFactory::makeObjective() {
 	for (ListDigraph::NodeIt nit(*_cfrg); nit != INVALID; ++nit) {
 		ListDigraph::Node cfr_node = nit;
 		CFR *cfr = _cfrg->findCFR(cfr_node);
 
 		switch(findType(cfr)) {
 		case PLAIN:
-			obj << "+ " << makeId(cfr) << ".c ";
+			_lp.addObjective(vars(cfr).c, 1);
 			break;
 		case LOOP:
-			obj << "+ " << makeFalseId(cfr) << ".c ";
+			_lp.addObjective(falseVars(cfr).c, 1);
 			break;
 		case SKIP:
 			break;
+		default:
+			throw runtime_error("Unknown type");
 		}
 	}
-	obj << ";";
-
-	return obj.str();
 }
 
 
 LPFactory::wceto_type_t
 LPFactory::findType(CFR *cfr) {
 	ListDigraph::Node cfr_initial = cfr->getInitial();
-	ListDigraph::Node cfg_node = cfr->toCFG(cfr_initial);
 
 	if (cfr->isHead(cfr_initial)) {
 		return LOOP;
@@ -127,10 +269,10 @@ LPFactory::findType(CFR *cfr) {
 }
 
 /**
- * 
- *
+ * c = load cost + bundle ctx when selected, plus the execution and
+ * thread ctx cost of every thread (see addCost())
  */
-string
+void
 LPFactory::makeWCETO(CFR *cfr) {
 	switch(findType(cfr)) {
 	case PLAIN:
@@ -142,27 +284,13 @@ LPFactory::makeWCETO(CFR *cfr) {
 		throw runtime_error("Unknown type");
 	}
 
-	stringstream wceto;
-	string id = makeId(cfr);
-	wceto << "\t/* WCETO */" << endl;
-	wceto << "\t" << id << ".c = "
-	      << cfr->loadCost() << " " << id << ".b + " /* Memory Load Cost */
-	      << cfr->exeCost() << " " << id << ".t";    /* Execution cost */
-	if (_bundle_ctx > 0) {
-		/* Bundle Context switch cost */		
-		wceto << " + " << _bundle_ctx << " " << id << ".b";
-	}
-	if (_thread_ctx > 0) {
-		/* Thread Context switch cost */
-		wceto << " + " << _thread_ctx << " " << id << ".t";
-	}
-
-	wceto << ";";
-
-	return wceto.str();
+	const Vars &v = vars(cfr);
+	int row = addRow(LPModel::EXACTLY, 0, "WCETO");
+	_lp.addTerm(row, v.c, 1);
+	addCost(row, v, cfr->loadCost(), cfr->exeCost());
 }
 
-string
+void
 LPFactory::makeLoopWCETO(CFR *cfr) {
 	switch(findType(cfr)) {
 	case LOOP:
@@ -173,93 +301,82 @@ LPFactory::makeLoopWCETO(CFR *cfr) {
 	default:
 		throw runtime_error("Unknown type");
 	}
-	string id = makeId(cfr);
-	string fake = makeFalseId(cfr); 
-	stringstream obj;
-	obj << "\t/* Loop WCETO ";
+	const Vars &fake = falseVars(cfr);
 
 	/* Get the maximum number of iterations */
 	uint32_t iters = cfr->getIters(cfr->getInitial());
 	/* Make a set of ECBs */
 	ECBs *ecbs = getECBsOfLoop(cfr);
-	obj << "ECBs[" << ecbs->size() << "]: " << ecbs->str() << " */" << endl;
 	uint32_t brt = cfr->getCache()->memLatency();
+	if (dumping()) {
+		stringstream ss;
+		ss << "Loop ECBs[" << ecbs->size() << "]: " << ecbs->str();
+		comment(ss.str());
+	}
 
 	/* WCETO for the false head */
-	obj << "\t" << fake << ".c = ";
-	obj << ecbs->size() * brt << " " << fake << ".b"; // c.fn = gamma.fn * b.fn
+	int row = addRow(LPModel::EXACTLY, 0, "Loop WCETO");
+	_lp.addTerm(row, fake.c, 1);
+	// c.fn = gamma.fn * b.fn
+	_lp.addTerm(row, fake.b, -(double) ecbs->size() * brt);
 	// I.n * ( sum of interior nodes WCETO )
 	CFRList *list = _cfrg->inLoopOfCFR(cfr);
 	CFRList::iterator it;
 	for (it = list->begin(); it != list->end(); ++it) {
 		CFR *in_cfr = *it;
-		string in_id = makeId(in_cfr);
+		int in_c = vars(in_cfr).c;
 		if (in_cfr != cfr && _cfrg->isHeadCFR(in_cfr)) {
-			in_id = makeFalseId(in_cfr);
+			in_c = falseVars(in_cfr).c;
 		}
-		obj << endl << "\t\t+ " << iters << " " << in_id << ".c ";
+		_lp.addTerm(row, in_c, -(double) iters);
 	}
-	obj << ";" << endl;
-	obj << makeInnerWCETO(cfr) << endl;
-	obj << makeInnerBin(cfr) << endl;
+	makeInnerWCETO(cfr);
+	makeInnerBin(cfr);
 	delete list;
 	delete ecbs;
-
-	return obj.str();
 }
 
-string
+void
 LPFactory::makeInnerWCETO(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
+	const Vars &v = vars(cfr);
 	ECBs *dupecbs = getECBsOfLoop(cfr);
 	dupecbs->dupesOnly();
 	ECBs *cfrecbs = cfr->getECBs();
-	ECBs isect;
-	set_intersection(dupecbs->begin(), dupecbs->end(),
-			 cfrecbs->begin(), cfrecbs->end(), back_inserter(isect));
-	ct << "\t/* G2 ECBs[" << dupecbs->size() << "] " << dupecbs->str() << " */"
-	   << endl;
-	ct << "\t/* CFR ECBs[" << cfrecbs->size() << "] " << cfrecbs->str() << " */"
-	   << endl;
-	ct << "\t/* isect ECBs[" << isect.size() << "] " << isect.str() << " */"
-	   << endl;
+	ECBs isect(*dupecbs);
+	isect.intersect(*cfrecbs);
+	if (dumping()) {
+		stringstream ss;
+		ss << "G2 ECBs[" << dupecbs->size() << "] " << dupecbs->str();
+		comment(ss.str());
+		ss.str("");
+		ss << "CFR ECBs[" << cfrecbs->size() << "] " << cfrecbs->str();
+		comment(ss.str());
+		ss.str("");
+		ss << "isect ECBs[" << isect.size() << "] " << isect.str();
+		comment(ss.str());
+	}
 	delete dupecbs;
 	delete cfrecbs;
-	      
+
 	uint32_t brt = cfr->getCache()->memLatency();
 	uint32_t ic = isect.size();
-									   
-	ct << "\t/* WCETO */" << endl << "\t";
-	ct << id << ".c = "
-	   << cfr->exeCost() << " " << id << ".t"; /* Execution cost */
-	if (_bundle_ctx > 0) {
-		/* Context switch cost */		
-		ct << " + " << _bundle_ctx << " " << id << ".b";
-	}
-	if (_thread_ctx > 0) {
-		ct << " + " << _thread_ctx << " " << id << ".t";
-	}
-	uint32_t bi = brt * ic;
-	if (ic > 0 && brt > 0) {
-		/* per iteration penalty */		
-		ct << " + " << bi << " " << id << ".b";
-	}
-	ct << ";";
 
-	return ct.str();
+	int row = addRow(LPModel::EXACTLY, 0, "WCETO");
+	_lp.addTerm(row, v.c, 1);
+	/* The per iteration penalty */
+	addCost(row, v, (double) brt * ic, cfr->exeCost());
 }
 
-string
+void
 LPFactory::makePredThread(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
-	ct << "\t/* Predecessor Threads */" << endl;
-	ct << "\t" << id << ".t = ";
-
+	const Vars &v = vars(cfr);
+	int row = addRow(LPModel::EXACTLY, 0, "Predecessor Threads");
 	if (_cfrg->getInitialCFR() == cfr) {
-		ct << "m";
+		/* m threads start here */
+		_lp.setRhs(row, _threads);
+		_threads_row = row;
 	}
+	_lp.addTerm(row, v.t, 1);
 	/*
 	 * Predecessors may be part of a collapsed node
 	 */
@@ -267,32 +384,24 @@ LPFactory::makePredThread(CFR *cfr) {
 	CFRList::iterator it = list->begin();
 	for ( ; it != list->end(); ++it) {
 		CFR *pred_cfr = *it;
-		ct << endl << "\t\t";
-		if (it != list->begin()) {
-			ct << "+ ";
-		}
 		if (_cfrg->isHeadCFR(pred_cfr) ||
 		    !_cfrg->sameLoop(cfr, pred_cfr)) {
 			pred_cfr = _cfrg->crown(pred_cfr);
-			ct << makeFalseId(pred_cfr) << "." << id << ".t";
+			_lp.addTerm(row, flow(falseVars(pred_cfr), v), -1);
 			continue;
 		}
-		
-		string pred_id = makeId(pred_cfr);
-		ct << pred_id << "." << id << ".t";
+		_lp.addTerm(row, flow(vars(pred_cfr), v), -1);
 	}
 	delete list;
-	ct << ";";
-	return ct.str();
 }
 
-string
+void
 LPFactory::makeLoopPredThread(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
-	string fake = makeFalseId(cfr);
-	ct << "\t/* Loop (False Head) Predecessor Thread Limit */" << endl;
-	ct << "\t" << fake << ".t = ";
+	const Vars &v = vars(cfr);
+	const Vars &fake = falseVars(cfr);
+	int row = addRow(LPModel::EXACTLY, 0,
+			 "Loop (False Head) Predecessor Thread Limit");
+	_lp.addTerm(row, fake.t, 1);
 	CFRList *list = _cfrg->preds(cfr);
 	CFRList::iterator it = list->begin();
 	for ( ; it != list->end(); ++it) {
@@ -300,27 +409,20 @@ LPFactory::makeLoopPredThread(CFR *cfr) {
 		if (_cfrg->inLoop(cfr, pred_cfr)) {
 			continue;
 		}
-		string pred_id = makeId(pred_cfr);
-		ct << endl << "\t\t";
-		if (it != list->begin()) {
-			ct << "+ ";
-		}
-		ct << pred_id << "." << fake << ".t";
+		_lp.addTerm(row, flow(vars(pred_cfr), fake), -1);
 	}
 	delete list;
-	ct << ";" << endl;
 
-	ct << "\t/* Loop Head Predecessor Thread Limit */" << endl;
-	ct << "\t" << id << ".t = " << fake << ".t;";
-	return ct.str();
+	row = addRow(LPModel::EXACTLY, 0, "Loop Head Predecessor Thread Limit");
+	_lp.addTerm(row, v.t, 1);
+	_lp.addTerm(row, fake.t, -1);
 }
 
-string
+void
 LPFactory::makeInnerPredThread(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
-	ct << "\t/* Inner Predecessor Thread Limit */" << endl;
-	ct << "\t" << id << ".t = ";
+	const Vars &v = vars(cfr);
+	int row = addRow(LPModel::EXACTLY, 0, "Inner Predecessor Thread Limit");
+	_lp.addTerm(row, v.t, 1);
 
 	CFRList *list = _cfrg->preds(cfr);
 	CFRList::iterator it = list->begin();
@@ -335,27 +437,17 @@ LPFactory::makeInnerPredThread(CFR *cfr) {
 			/* Find the same loop level predecessor */
 			pred_cfr = _cfrg->getHead(pred_cfr);
 		}
-		string pred_id = makeId(pred_cfr);
 		if (pred_cfr != head && _cfrg->isHeadCFR(pred_cfr)) {
-			pred_id = makeFalseId(pred_cfr);
-		}
-		ct << endl << "\t\t";
-		if (it != list->begin()) {
-			ct << "+ ";
+			_lp.addTerm(row, flow(falseVars(pred_cfr), v), -1);
+		} else {
+			_lp.addTerm(row, flow(vars(pred_cfr), v), -1);
 		}
-		ct << pred_id << "." << id << ".t";
 	}
 	delete list;
-	ct << ";";
-	return ct.str();
 }
 
-string
+void
 LPFactory::makeSuccThread(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
-	ct << "\t/* Successor Threads */";
-
 	CFRList *list = NULL;
 	switch(findType(cfr)) {
 	case PLAIN:
@@ -369,147 +461,113 @@ LPFactory::makeSuccThread(CFR *cfr) {
 	default:
 		throw runtime_error("Unknown type");
 	}
-	if (!list) {
-		return ct.str();
-	}
 	if (list->size() == 0) {
-		return ct.str();
+		delete list;
+		return;
 	}
+	const Vars &v = vars(cfr);
+	int row = addRow(LPModel::EXACTLY, 0, "Successor Threads");
+	_lp.addTerm(row, v.t, -1);
 	CFRList::iterator it;
 	for (it = list->begin(); it != list->end(); ++it) {
 		CFR *succ = *it;
-		string succ_id = makeId(succ);
-		ct << endl << "\t";
-		if (it != list->begin()) {
-			ct << "\t+ ";
-		}
-
 		if (_cfrg->isHeadCFR(succ) ||
 		    !_cfrg->sameLoop(cfr, succ)) {
 			succ = _cfrg->crown(succ);
-			ct << id << "." << makeFalseId(succ) << ".t" << endl;
+			_lp.addTerm(row, flow(v, falseVars(succ)), 1);
 			continue;
 		}
-		ct << id << "." << succ_id << ".t " << endl;
+		_lp.addTerm(row, flow(v, vars(succ)), 1);
 	}
-	ct << "\t\t= " << id << ".t;";
-	return ct.str();
+	delete list;
 }
 
-string
+void
 LPFactory::makeLoopSuccThread(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
-	string fake = makeFalseId(cfr);
-	ct << "\t/* Loop (False Head) Successor Thread Limit */";
+	const Vars &v = vars(cfr);
+	const Vars &fake = falseVars(cfr);
 	CFRList *list = _cfrg->exitOfCFR(cfr);
 	CFRList::iterator it = list->begin();
-	for ( ; it != list->end(); ++it) {
-		CFR *succ_cfr = *it;
-		string succ_id = makeId(succ_cfr);
-		ct << endl << "\t";
-		if (it != list->begin()) {
-			ct << " + ";
-		}
-		ct << fake << "." << succ_id << ".t";
-	}
 	if (list->size() > 0) {
-		ct << endl << "\t\t= " << fake << ".t;";
+		int row = addRow(LPModel::EXACTLY, 0,
+				 "Loop (False Head) Successor Thread Limit");
+		_lp.addTerm(row, fake.t, -1);
+		for ( ; it != list->end(); ++it) {
+			_lp.addTerm(row, flow(fake, vars(*it)), 1);
+		}
 	}
 	delete list;
-	int count=0;
+
 	list = _cfrg->succs(cfr);
-	ct << "\t/* Loop Head Node Successor Thread Limit */";
+	int row = -1;
 	for (it = list->begin(); it != list->end(); ++it) {
 		CFR *succ_cfr = *it;
 		if (_cfrg->getHead(succ_cfr) != cfr) {
 			continue;
 		}
-		++count;
-		string succ_id = makeId(succ_cfr);
-		if (_cfrg->isHeadCFR(succ_cfr)) {
-			succ_id = makeFalseId(succ_cfr);
+		if (row < 0) {
+			row = addRow(LPModel::EXACTLY, 0,
+				     "Loop Head Node Successor Thread Limit");
+			_lp.addTerm(row, v.t, -1);
 		}
-		ct << endl << "\t";
-		if (it != list->begin()) {
-			ct << " + ";
+		if (_cfrg->isHeadCFR(succ_cfr)) {
+			_lp.addTerm(row, flow(v, falseVars(succ_cfr)), 1);
+		} else {
+			_lp.addTerm(row, flow(v, vars(succ_cfr)), 1);
 		}
-		ct << id << "." << succ_id << ".t";
-	}
-	if (count > 0) {
-		ct << endl << "\t\t= " << id << ".t;";
 	}
 	delete list;
-	
-	return ct.str();
 }
 
-string
+void
 LPFactory::makeInnerSuccThread(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
-
-	ct << "\t/* Successor (inner) Threads */";
-
+	const Vars &v = vars(cfr);
 	CFR *head = _cfrg->getHead(cfr);
 	CFRList *list = _cfrg->succs(cfr);
 	CFRList::iterator it;
-	int count = 0;
+	int row = -1;
 	for (it = list->begin(); it != list->end(); ++it) {
 		CFR *succ = *it;
-		string succ_id = makeId(succ);
 		if (_cfrg->getHead(succ) != head) {
 			/* Outside of this loop */
 			continue;
 		}
-		count++;
-		if (_cfrg->isHeadCFR(succ)) {
-			succ_id = makeFalseId(succ);
+		if (row < 0) {
+			row = addRow(LPModel::EXACTLY, 0,
+				     "Successor (inner) Threads");
+			_lp.addTerm(row, v.t, -1);
 		}
-		ct << endl << "\t";
-		if (it != list->begin()) {
-			ct << "\t+ ";
+		if (_cfrg->isHeadCFR(succ)) {
+			_lp.addTerm(row, flow(v, falseVars(succ)), 1);
+		} else {
+			_lp.addTerm(row, flow(v, vars(succ)), 1);
 		}
-		ct << id << "." << succ_id << ".t " << endl;
 	}
-	if (count > 0) {
-		ct << "\t\t= " << id << ".t;";
-	}
-	return ct.str();
+	delete list;
 }
 
-string
+void
 LPFactory::makeBin(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
-
-	ct << "\t/* Selector */" << endl << "\t";
-	ct << id << ".b <= " << id << ".t;";
-
-
-	return ct.str();
+	const Vars &v = vars(cfr);
+	int row = addRow(LPModel::AT_MOST, 0, "Selector");
+	_lp.addTerm(row, v.b, 1);
+	_lp.addTerm(row, v.t, -1);
 }
 
-string
+void
 LPFactory::makeLoopBin(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
-	string fake = makeFalseId(cfr);
-
-	ct << "\t/* Selector (False Head) */" << endl << "\t";
-	ct << fake << ".b <= " << fake << ".t;";
-
-	return ct.str();
+	const Vars &fake = falseVars(cfr);
+	int row = addRow(LPModel::AT_MOST, 0, "Selector (False Head)");
+	_lp.addTerm(row, fake.b, 1);
+	_lp.addTerm(row, fake.t, -1);
 }
 
-string
+void
 LPFactory::makeInnerBin(CFR *cfr) {
-	stringstream ct;
-	string id = makeId(cfr);
-	ct << "\t/* Selector (Inner) */" << endl << "\t";
-	ct << id << ".b <= " << id << ".t;";
-
-	return ct.str();
+	const Vars &v = vars(cfr);
+	int row = addRow(LPModel::AT_MOST, 0, "Selector (Inner)");
+	_lp.addTerm(row, v.b, 1);
+	_lp.addTerm(row, v.t, -1);
 }
 
 
@@ -526,17 +584,16 @@ LPFactory::getECBsOfLoop(CFR *cfr) {
 	CFR *loopHead = cfr;
 	if (!_cfrg->isHeadCFR(cfr)) {
 		loopHead = _cfrg->getHead(cfr);
-	} 
+	}
 	CFRList *list = _cfrg->inLoopOfCFR(loopHead);
 	CFRList::iterator it;
 	for (it = list->begin(); it != list->end(); ++it) {
 		CFR *in_cfr = *it;
 
 		/* Collect the ECBS from this CFR */
-		in_cfr->calcECBs();		
+		in_cfr->calcECBs();
 		ECBs *in_ecbs = in_cfr->getECBs();
-		ecbs->insert(ecbs->begin(), in_ecbs->begin(), in_ecbs->end());
-		ecbs->sort();
+		ecbs->merge(*in_ecbs);
 		delete in_ecbs;
 	}
 	return ecbs;
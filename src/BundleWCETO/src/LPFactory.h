@@ -2,23 +2,44 @@
 #define LPFACTORY_H
 
 #include "CFRG.h"
+#include "LPModel.h"
 #include<fstream>
 using namespace std;
 
+/* An objective of a parametric solve */
+struct LPPoint {
+	uint32_t threads, bundle_ctx, thread_ctx;
+	double objective;
+};
+typedef vector<LPPoint> LPTable;
+
 /**
- * Generates DOT Files from CFG objects
+ * Builds the ILP bounding the WCETO of a CFRG
+ *
+ * Each CFR has a cost (.c), a thread count (.t) and a selector (.b)
+ * that is 1 when the CFR runs at all, loop heads also have a false head
+ * standing for the whole loop. Threads flow along the CFRG arcs.
+ *
+ * The model is built in memory and solved in process (see LPModel),
+ * it is only written in the lp_solve format when a path is set.
+ *
+ * The thread count and the context switch costs are parameters of a
+ * built model. Changing them and solving again only updates the
+ * coefficients and the right hand side they appear in, and the solve
+ * starts from the previous basis (see solveGrid()).
  */
 class LPFactory {
 public:
 	LPFactory(CFRG *cfrg, uint32_t threads, uint32_t bundle_ctx,
-		  uint32_t thread_ctx, string path) {
+		  uint32_t thread_ctx, string path="") {
 		_cfrg = cfrg;
+		_threads_row = -1;
 		setPath(path);
 		setThreads(threads);
 		setBundleCTX(bundle_ctx);
 		setThreadCTX(thread_ctx);
 	}
-	/* Gets and sets the path of the lp_solve file */
+	/* Gets and sets the path of the lp_solve file, none if empty */
 	string getPath() { return _path; }
 	void setPath(string path) { _path = path; }
 
@@ -31,7 +52,36 @@ public:
 	uint32_t getThreadCTX() { return _thread_ctx; }
 	void setThreadCTX(uint32_t c) { _thread_ctx = c; }
 
+	/* Builds the model, writes it if a path is set */
 	void produce();
+	/* Writes the built model with the current parameters */
+	void write();
+	/* Solves the model built by produce() */
+	void solve();
+	/**
+	 * Solves the model built by produce() for every combination of
+	 * the parameters, the thread count changing fastest
+	 *
+	 * @return the objective of each combination, the parameters are
+	 * restored afterwards
+	 */
+	LPTable solveGrid(const vector<uint32_t> &threads,
+			  const vector<uint32_t> &bundle_ctxs,
+			  const vector<uint32_t> &thread_ctxs);
+	const LPModel& model() const { return _lp; }
+
+	/* The WCETO bound, only valid after solve() */
+	double objective() const { return _lp.objective(); }
+	/**
+	 * The solved variables of a CFR, 0 for a CFR not in the model
+	 *
+	 * cost() of a loop head is one iteration of the head CFR,
+	 * loopCost() the whole loop.
+	 */
+	double cost(CFR *cfr) const;
+	double loopCost(CFR *cfr) const;
+	double threads(CFR *cfr) const;
+	bool selected(CFR *cfr) const;
 
 private:
 	typedef enum {
@@ -41,33 +91,70 @@ private:
 		SKIP
 	} wceto_type_t;
 
+	/* The columns of a CFR's (or false head's) variables */
+	struct Vars {
+		int c, b, t;
+		/* The name prefix, only when dumping */
+		string id;
+	};
+	/* A WCETO row, its costs without the context switches */
+	struct CostRow {
+		int row, b, t;
+		double load, exe;
+	};
+
 	/* Returns an identifier for a CFR */
 	string makeId(CFR *cfr);
-	string makeFalseId(CFR *cfr);	
-	string makeObjective();
+	string makeFalseId(CFR *cfr);
+	/* The variables of a CFR or its false head, added on first use */
+	const Vars& vars(CFR *cfr);
+	const Vars& falseVars(CFR *cfr);
+	void addVars(Vars &v, string id);
+	/* The threads flowing from src to dst, added on first use */
+	int flow(const Vars &src, const Vars &dst);
+	bool dumping() const { return _path.length() > 0; }
+	void comment(const string &text);
+	int addRow(LPModel::op_t op, double rhs, const char *text);
+	/**
+	 * Adds the cost terms of a WCETO row, load is paid when the CFR
+	 * is selected and exe by each thread
+	 */
+	void addCost(int row, const Vars &v, double load, double exe);
+	/* Applies the parameters to the built model */
+	void update();
+
+	void makeObjective();
 	/* The constraint for the CFR's WCETO */
-	string makeWCETO(CFR *cfr);
-	string makeLoopWCETO(CFR *cfr);
-	string makeInnerWCETO(CFR *cfr);
+	void makeWCETO(CFR *cfr);
+	void makeLoopWCETO(CFR *cfr);
+	void makeInnerWCETO(CFR *cfr);
 	/* The constraints for the boolean selector variable */
-	string makeBin(CFR *cfr);
-	string makeLoopBin(CFR *cfr);
-	string makeInnerBin(CFR *cfr);	
+	void makeBin(CFR *cfr);
+	void makeLoopBin(CFR *cfr);
+	void makeInnerBin(CFR *cfr);
 	/* The sum of predecessors threads contributions */
-	string makePredThread(CFR *cfr);
-	string makeLoopPredThread(CFR *cfr);
-	string makeInnerPredThread(CFR *cfr);
-	/* The sum of successor threads contributions */	
-	string makeSuccThread(CFR *cfr);
-	string makeLoopSuccThread(CFR *cfr);
-	string makeInnerSuccThread(CFR *cfr);
-	
+	void makePredThread(CFR *cfr);
+	void makeLoopPredThread(CFR *cfr);
+	void makeInnerPredThread(CFR *cfr);
+	/* The sum of successor threads contributions */
+	void makeSuccThread(CFR *cfr);
+	void makeLoopSuccThread(CFR *cfr);
+	void makeInnerSuccThread(CFR *cfr);
+
 	wceto_type_t findType(CFR *cfr);
 	ECBs *getECBsOfLoop(CFR *cfr);
-	
+
 	CFRG *_cfrg;
 	string _path;
 	uint32_t _threads, _bundle_ctx, _thread_ctx;
+
+	LPModel _lp;
+	map<CFR*, Vars> _vars, _false_vars;
+	/* (source .t, target .t) -> flow column */
+	map<pair<int, int>, int> _flows;
+	/* The rows depending on the parameters */
+	vector<CostRow> _cost_rows;
+	int _threads_row;
 };
 
 
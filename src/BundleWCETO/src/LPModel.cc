@@ -0,0 +1,308 @@
+#include "LPModel.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef LPSOLVE
+#include <lpsolve/lp_lib.h>
+#endif
+
+LPModel::~LPModel() {
+	drop();
+}
+
+void
+LPModel::clear() {
+	drop();
+	_binary.clear();
+	_names.clear();
+	_obj.clear();
+	_rows.clear();
+	_comment.clear();
+	_values.clear();
+	_objective = 0;
+}
+
+int
+LPModel::addVar(bool binary) {
+	_binary.push_back(binary);
+	drop();
+	return _binary.size() - 1;
+}
+
+void
+LPModel::setName(int col, const string &name) {
+	_names[col] = name;
+}
+
+string
+LPModel::getName(int col) const {
+	map<int, string>::const_iterator it = _names.find(col);
+	if (it != _names.end()) {
+		return it->second;
+	}
+	stringstream ss;
+	ss << "x" << col;
+	return ss.str();
+}
+
+void
+LPModel::addObjective(int col, double coef) {
+	_obj[col] += coef;
+	drop();
+}
+
+int
+LPModel::addRow(op_t op, double rhs, const string &comment) {
+	if (comment.length() > 0) {
+		addComment(comment);
+	}
+	_rows.push_back(Row());
+	Row &row = _rows.back();
+	row.op = op;
+	row.rhs = rhs;
+	row.comment.swap(_comment);
+	drop();
+	return _rows.size() - 1;
+}
+
+void
+LPModel::addTerm(int row, int col, double coef) {
+	if (col < 0 || col >= countVars()) {
+		throw runtime_error("LPModel::addTerm Unknown variable");
+	}
+	_rows.at(row).terms[col] += coef;
+	drop();
+}
+
+void
+LPModel::setTerm(int row, int col, double coef) {
+	if (col < 0 || col >= countVars()) {
+		throw runtime_error("LPModel::setTerm Unknown variable");
+	}
+	map<int, double> &terms = _rows.at(row).terms;
+	map<int, double>::iterator it = terms.find(col);
+	if (it == terms.end()) {
+		/* A new term changes the structure */
+		addTerm(row, col, coef);
+		return;
+	}
+	if (it->second == coef) {
+		return;
+	}
+	it->second = coef;
+	_solved = false;
+#ifdef LPSOLVE
+	if (_solver) {
+		set_mat(_solver, row + 1, col + 1, coef);
+	}
+#endif
+}
+
+double
+LPModel::getTerm(int row, int col) const {
+	const map<int, double> &terms = _rows.at(row).terms;
+	map<int, double>::const_iterator it = terms.find(col);
+	return it == terms.end() ? 0 : it->second;
+}
+
+void
+LPModel::setRhs(int row, double rhs) {
+	Row &r = _rows.at(row);
+	if (r.rhs == rhs) {
+		return;
+	}
+	r.rhs = rhs;
+	_solved = false;
+#ifdef LPSOLVE
+	if (_solver) {
+		set_rh(_solver, row + 1, rhs);
+	}
+#endif
+}
+
+void
+LPModel::addComment(const string &comment) {
+	_comment += "/* " + comment + " */\n";
+}
+
+/**
+ * Writes the terms of a row or the objective, coefficients of 1 and -1
+ * are left out
+ */
+static void
+write_terms(ostream &out, const LPModel &lp, const map<int, double> &terms) {
+	bool first = true;
+	map<int, double>::const_iterator it;
+	for (it = terms.begin(); it != terms.end(); ++it) {
+		double coef = it->second;
+		if (coef == 0) {
+			continue;
+		}
+		if (!first) {
+			out << (coef < 0 ? " - " : " + ");
+		} else if (coef < 0) {
+			out << "-";
+		}
+		if (coef != 1 && coef != -1) {
+			out << (coef < 0 ? -coef : coef) << " ";
+		}
+		out << lp.getName(it->first);
+		first = false;
+	}
+}
+
+void
+LPModel::write(ostream &out) const {
+	out.precision(17);
+	out << "max: ";
+	write_terms(out, *this, _obj);
+	out << ";" << endl;
+
+	for (size_t i = 0; i < _rows.size(); i++) {
+		const Row &row = _rows[i];
+		out << row.comment;
+
+		int nterms = 0;
+		map<int, double>::const_iterator it;
+		for (it = row.terms.begin(); it != row.terms.end(); ++it) {
+			nterms += it->second != 0;
+		}
+		out << "\t";
+		if (nterms <= 1) {
+			/* A bound otherwise */
+			out << "R" << i + 1 << ": ";
+		}
+		if (nterms == 0) {
+			/* Keeps the row, the format needs a variable */
+			out << "0 " << getName(0);
+		}
+		write_terms(out, *this, row.terms);
+		switch (row.op) {
+		case AT_MOST:
+			out << " <= ";
+			break;
+		case AT_LEAST:
+			out << " >= ";
+			break;
+		case EXACTLY:
+			out << " = ";
+			break;
+		}
+		out << row.rhs << ";" << endl;
+	}
+	out << _comment;
+
+	bool first = true;
+	for (int col = 0; col < countVars(); col++) {
+		if (!_binary[col]) {
+			continue;
+		}
+		out << (first ? "\nbin " : ",\n\t") << getName(col);
+		first = false;
+	}
+	if (!first) {
+		out << ";" << endl;
+	}
+}
+
+void
+LPModel::write(const string &path) const {
+	ofstream out(path.c_str());
+	if (!out) {
+		throw runtime_error("LPModel::write Cannot open " + path);
+	}
+	write(out);
+	out.close();
+}
+
+#ifdef LPSOLVE
+void
+LPModel::build() {
+	int ncols = countVars();
+	_solver = make_lp(0, ncols);
+	if (_solver == NULL) {
+		throw runtime_error("LPModel::solve Cannot create the model");
+	}
+	set_verbose(_solver, NEUTRAL);
+
+	/* lp_solve numbers the columns from 1 */
+	vector<int> colno;
+	vector<REAL> coefs;
+	map<int, double>::const_iterator it;
+	for (it = _obj.begin(); it != _obj.end(); ++it) {
+		colno.push_back(it->first + 1);
+		coefs.push_back(it->second);
+	}
+	set_obj_fnex(_solver, colno.size(), coefs.data(), colno.data());
+	set_maxim(_solver);
+
+	set_add_rowmode(_solver, TRUE);
+	for (size_t i = 0; i < _rows.size(); i++) {
+		const Row &row = _rows[i];
+		colno.clear();
+		coefs.clear();
+		for (it = row.terms.begin(); it != row.terms.end(); ++it) {
+			colno.push_back(it->first + 1);
+			coefs.push_back(it->second);
+		}
+		int type = EQ;
+		if (row.op == AT_MOST) {
+			type = LE;
+		} else if (row.op == AT_LEAST) {
+			type = GE;
+		}
+		add_constraintex(_solver, colno.size(), coefs.data(),
+				 colno.data(), type, row.rhs);
+	}
+	set_add_rowmode(_solver, FALSE);
+	for (int col = 0; col < ncols; col++) {
+		if (_binary[col]) {
+			set_binary(_solver, col + 1, TRUE);
+		}
+	}
+}
+
+void
+LPModel::drop() {
+	if (_solver) {
+		delete_lp(_solver);
+		_solver = NULL;
+	}
+	_solved = false;
+}
+
+void
+LPModel::solve() {
+	if (!_solver) {
+		build();
+	}
+	/* A kept model starts from the basis of its last solve */
+	int ret = ::solve(_solver);
+	if (ret != OPTIMAL) {
+		stringstream ss;
+		ss << "LPModel::solve No optimal solution (lp_solve " << ret
+		   << ")";
+		throw runtime_error(ss.str());
+	}
+	_objective = get_objective(_solver);
+	_values.assign(countVars(), 0);
+	get_variables(_solver, _values.data());
+	_solved = true;
+}
+#else
+void
+LPModel::build() {
+}
+
+void
+LPModel::drop() {
+	_solved = false;
+}
+
+void
+LPModel::solve() {
+	throw runtime_error("LPModel::solve Built without lp_solve (LPSOLVE)");
+}
+#endif
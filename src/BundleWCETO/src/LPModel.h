@@ -0,0 +1,147 @@
+#ifndef LPMODEL_H
+#define LPMODEL_H
+
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+/* The lp_solve model, see lp_lib.h */
+struct _lprec;
+
+/**
+ * @class LPModel
+ *
+ * A (mixed integer) linear program kept in memory.
+ *
+ * Variables are columns numbered from 0 in the order they are added,
+ * constraints are sparse rows of (column, coefficient) terms with a
+ * constant right hand side. Every variable is bounded below by 0,
+ * binary variables also above by 1.
+ *
+ * The model is solved in process with the lp_solve library when built
+ * with LPSOLVE, write() dumps it in the lp_solve text format for
+ * solving or inspecting it separately. Names and comments are only
+ * used by the dump, unnamed columns are written as x<column>.
+ *
+ * The solver keeps its copy of the model between solves. Changing
+ * coefficients and right hand sides with setTerm() and setRhs() only
+ * updates that copy, and the next solve starts from the previous
+ * basis. Adding variables, rows or terms rebuilds it.
+ *
+ * Usage:
+ *   LPModel lp;
+ *   int x = lp.addVar(), y = lp.addVar(true);
+ *   lp.addObjective(x, 1);
+ *   int row = lp.addRow(LPModel::AT_MOST, 4);
+ *   lp.addTerm(row, x, 1);
+ *   lp.addTerm(row, y, -2);
+ *   lp.solve();
+ *   lp.objective();
+ */
+class LPModel {
+public:
+	/* Not LE, GE and EQ, lp_solve defines those as macros */
+	typedef enum {
+		AT_MOST,
+		AT_LEAST,
+		EXACTLY
+	} op_t;
+
+	LPModel() : _solved(false), _objective(0), _solver(NULL) {}
+	~LPModel();
+	/* Removes every variable and row */
+	void clear();
+
+	/**
+	 * Adds a variable
+	 *
+	 * @param[in] binary true if the variable is 0 or 1
+	 *
+	 * @return the column of the variable
+	 */
+	int addVar(bool binary=false);
+	int countVars() const { return _binary.size(); }
+	bool isBinary(int col) const { return _binary[col]; }
+	/* Names the column in the dump */
+	void setName(int col, const string &name);
+	string getName(int col) const;
+
+	/* Adds coef * col to the maximized objective */
+	void addObjective(int col, double coef);
+
+	/**
+	 * Adds a constraint, sum of its terms <op> rhs
+	 *
+	 * @param[in] comment written before the row by the dump
+	 *
+	 * @return the index of the row
+	 */
+	int addRow(op_t op, double rhs, const string &comment="");
+	int countRows() const { return _rows.size(); }
+	/**
+	 * Adds coef * col to a row, the coefficients of a column added
+	 * more than once are summed
+	 */
+	void addTerm(int row, int col, double coef);
+	/* Writes a comment before the next row */
+	void addComment(const string &comment);
+	/* Replaces the coefficient of a column in a row */
+	void setTerm(int row, int col, double coef);
+	double getTerm(int row, int col) const;
+	void setRhs(int row, double rhs);
+	double getRhs(int row) const { return _rows.at(row).rhs; }
+
+	/**
+	 * Dumps the model in the lp_solve LP format
+	 *
+	 * Rows of a single variable are named so they are read as
+	 * constraints rather than bounds.
+	 */
+	void write(const string &path) const;
+	void write(ostream &out) const;
+
+	/**
+	 * Solves the model, throws if it has no optimal solution or
+	 * lp_solve is not built in (see LPSOLVE)
+	 */
+	void solve();
+	bool isSolved() const { return _solved; }
+	/* The optimal objective, only valid after solve() */
+	double objective() const { return _objective; }
+	/* The value of a column in the optimal solution */
+	double value(int col) const { return _values[col]; }
+private:
+	struct Row {
+		op_t op;
+		double rhs;
+		/* Column -> coefficient, sorted by column */
+		map<int, double> terms;
+		/* Comment lines written before the row */
+		string comment;
+	};
+
+	vector<bool> _binary;
+	/* Only the named columns */
+	map<int, string> _names;
+	map<int, double> _obj;
+	vector<Row> _rows;
+	/* Comment lines not yet written before a row */
+	string _comment;
+
+	bool _solved;
+	double _objective;
+	vector<double> _values;
+	/* The solver's copy of the model, NULL until solved */
+	_lprec *_solver;
+
+	/* Owns the solver, not copied */
+	LPModel(const LPModel &other);
+	LPModel& operator=(const LPModel &other);
+	/* Builds the solver's copy of the model */
+	void build();
+	/* Drops the solver's copy after a change to the structure */
+	void drop();
+};
+
+#endif /* LPMODEL_H */
@@ -0,0 +1,163 @@
+#ifndef LONGESTPATH_H
+#define LONGESTPATH_H
+
+#include <lemon/core.h>
+#include <lemon/list_graph.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+using namespace std;
+using namespace lemon;
+
+/**
+ * Topological order and longest paths of a graph with its loop back
+ * arcs removed.
+ *
+ * Works on any graph with LEMON style iterators and ids, a ListDigraph
+ * (a CFG or a CFRG, see LongestPath) or a CFR. The order is the reverse
+ * depth first finish order from the source, as CFGDFS and CFRGDFS
+ * would search it. An arc whose target
+ * does not come after its source in that order is a back arc and is
+ * ignored by the longest path. Nodes not reachable from the source
+ * are not ordered and have a distance of 0.
+ *
+ * Both the search and the longest path are linear in the size of the
+ * graph, the results are kept until the next call to run().
+ *
+ * Usage:
+ *   LongestPath lp(cfg);
+ *   lp.run(cfg.getInitial());
+ *   lp.order();   -- nodes in topological order
+ *   lp.maxDist(); -- nodes on the longest path
+ */
+template <typename GR>
+class LongestPathT {
+public:
+	typedef typename GR::Node Node;
+	typedef typename GR::Arc Arc;
+
+	LongestPathT(const GR &graph) : _graph(graph), _max(0) {}
+	/**
+	 * Orders the graph and finds the longest paths from the source
+	 *
+	 * @param[in] source the node the search starts from
+	 * @param[in] weight the length each node adds to a path
+	 */
+	void run(Node source, int weight=1);
+	/**
+	 * The reachable nodes in topological order
+	 */
+	const vector<Node>& order() const { return _order; }
+	/**
+	 * The index of a node in order(), -1 if it is not reachable
+	 */
+	int position(Node node) const {
+		int id = _graph.id(node);
+		return id >= 0 && id < (int) _pos.size() ? _pos[id] : -1;
+	}
+	/**
+	 * True if the arc does not go forward in order()
+	 */
+	bool isBack(Arc arc) const {
+		int src = position(_graph.source(arc));
+		int tgt = position(_graph.target(arc));
+		return src < 0 || tgt <= src;
+	}
+	/**
+	 * The length of the longest path from the source to (and
+	 * including) the node
+	 */
+	int dist(Node node) const {
+		int id = _graph.id(node);
+		return id >= 0 && id < (int) _dist.size() ? _dist[id] : 0;
+	}
+	/**
+	 * The length of the longest path from the source
+	 */
+	int maxDist() const { return _max; }
+private:
+	const GR &_graph;
+	vector<Node> _order;
+	/* Indexed by node id */
+	vector<int> _pos;
+	vector<int> _dist;
+	int _max;
+
+	void search(Node source);
+};
+
+/**
+ * Depth first search recording the finish order.
+ *
+ * Successors are taken in arc order, so the finish order is the one
+ * the recursive CFGDFS and CFRGDFS searches give. The explicit stack
+ * keeps deep graphs from exhausting the call stack.
+ */
+template <typename GR>
+void
+LongestPathT<GR>::search(Node source) {
+	typedef typename GR::OutArcIt OutArcIt;
+	vector<bool> visited(_pos.size(), false);
+	vector<pair<Node, OutArcIt> > stk;
+
+	visited[_graph.id(source)] = true;
+	stk.push_back(make_pair(source, OutArcIt(_graph, source)));
+	while (!stk.empty()) {
+		OutArcIt &ait = stk.back().second;
+		if (ait == INVALID) {
+			_order.push_back(stk.back().first);
+			stk.pop_back();
+			continue;
+		}
+		Node succ = _graph.target(ait);
+		++ait;
+		if (!visited[_graph.id(succ)]) {
+			visited[_graph.id(succ)] = true;
+			stk.push_back(make_pair(succ, OutArcIt(_graph, succ)));
+		}
+	}
+	/* Descending finish time */
+	reverse(_order.begin(), _order.end());
+}
+
+template <typename GR>
+void
+LongestPathT<GR>::run(Node source, int weight) {
+	_order.clear();
+	_pos.assign(_graph.maxNodeId() + 1, -1);
+	_dist.assign(_graph.maxNodeId() + 1, 0);
+	_max = 0;
+	if (source == INVALID) {
+		return;
+	}
+
+	search(source);
+	for (size_t i = 0; i < _order.size(); i++) {
+		_pos[_graph.id(_order[i])] = i;
+	}
+
+	for (size_t i = 0; i < _order.size(); i++) {
+		Node node = _order[i];
+		int max = 0;
+		typename GR::InArcIt ait(_graph, node);
+		for ( ; ait != INVALID; ++ait) {
+			if (isBack(ait)) {
+				continue;
+			}
+			int d = _dist[_graph.id(_graph.source(ait))];
+			if (d > max) {
+				max = d;
+			}
+		}
+		_dist[_graph.id(node)] = max + weight;
+		if (max + weight > _max) {
+			_max = max + weight;
+		}
+	}
+}
+
+/* Orders a CFG or a CFRG */
+typedef LongestPathT<ListDigraph> LongestPath;
+
+#endif /* LONGESTPATH_H */
@@ -0,0 +1,79 @@
+#include "SummaryFactory.h"
+#include "WCETOFactory.h"
+
+#include <stdexcept>
+
+void
+SummaryFactory::produce() {
+	_summaries.clear();
+	set<ListDigraph::Node> active;
+	CFRFactory cfr_fact(_cfg, _cache, _log_pfx + "fn-");
+	cfr_fact.setSummaries(&_summaries);
+	list<ListDigraph::Node> sites = calls(_cfg.getInitial());
+	list<ListDigraph::Node>::iterator it;
+	for (it = sites.begin(); it != sites.end(); ++it) {
+		summarize(_cfg.getCallee(*it), active, cfr_fact);
+	}
+}
+
+void
+SummaryFactory::summarize(ListDigraph::Node entry,
+			  set<ListDigraph::Node> &active, CFRFactory &cfr_fact) {
+	if (_summaries.find(entry) != _summaries.end()) {
+		return;
+	}
+	if (active.count(entry) > 0) {
+		throw runtime_error("Recursive call to "
+				    + _cfg.stringNode(entry));
+	}
+	active.insert(entry);
+	list<ListDigraph::Node> sites = calls(entry);
+	list<ListDigraph::Node>::iterator it;
+	for (it = sites.begin(); it != sites.end(); ++it) {
+		summarize(_cfg.getCallee(*it), active, cfr_fact);
+	}
+	active.erase(entry);
+
+	cfr_fact.reset(_log_pfx + "fn" + _cfg.stringAddr(entry) + "-");
+	cfr_fact.setEntry(entry);
+	cfr_fact.produce();
+	CFRG *cfrg = cfr_fact.getCFRG();
+	cfrg->order();
+
+	WCETOFactory wceto_fact(*cfrg, 1, _ctx_cost);
+	wceto_fact.produce();
+
+	CallSummary summary;
+	summary.wceto = wceto_fact.value(cfrg->findCFR(cfrg->getTerminal()));
+	summary.ecbs = ECBs(_cache.getSets());
+	for (ListDigraph::NodeIt nit(*cfrg); nit != INVALID; ++nit) {
+		CFR *cfr = cfrg->findCFR(nit);
+		cfr->calcECBs();
+		ECBs *ecbs = cfr->getECBs();
+		summary.ecbs.merge(*ecbs);
+		delete ecbs;
+	}
+	_summaries[entry] = summary;
+}
+
+list<ListDigraph::Node>
+SummaryFactory::calls(ListDigraph::Node entry) {
+	list<ListDigraph::Node> sites, nexts;
+	/* Only the function's instructions, not a map of the whole CFG */
+	set<ListDigraph::Node> visited;
+	nexts.push_back(entry);
+	visited.insert(entry);
+	while (!nexts.empty()) {
+		ListDigraph::Node cur = nexts.front(); nexts.pop_front();
+		if (_cfg.getCallee(cur) != INVALID) {
+			sites.push_back(cur);
+		}
+		for (ListDigraph::OutArcIt a(_cfg, cur); a != INVALID; ++a) {
+			ListDigraph::Node succ = _cfg.runningNode(a);
+			if (visited.insert(succ).second) {
+				nexts.push_back(succ);
+			}
+		}
+	}
+	return sites;
+}
@@ -0,0 +1,66 @@
+#ifndef SUMMARY_FACTORY_H
+#define SUMMARY_FACTORY_H
+
+#include "CFG.h"
+#include "CFGMap.h"
+#include "CFRFactory.h"
+
+#include <list>
+#include <set>
+#include <string>
+using namespace std;
+
+/**
+ * Summarizes the functions of a CFG with shared functions (see
+ * CFG::isShared) for their callers.
+ *
+ * Each function is analyzed once, after the functions it calls, on
+ * CFRs and a CFRG of its own. Its summary is the WCETO of a single
+ * thread through it and the ECBs of its CFRs.
+ *
+ * A caller charges every thread the single thread WCETO, as if each
+ * thread ran the function with a cold cache, and loads the ECBs of the
+ * function with the calling CFR. The instruction returned to begins a
+ * new CFR. What the threads would have shared inside the function is
+ * given up for a graph the size of the code.
+ *
+ * The functions are divided into CFRs by one CFRFactory, reset for
+ * each, its log files are named <log_pfx>fn<entry address>-.
+ *
+ * Usage:
+ *   SummaryFactory sums(cfg, cache, bundle_ctx);
+ *   sums.produce();
+ *   CFRFactory cfr_fact(cfg, cache);
+ *   cfr_fact.setSummaries(&sums.summaries());
+ */
+class SummaryFactory {
+public:
+	/**
+	 * @param[in] ctx_cost the cycles of a context switch
+	 * @param[in] log_pfx prefix of the log file names
+	 */
+	SummaryFactory(const CFG &cfg, Cache &cache, uint32_t ctx_cost,
+		       string log_pfx="") : _cfg(cfg), _cache(cache),
+		_ctx_cost(ctx_cost), _log_pfx(log_pfx) {}
+	/**
+	 * Summarizes every function called from the initial instruction
+	 *
+	 * @throws runtime_error if a function calls itself
+	 */
+	void produce();
+	const CallSummaries& summaries() const { return _summaries; }
+private:
+	const CFG &_cfg;
+	Cache &_cache;
+	uint32_t _ctx_cost;
+	string _log_pfx;
+	CallSummaries _summaries;
+
+	/* Summarizes the function beginning at entry, callees first */
+	void summarize(ListDigraph::Node entry,
+		       set<ListDigraph::Node> &active, CFRFactory &cfr_fact);
+	/* The call instructions of the function beginning at entry */
+	list<ListDigraph::Node> calls(ListDigraph::Node entry);
+};
+
+#endif /* SUMMARY_FACTORY_H */
@@ -0,0 +1,160 @@
+#include "SweepFactory.h"
+#include "CFRFactory.h"
+#include "SummaryFactory.h"
+#include "WCETOFactory.h"
+#include "JobPool.h"
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/* True if value is a power of two */
+static bool
+pow2(uint32_t value) {
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+Geometry::Geometry(string spec, uint32_t hit_latency) {
+	vector<uint32_t> fields;
+	stringstream ss(spec);
+	string field;
+	while (getline(ss, field, 'x')) {
+		size_t pos = 0;
+		unsigned long value = 0;
+		try {
+			/* stoul takes a sign and leading blanks, digits only */
+			if (field.size() > 0 && isdigit(field[0])) {
+				value = stoul(field, &pos);
+			}
+		} catch (logic_error &e) {
+			pos = 0;
+		}
+		if (pos == 0 || pos != field.size() || value == 0 ||
+		    value > UINT32_MAX) {
+			throw runtime_error("Invalid cache geometry: " + spec);
+		}
+		fields.push_back(value);
+	}
+	/* getline drops an empty last field */
+	if ((fields.size() != 4 && fields.size() != 5) ||
+	    spec[spec.size() - 1] == 'x') {
+		throw runtime_error("Invalid cache geometry: " + spec);
+	}
+	sets = fields[0];
+	ways = fields[1];
+	line_size = fields[2];
+	mem_latency = fields[3];
+	latency = fields.size() == 5 ? fields[4] : hit_latency;
+
+	/* Addresses are split into tag, set and offset bits */
+	if (!pow2(sets)) {
+		throw runtime_error("Invalid cache geometry: " + spec +
+				    ", the set count is not a power of two");
+	}
+	if (!pow2(line_size)) {
+		throw runtime_error("Invalid cache geometry: " + spec +
+				    ", the line size is not a power of two");
+	}
+	if (ways > CacheSet::MAX_WAYS) {
+		throw runtime_error("Invalid cache geometry: " + spec +
+				    ", at most 64 ways are supported");
+	}
+	if (latency == 0) {
+		throw runtime_error("Invalid cache geometry: " + spec +
+				    ", the hit latency is 0");
+	}
+}
+
+string
+Geometry::str() const {
+	stringstream ss;
+	ss << sets << "x" << ways << "x" << line_size << "x" << mem_latency
+	   << "x" << latency;
+	return ss.str();
+}
+
+void
+SweepFactory::readGeometries(string path, uint32_t latency) {
+	ifstream ifile(path.c_str());
+	if (!ifile) {
+		throw runtime_error("Could not open " + path);
+	}
+	string line;
+	while (getline(ifile, line)) {
+		stringstream ss(line);
+		string spec;
+		if (!(ss >> spec) || spec[0] == '#') {
+			continue;
+		}
+		addGeometry(Geometry(spec, latency));
+	}
+}
+
+void
+SweepFactory::analyze(Geometry &geom, string log_pfx) {
+	Cache cache(geom.sets, geom.ways, geom.line_size, geom.latency,
+		    geom.mem_latency, &_lru);
+
+	SummaryFactory summaries(_cfg, cache, _bundle_ctx, log_pfx);
+	if (_cfg.isShared()) {
+		summaries.produce();
+	}
+	CFRFactory cfr_fact(_cfg, cache, log_pfx);
+	cfr_fact.setSummaries(&summaries.summaries());
+	cfr_fact.produce();
+	CFRG *cfrg = cfr_fact.getCFRG();
+	cfrg->order();
+
+	/* Jobs not taken by other geometries go to the WCETO calculation */
+	unsigned int wceto_jobs = 1;
+	if (_geoms.size() > 0 && _geoms.size() < _jobs) {
+		wceto_jobs = _jobs / _geoms.size();
+	}
+
+	CFR *terminal = cfrg->findCFR(cfrg->getTerminal());
+	geom.wceto.clear();
+	for (uint32_t m = _lo_threads; m <= _hi_threads; m++) {
+		WCETOFactory wceto_fact(*cfrg, m, _bundle_ctx);
+		wceto_fact.setJobs(wceto_jobs);
+		wceto_fact.produce();
+		geom.wceto[m] = wceto_fact.value(terminal);
+	}
+}
+
+void
+SweepFactory::produce() {
+	JobPool pool(_jobs);
+	for (size_t i=0; i < _geoms.size(); i++) {
+		Geometry &geom = _geoms[i];
+		/* Concurrent analyses may not share log files */
+		string log_pfx;
+		if (_jobs > 1) {
+			log_pfx = "sweep-" + geom.str() + "-";
+		}
+		pool.add([this, &geom, log_pfx](ostream &out) {
+			out << "BWCETO> Geometry " << geom.str() << endl;
+			analyze(geom, log_pfx);
+		});
+	}
+	pool.run(cout);
+
+	vector<Geometry>::iterator git;
+
+	ofstream ofile(_path.c_str());
+	if (!ofile) {
+		throw runtime_error("Could not open " + _path);
+	}
+	ofile << "sets,ways,line_size,mem_latency,latency,threads,wceto"
+	      << endl;
+	for (git = _geoms.begin(); git != _geoms.end(); ++git) {
+		map<uint32_t, uint32_t>::iterator wit;
+		for (wit = git->wceto.begin(); wit != git->wceto.end(); ++wit) {
+			ofile << git->sets << "," << git->ways << ","
+			      << git->line_size << "," << git->mem_latency << ","
+			      << git->latency << "," << wit->first << ","
+			      << wit->second << endl;
+		}
+	}
+	ofile.close();
+}
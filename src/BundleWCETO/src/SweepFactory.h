@@ -0,0 +1,101 @@
+#ifndef SWEEP_FACTORY_H
+#define SWEEP_FACTORY_H
+
+#include "CFG.h"
+#include "Cache.h"
+#include "PolicyLRU.h"
+
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+/**
+ * A single level instruction cache geometry, and the WCETO values
+ * calculated for it.
+ */
+class Geometry {
+public:
+	Geometry() : sets(0), ways(0), line_size(0), mem_latency(0),
+		latency(1) {}
+	/**
+	 * Parses a geometry of the form
+	 *   <sets>x<ways>x<line size>x<memory latency>[x<hit latency>]
+	 *
+	 * @param[in] spec the geometry
+	 * @param[in] latency the hit latency when the spec has none
+	 *
+	 * @throws runtime_error if the spec is malformed, the set count
+	 *   or the line size is not a power of two, or there are more
+	 *   ways than a CacheSet holds
+	 */
+	Geometry(string spec, uint32_t latency=1);
+	string str() const;
+
+	uint32_t sets, ways, line_size, mem_latency, latency;
+	/* Thread count -> WCETO, filled in by the SweepFactory */
+	map<uint32_t, uint32_t> wceto;
+};
+
+/**
+ * Calculates the WCETO of one CFG for many cache geometries and
+ * thread counts, writing a single CSV table.
+ *
+ * Usage:
+ *   SweepFactory sweep(cfg, bundle_ctx);
+ *   sweep.setThreads(1, 16);
+ *   sweep.addGeometry(Geometry("8x1x32x100"));
+ *   sweep.setPath("alpha-sweep.csv");
+ *   sweep.produce();
+ */
+class SweepFactory {
+public:
+	SweepFactory(const CFG &cfg, uint32_t bundle_ctx) : _cfg(cfg),
+		_bundle_ctx(bundle_ctx), _lo_threads(1), _hi_threads(1),
+		_jobs(1) {}
+	/**
+	 * Sets the (inclusive) range of thread counts to analyze
+	 */
+	void setThreads(uint32_t lo, uint32_t hi) {
+		_lo_threads = lo;
+		_hi_threads = hi;
+	}
+	/**
+	 * Sets the number of geometries analyzed at the same time
+	 */
+	void setJobs(unsigned int jobs) { _jobs = jobs; }
+	void setPath(string path) { _path = path; }
+	string getPath() { return _path; }
+
+	void addGeometry(const Geometry &geom) {
+		_geoms.push_back(geom);
+	}
+	/**
+	 * Adds the geometries in a file, one per line. Blank lines
+	 * and lines beginning with # are ignored.
+	 *
+	 * @param[in] latency the hit latency of geometries without one
+	 */
+	void readGeometries(string path, uint32_t latency=1);
+	vector<Geometry>& geometries() { return _geoms; }
+
+	/**
+	 * Analyzes every geometry and writes the table
+	 */
+	void produce();
+	/**
+	 * Analyzes a single geometry, filling in its WCETO values
+	 *
+	 * @param[in|out] geom the geometry
+	 * @param[in] log_pfx prefix of the log files
+	 */
+	void analyze(Geometry &geom, string log_pfx="");
+private:
+	const CFG &_cfg;
+	uint32_t _bundle_ctx, _lo_threads, _hi_threads, _jobs;
+	string _path;
+	vector<Geometry> _geoms;
+	PolicyLRU _lru;
+};
+
+#endif /* SWEEP_FACTORY_H */
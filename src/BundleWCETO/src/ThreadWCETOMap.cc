@@ -8,49 +8,39 @@ operator<<(std::ostream& stream, const ThreadWCETOMap& twmap) {
 
 uint32_t
 ThreadWCETOMap::wceto(uint32_t thread) {
-	ThreadWCETOMap::iterator twit;
 	uint32_t wceto = 0;
-	for(twit = begin(); twit != end(); ++twit) {
-		wceto += twit->second;
+	size_t n = min((size_t) thread + 1, _wceto.size());
+	for (size_t i = 0; i < n; i++) {
+		wceto += _wceto[i];
 	}
 	return wceto;
-	
 }
 
 bool
 ThreadWCETOMap::fill(CFR *cfr, uint32_t threads) {
-	insert(pair<uint32_t, uint32_t>(0, 0));
+	_wceto.assign(threads + 1, 0);
 	for (uint32_t i=1; i <= threads; i++) {
-		uint32_t wceto = cfr->wceto(i) - cfr->wceto(i -1);
-		insert(pair<uint32_t, uint32_t>(i, wceto));
+		_wceto[i] = cfr->wceto(i) - cfr->wceto(i -1);
 	}
 	return true;
 }
 
 bool
 ThreadWCETOMap::fill(ThreadWCETOMap& src) {
-	clear();
-	ThreadWCETOMap::iterator tit;
-	for (tit = src.begin(); tit != src.end(); ++tit) {
-		insert(make_pair(tit->first, tit->second));
-	}
+	_wceto = src._wceto;
 	return true;
 }
 
 bool
 ThreadWCETOMap::fillExe(CFR *cfr, uint32_t threads) {
-	clear();
-	insert(pair<uint32_t, uint32_t>(0, 0));
-	for (uint32_t i=1; i <= threads; i++) {
-		insert(pair<uint32_t, uint32_t>(i, cfr->exeCost()));
-	}
+	_wceto.assign(threads + 1, cfr->exeCost());
+	_wceto[0] = 0;
 	return true;
 }
 
 string
 ThreadWCETOMap::str(string pfx) const {
 	stringstream ss;
-	ThreadWCETOMap::const_iterator twit;
 	int nthreads=0;
 	if (empty()) {
 		return "";
@@ -58,24 +48,9 @@ ThreadWCETOMap::str(string pfx) const {
 		nthreads = size() - 1;
 	}
 	ss << pfx << "Thread\tWCETO";
-	for (twit = begin(); twit != end(); ++twit) {
-		uint32_t threads = twit->first;
-		uint32_t wceto = twit->second;
-		ss << endl << pfx << threads << "/" << nthreads << "\t" << wceto;
+	for (size_t threads = 0; threads < _wceto.size(); threads++) {
+		ss << endl << pfx << threads << "/" << nthreads << "\t"
+		   << _wceto[threads];
 	}
 	return ss.str();
 }
-
-ThreadWCETOMap::ThreadWCETOMap(ThreadWCETOMap &src) {
-	ThreadWCETOMap::iterator twit;
-	for (twit = src.begin(); twit != src.end(); ++twit) {
-		insert(pair<uint32_t, uint32_t>(twit->first, twit->second));
-	}
-}
-
-ThreadWCETOMap::ThreadWCETOMap(ThreadWCETOMap *src) {
-	ThreadWCETOMap::iterator twit;
-	for (twit = src->begin(); twit != src->end(); ++twit) {
-		insert(pair<uint32_t, uint32_t>(twit->first, twit->second));
-	}
-}
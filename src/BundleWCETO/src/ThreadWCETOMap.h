@@ -2,7 +2,7 @@
 #define THREADWCETOMAP_H
 
 #include<limits.h>
-#include<map>
+#include<vector>
 #include<iostream>
 
 #include "CFR.h"
@@ -24,13 +24,34 @@ using namespace std;
  *
  * In concept, the value for thread n is the delta from thread n-1 to
  * thread n. 
+ *
+ * The values are kept in an array indexed by thread number.
  */
-class ThreadWCETOMap : public std::map<uint32_t, uint32_t> {
+class ThreadWCETOMap {
 public:
 	friend std::ostream &operator<<(std::ostream&, const ThreadWCETOMap&);
 	ThreadWCETOMap() {};
-	ThreadWCETOMap(ThreadWCETOMap &);
-	ThreadWCETOMap(ThreadWCETOMap *);	
+	ThreadWCETOMap(const ThreadWCETOMap &) = default;
+	ThreadWCETOMap(const ThreadWCETOMap *src) : _wceto(src->_wceto) {};
+	ThreadWCETOMap& operator=(const ThreadWCETOMap &) = default;
+	/**
+	 * The value for a thread, the map grows to include it
+	 */
+	uint32_t& operator[](uint32_t thread) {
+		if (thread >= _wceto.size()) {
+			_wceto.resize(thread + 1, 0);
+		}
+		return _wceto[thread];
+	}
+	/**
+	 * The value for a thread, 0 if the map does not include it
+	 */
+	uint32_t get(uint32_t thread) const {
+		return thread < _wceto.size() ? _wceto[thread] : 0;
+	}
+	size_t size() const { return _wceto.size(); }
+	bool empty() const { return _wceto.empty(); }
+	void clear() { _wceto.clear(); }
 	/**
 	 * Finds the cumulative WCETO for a given number of threads
 	 *
@@ -44,6 +65,8 @@ public:
 	bool fill(ThreadWCETOMap &src);
 	bool fillExe(CFR *cfr, uint32_t threads);
 	string str(string pfx="") const;
+private:
+	vector<uint32_t> _wceto;
 };
 
 #endif /* THREADWCETOMAP_H */
@@ -1,11 +1,13 @@
 #include "WCETOFactory.h"
 
+thread_local DBG WCETOFactory::dbg("wceto");
+
 /**
  * List First Search filter function
  *
  * Returning true indicates that the CFR can be passed to the test function.
  */
-#define dout fact->dbg.buf << fact->dbg.start
+#define dout DBG_OUT(fact->dbg, TRACE_DEBUG)
 static bool
 lfs_top_filter(CFRG &cfrg, CFR *cfr, void *userdata) {
 	WCETOFactory *fact = (WCETOFactory *) userdata;
@@ -18,19 +20,17 @@ lfs_top_filter(CFRG &cfrg, CFR *cfr, void *userdata) {
 	 */
 	ListDigraph::Node cfri = cfr->getInitial();
 	ListDigraph::Node cfgi = cfr->toCFG(cfri);
-	CFG *cfg = cfr->getCFG();
+	const CFG *cfg = cfr->getCFG();
 	if (cfg->getHead(cfgi) != INVALID) {
 		/*
 		 * Only those nodes that are loop heads, or do not
 		 * participate in a loop pass the filter
 		 */
-		fact->dbg.buf << "not ";
+		DBG_BUF(fact->dbg, TRACE_DEBUG) << "not ";
 		rv = false;
 	}
-	fact->dbg.buf << "pass the filter." << endl;
-	#ifdef DEBUG
-	fact->dbg.flush(cout);
-	#endif
+	DBG_BUF(fact->dbg, TRACE_DEBUG) << "pass the filter." << endl;
+	fact->dbg.flush(fact->trace);
 	fact->dbg.dec();
 	return rv;
 }
@@ -57,7 +57,7 @@ lfs_top_filter(CFRG &cfrg, CFR *cfr, void *userdata) {
 static bool
 lfs_top_test(CFRG &cfrg, CFR *cfr, void *userdata) {
 	WCETOFactory *fact = (WCETOFactory *) userdata;
-	#define dout fact->dbg.buf << fact->dbg.start
+	#define dout DBG_OUT(fact->dbg, TRACE_DEBUG)
 
 	ListDigraph::Node cfrgi = cfrg.findNode(cfr);
 	CFRDemandMap &loopt = fact->loop_table();
@@ -105,9 +105,7 @@ lfs_top_test(CFRG &cfrg, CFR *cfr, void *userdata) {
 		dout << *cfr << " is not ready." << endl;
 	}
 
-	#ifdef DEBUG
-	fact->dbg.flush(cout);
-	#endif
+	fact->dbg.flush(fact->trace);
 	/* change to return rv after the work portion has been
 	   completed */
 	return rv;
@@ -123,7 +121,7 @@ lfs_top_test(CFRG &cfrg, CFR *cfr, void *userdata) {
 static void
 lfs_top_work(CFRG &cfrg, CFR *cfr, void *userdata) {
 	WCETOFactory *fact = (WCETOFactory *) userdata;
-	#define dout fact->dbg.buf << fact->dbg.start
+	#define dout DBG_OUT(fact->dbg, TRACE_DEBUG)
 	fact->dbg.inc("WCETOFactory::lfs_top_work ");
 
 	ListDigraph::Node cfrgi = cfrg.findNode(cfr);
@@ -134,29 +132,44 @@ lfs_top_work(CFRG &cfrg, CFR *cfr, void *userdata) {
 		dout << *cfr << " is an independent CFR" << endl;
 		fact->inDemand(cfr);
 	}
-	#ifdef DEBUG
-	fact->dbg.flush(cout);
-	#endif 
+	fact->dbg.flush(fact->trace);
 	fact->dbg.dec();
 	#undef dout
 }
 
-#define dout dbg.buf << dbg.start
+#define dout DBG_OUT(dbg, TRACE_DEBUG)
 void
 WCETOFactory::produce() {
+	trace.open(_cfrg.getLogPrefix() + _log_name, "wceto", TRACE_DEBUG);
 	dbg.inc("WCETOFactory::produce ");
 
 	switchPass();
-	
+
+	if (_jobs > 1) {
+		/*
+		 * CFRs compute their ECBs and execution cost on first
+		 * use, do it now rather than from the workers
+		 */
+		for (ListDigraph::NodeIt nit(_cfrg); nit != INVALID; ++nit) {
+			CFR *cfr = _cfrg.findCFR(nit);
+			cfr->calcECBs();
+			cfr->exeCost();
+		}
+	}
+
+	/*
+	 * Independent CFRs and top level loops become ready once their
+	 * predecessors are done, and only write their own demand
+	 */
 	CFRGLFS lfs(_cfrg, lfs_top_filter, lfs_top_test, lfs_top_work,
 		    (void*) this);
+	lfs.setWorkers(_jobs);
 	CFR *initial = _cfrg.getInitialCFR();
 	lfs.search(initial);
 
 	dbg.dec();
-	#ifdef DEBUG
-	dbg.flush(cout);
-	#endif
+	dbg.flush(trace);
+	trace.close();
 }
 #undef dout
 
@@ -171,20 +184,18 @@ WCETOFactory::value(CFR *cfr) {
 	return wceto;
 }
 
-#define dout dbg.buf << dbg.start
+#define dout DBG_OUT(dbg, TRACE_DEBUG)
 CFRDemand *
 WCETOFactory::inDemand(CFR* cfr) {
 	dbg.inc("inDemand: ");
-	CFRDemand *cfrd = _cfrt.present(cfr);
-	if (cfrd) {
+	bool created;
+	CFRDemand *cfrd = _cfrt.request(cfr, created);
+	if (!created) {
 		dout << *cfr << " is present" << endl;
-		#ifdef DEBUG
-		dbg.flush(cout);
-		#endif
+		dbg.flush(trace);
 		dbg.dec();
 		return cfrd;
 	}
-	cfrd = _cfrt.request(cfr);
 
 	ThreadWCETOMap &twmap = cfrd->getWCETOMap();
 	twmap.fillExe(cfr, _threads);
@@ -204,7 +215,7 @@ WCETOFactory::inDemand(CFR* cfr) {
 
 	/* Consider predecessors */
 	CFRList *preds = _cfrg.preds(cfr);
-	CFRDemandMap scratch;
+	PredMaps pred_maps;
 	CFRList::iterator it;
 	dbg.inc("inDemand-preds: ");
 	for (it = preds->begin(); it != preds->end(); ++it) {
@@ -220,18 +231,15 @@ WCETOFactory::inDemand(CFR* cfr) {
 			/* Must exist in the cfr table */
 			pred_dmnd = _cfrt.present(pred_cfr);
 		}
-		scratch.insert(
-		    pair<CFR*, CFRDemand*>(pred_cfr, new CFRDemand(*pred_dmnd)));
+		pred_maps[pred_cfr] = &pred_dmnd->getWCETOMap();
 	}
 	dbg.dec();
-	maxMerge(*cfrd, scratch, true);
+	maxMerge(*cfrd, pred_maps, true);
 	dout << *cfr << " demand after merging: " << endl
 	     << cfrd->str(dbg.start) << endl;
 	delete preds;
 
-	#ifdef DEBUG
-	dbg.flush(cout);
-	#endif
+	dbg.flush(trace);
 	dbg.dec(); 
 	return cfrd;
 }
@@ -258,14 +266,12 @@ lfs_loop_filter(CFRG &cfrg, CFR *cfr, void *userdata) {
 	WCETOFactory &fact = data->fact;
 	CFR *head = data->head;
 
-	#define dout fact.dbg.buf << fact.dbg.start
+	#define dout DBG_OUT(fact.dbg, TRACE_DEBUG)
 	fact.dbg.inc("lfs_loop_filter: ");
 
 	if (head == cfr) {
 		dout << *cfr << " head is not filtered" << endl;
-		#ifdef DEBUG
-		fact.dbg.flush(cout);
-		#endif
+		fact.dbg.flush(fact.trace);
 		fact.dbg.dec();
 		return true;
 	}
@@ -281,9 +287,7 @@ lfs_loop_filter(CFRG &cfrg, CFR *cfr, void *userdata) {
 		dout << "rejected CFR " << *cfr << fact.dbg.cont
 		     << "head is not " << *head << endl;
 	}
-	#ifdef DEBUG
-	fact.dbg.flush(cout);
-	#endif
+	fact.dbg.flush(fact.trace);
 	fact.dbg.dec();
 	return rv;
 }
@@ -314,7 +318,7 @@ lfs_loop_test(CFRG &cfrg, CFR *cfr, void *userdata) {
 	CFR *head = data->head;
 	CFRDemandMap &scratch = data->scratch;
 
-	#define dout fact.dbg.buf << fact.dbg.start
+	#define dout DBG_OUT(fact.dbg, TRACE_DEBUG)
 	fact.dbg.inc("lfs_loop_test: ");
 	dout << "loop " << *head << endl;
 	dout << "CFR " << *cfr << endl;
@@ -322,9 +326,7 @@ lfs_loop_test(CFRG &cfrg, CFR *cfr, void *userdata) {
 	bool rv = true;
 	if (head == cfr) {
 		dout << "head element, all done" << endl;
-		#ifdef DEBUG
-		fact.dbg.flush(cout);
-		#endif
+		fact.dbg.flush(fact.trace);
 		fact.dbg.dec();
 		return rv;
 	}
@@ -370,9 +372,7 @@ lfs_loop_test(CFRG &cfrg, CFR *cfr, void *userdata) {
 	}
 
 	delete preds;
-	#ifdef DEBUG
-	fact.dbg.flush(cout);
-	#endif
+	fact.dbg.flush(fact.trace);
 	fact.dbg.dec();
 	return rv;
 }
@@ -385,16 +385,14 @@ lfs_loop_work(CFRG &cfrg, CFR *cfr, void *userdata) {
 	CFR *head = data->head;
 	CFRDemandMap &scratch = data->scratch;
 
-	#define dout fact.dbg.buf << fact.dbg.start
+	#define dout DBG_OUT(fact.dbg, TRACE_DEBUG)
 	fact.dbg.inc("lfs_loop_work: ");
 	dout << "loop " << *head << endl;
 	dout << "CFR " << *cfr << endl;
 
 	if (head == cfr) {
 		dout << "head element, all done" << endl;
-		#ifdef DEBUG
-		fact.dbg.flush(cout);
-		#endif
+		fact.dbg.flush(fact.trace);
 		fact.dbg.dec();
 		return;
 	}
@@ -452,9 +450,7 @@ lfs_loop_work(CFRG &cfrg, CFR *cfr, void *userdata) {
 
 	dout << "(work) Demand after merging predecessors: " << endl
 	     << dmnd->str(fact.dbg.start) << endl;
-	#ifdef DEBUG
-	fact.dbg.flush(cout);
-	#endif
+	fact.dbg.flush(fact.trace);
 	fact.dbg.dec();
 	#undef dout
 }
@@ -462,19 +458,17 @@ lfs_loop_work(CFRG &cfrg, CFR *cfr, void *userdata) {
 
 CFRDemand*
 WCETOFactory::loopDemand(CFR *cfr) {
-	#define dout dbg.buf << dbg.start
+	#define dout DBG_OUT(dbg, TRACE_DEBUG)
 	dbg.inc("loopDemand: ");
 	dout << "begin " << *cfr << endl;
-	CFRDemand *cfrd = _loopt.present(cfr);
-	if (cfrd) {
+	bool created;
+	CFRDemand *cfrd = _loopt.request(cfr, created);
+	if (!created) {
 		dout << *cfr << " is present, returning" << endl;
-		#ifdef DEBUG
-		dbg.flush(cout);
-		#endif
+		dbg.flush(trace);
 		dbg.dec();
 		return cfrd;
 	}
-	cfrd = _loopt.request(cfr);
 	cfrd->getWCETOMap().fillExe(cfr, _threads);
 	dout << *cfr << " Initial demand" << endl
 	     << cfrd->str(dbg.start) << endl;
@@ -514,7 +508,7 @@ WCETOFactory::loopDemand(CFR *cfr) {
 		}
 		CFRDemand *pdmnd = scratch.present(pred);
 		dbg.inc("loopDemand pred: ");
-		dbg.buf << pdmnd->str(dbg.start) << endl;
+		DBG_BUF(dbg, TRACE_DEBUG) << pdmnd->str(dbg.start) << endl;
 		/* Find the max WCET value */
 		if (pdmnd->getEXE() > wceto) {
 			wceto = pdmnd->getEXE();
@@ -568,6 +562,7 @@ WCETOFactory::loopDemand(CFR *cfr) {
 
 	/* Now it's time to use the predecessors to update our costs */
 	preds = _cfrg.preds(cfr);
+	PredMaps pred_maps;
 	for (CFRList::iterator it = preds->begin(); it != preds->end(); ++it) {
 		CFR *pred = *it;
 		if (_cfrg.inLoop(cfr, pred)) {
@@ -582,20 +577,17 @@ WCETOFactory::loopDemand(CFR *cfr) {
 			/* Must exist in the cfr table */
 			pdmnd = _cfrt.present(pred);
 		}
-		scratch.insert(
-		    pair<CFR*, CFRDemand*>(pred, new CFRDemand(*pdmnd)));
+		pred_maps[pred] = &pdmnd->getWCETOMap();
 	}
 	delete preds;
 
-	maxMerge(*cfrd, scratch, true);
+	maxMerge(*cfrd, pred_maps, true);
 	dout << "Demand after adding predecessors" << endl
 	     << cfrd->str(dbg.start) << endl;
 	
 	delete data;
 	dout << "end " << *cfr << endl;
-	#ifdef DEBUG
-	dbg.flush(cout);
-	#endif
+	dbg.flush(trace);
 	dbg.dec();
 	#undef dout
 	return cfrd;
@@ -615,30 +607,12 @@ WCETOFactory::getDemand(CFR *cfr) {
 
 uint32_t
 WCETOFactory::dupeCount(ECBs &ecbs) {
-	uint32_t rval = 0;
-	ECBs u(ecbs);
-
-	ecbs.sort();
-	u.unique();
-	u.sort();
-	ECBs::iterator eit = ecbs.begin();
-	for (ECBs::iterator uit = u.begin(); uit != u.end(); ++uit) {
-		uint32_t value = *uit;
-		uint32_t count = 0;
-		while (eit != ecbs.end() && value == *eit) {
-			count++;
-			eit++;
-		}
-		if (count > 1) {
-			rval += count;
-		}
-	}
-	return rval;
+	return ecbs.dupeCount();
 }
 
 void
-WCETOFactory::maxMerge(CFRDemand &dem, CFRDemandMap &map, bool includeLoad) {
-	#define dout dbg.buf << dbg.start
+WCETOFactory::maxMerge(CFRDemand &dem, PredMaps &preds, bool includeLoad) {
+	#define dout DBG_OUT(dbg, TRACE_DEBUG)
 	string pfx = "maxMerge (";
 	if (includeLoad) {
 		pfx += "exe+load): ";
@@ -646,64 +620,49 @@ WCETOFactory::maxMerge(CFRDemand &dem, CFRDemandMap &map, bool includeLoad) {
 		pfx += "exe): ";
 	}
 	dbg.inc(pfx);
-	dout << "Merging " << map.size() << " sets of demands" << endl;
-	if (map.size() == 0) {
-		#ifdef DEBUG
-		dbg.flush(cout);
-		#endif
+	dout << "Merging " << preds.size() << " sets of demands" << endl;
+	if (preds.size() == 0) {
+		dbg.flush(trace);
 		dbg.dec();
 		return;
 	}
 
+	/* next[k] is the first delta of the k-th predecessor not yet used */
+	vector<uint32_t> next(preds.size(), 1);
 	ThreadWCETOMap &twmap = dem.getWCETOMap();
 	for (uint32_t i = 1; i <= _threads; i++) {
-		CFRDemandMap::iterator it;
-		uint32_t max_idx=0, max_wceto=0;
-		ThreadWCETOMap *max_twmap=NULL;
-		for (it = map.begin(); it != map.end(); ++it) {
-			uint32_t t_idx=0, t_wceto=0;
-			ThreadWCETOMap &twmap = it->second->getWCETOMap();
-			t_wceto = maxEle(twmap, t_idx);
+		PredMaps::iterator it;
+		size_t k, max_k = preds.size();
+		uint32_t max_wceto = 0;
+		for (it = preds.begin(), k = 0; it != preds.end(); ++it, ++k) {
+			const ThreadWCETOMap &ptwmap = *it->second;
+			while (next[k] <= _threads && ptwmap.get(next[k]) == 0) {
+				next[k]++;
+			}
+			if (next[k] > _threads) {
+				continue;
+			}
+			uint32_t t_wceto = ptwmap.get(next[k]);
 			if (t_wceto > max_wceto) {
 				max_wceto = t_wceto;
-				max_idx = t_idx;
-				max_twmap = &twmap;
+				max_k = k;
 			}
 		}
-		(*max_twmap)[max_idx] = 0;
-		dem.getWCETOMap()[i] += max_wceto;
-	}
-	#ifdef DEBUG
-	dbg.flush(cout);
-	#endif
-	dbg.dec(); 
-	#undef dout
-}
-
-uint32_t
-WCETOFactory::maxEle(ThreadWCETOMap &twmap, uint32_t &idx) {
-	#define dout dbg.buf << dbg.start
-	dbg.inc("maxEle: ");
-	
-	uint32_t wceto=0;
-	for (idx = 1; idx <= _threads; idx++) {
-		wceto=twmap[idx];
-		if (twmap[idx] != 0) {
+		if (max_k == preds.size()) {
+			/* Every predecessor delta is used up */
 			break;
 		}
+		next[max_k]++;
+		twmap[i] += max_wceto;
 	}
-
-	#ifdef DEBUG
-	dbg.flush(cout);
-	#endif
+	dbg.flush(trace);
 	dbg.dec(); 
 	#undef dout
-	return wceto;
 }
 
 void
 WCETOFactory::dumpCFRs() {
-	#define dout dbg.buf << dbg.start
+	#define dout DBG_OUT(dbg, TRACE_DEBUG)
 	dbg.inc("dumpCFRs: ");
 
 	for (ListDigraph::NodeIt nit(_cfrg); nit != INVALID; ++nit) {
@@ -718,13 +677,11 @@ WCETOFactory::dumpCFRs() {
 		} else {
 			d = _cfrt.present(cfr);
 		}
-		dbg.buf << d->str(dbg.start) << endl;
+		DBG_BUF(dbg, TRACE_DEBUG) << d->str(dbg.start) << endl;
 		dbg.dec();
 	}
 
-	#ifdef DEBUG
-	dbg.flush(cout);
-	#endif
+	dbg.flush(trace);
 	dbg.dec(); 
 	#undef dout
 }
@@ -742,7 +699,7 @@ WCETOFactory::dumpCFRs() {
  * @return true if the CFR should be as switching CFR, false if it
  * should be pass through
  */
-#define dout dbg.buf << dbg.start
+#define dout DBG_OUT(dbg, TRACE_DEBUG)
 bool
 WCETOFactory::shouldSwitch(CFR *cfr) {
 	dbg.inc("shouldSwitch: " + cfr->str() + " " );
@@ -750,7 +707,6 @@ WCETOFactory::shouldSwitch(CFR *cfr) {
 
 	uint32_t B = cfr->getCache()->memLatency();
 	ECBs *ecbs = cfr->getECBs();
-	ecbs->sort();
 	
 	CFRList *preds = _cfrg.preds(cfr);
 	if (preds->size() == 0) {
@@ -770,7 +726,6 @@ WCETOFactory::shouldSwitch(CFR *cfr) {
 		/* Merge the ECBs */
 		ECBs u(*ecbs);
 		ECBs *others = pred_cfr->getECBs();
-		others->sort();
 		u.merge(*others);
 		delete others;
 
@@ -811,7 +766,7 @@ public:
  * pass through region
  */
 #undef dout
-#define dout fact.dbg.buf << fact.dbg.start
+#define dout DBG_OUT(fact.dbg, TRACE_DEBUG)
 static bool
 dfs_mask(CFRG &cfrg, CFR *cfr, void *userdata) {
 	DFSData *data = (DFSData *) userdata;
@@ -840,9 +795,7 @@ dfs_mask(CFRG &cfrg, CFR *cfr, void *userdata) {
 	}
 	dout << *cfr << " END (" << rv << ")" << endl;
 	fact.dbg.dec();
-	#ifdef DEBUG
-	fact.dbg.flush(cout);
-	#endif
+	fact.dbg.flush(fact.trace);
 	return rv;
 }
 
@@ -915,15 +868,21 @@ dfs_fin(CFRG &cfrg, CFR *cfr, void *userdata) {
 #undef dout
 
 
-#define dout dbg.buf << dbg.start
+#define dout DBG_OUT(dbg, TRACE_DEBUG)
 void
 WCETOFactory::switchPass() {
 	dbg.inc("switchPass: ");
 
-	CFRGTopSort tops(_cfrg);
-	tops.sort(_cfrg.getInitial());
-	pqueue_t::iterator pit;
-	for (pit = tops.result.begin(); pit != tops.result.end(); ++pit) {
+	/* Start from all switching, a CFRG may be reused for other
+	   thread counts */
+	for (ListDigraph::NodeIt nit(_cfrg); nit != INVALID; ++nit) {
+		_cfrg.findCFR(nit)->setSwitching(true);
+	}
+
+	LongestPath tops(_cfrg);
+	tops.run(_cfrg.getInitial());
+	vector<ListDigraph::Node>::const_iterator pit;
+	for (pit = tops.order().begin(); pit != tops.order().end(); ++pit) {
 		ListDigraph::Node node = *pit;
 		CFR *cfr = _cfrg.findCFR(node);
 		if (_cfrg.isLoopPart(node)) {
@@ -949,9 +908,7 @@ WCETOFactory::switchPass() {
 	
 	
 	dbg.dec();
-	#ifdef DEBUG
-	dbg.flush(cout);
-	#endif
+	dbg.flush(trace);
 }
 
 #undef dout
@@ -4,21 +4,27 @@
 #include "CFRG.h"
 #include "DBG.h"
 #include "CFRGLFS.h"
-#include "CFRGTopSort.h"
+#include "CFRGDFS.h"
+#include "LongestPath.h"
 #include "CFRDemandMap.h"
 
-typedef list<ThreadWCETOMap*> PredList;
+/* Predecessor CFR -> its (read only) thread WCETO map */
+typedef map<CFR*, const ThreadWCETOMap*> PredMaps;
 
 class WCETOFactory {
 public:
 	WCETOFactory(CFRG &cfrg) : _cfrg(cfrg) {
 		setThreads(0);
 		setCTXCost(0);
+		setJobs(1);
+		setLogName("wceto.log");
 	}
 	WCETOFactory(CFRG &cfrg, uint32_t threads, uint32_t ctx_cost) :
 		_cfrg(cfrg) {
 		setThreads(threads);
 		setCTXCost(ctx_cost);
+		setJobs(1);
+		setLogName("wceto.log");
 	}
 	/**
 	 * Sets the number of threads the WCETO will be calculated for
@@ -43,6 +49,25 @@ public:
 	uint32_t getCTXCost() {
 		return _ctx_cost;
 	}
+	/**
+	 * Sets the number of CFRs (or top level loops) whose demand
+	 * is calculated at the same time. The result does not depend
+	 * on it.
+	 *
+	 * @param[in] jobs the number of worker threads
+	 */
+	void setJobs(unsigned int jobs) {
+		_jobs = jobs == 0 ? 1 : jobs;
+	}
+	/**
+	 * Sets the name of the debug trace, after the log prefix of the
+	 * CFRG. produce() truncates it.
+	 *
+	 * @param[in] name the file name, wceto.log by default
+	 */
+	void setLogName(const string &name) {
+		_log_name = name;
+	}
 	/**
 	 * Induces the calculation of WCETO values
 	 */
@@ -95,29 +120,35 @@ public:
 	 * (1, 1, 2, 2, 2) -- returns 5
 	 */
 	uint32_t dupeCount(ECBs &ecbs);
-	/**
-	 * Debug object
-	 */
-	DBG dbg;
-	void dumpCFRs();
-private:
-	uint32_t _threads, _ctx_cost;
-	CFRG &_cfrg;
-	CFRDemandMap _cfrt, _loopt, _scratcht;
-
-
 	/**
 	 * Merges the execution (and maybe cache loads) into the given
 	 * demand map.
 	 *
+	 * Each thread takes the largest remaining delta of any
+	 * predecessor, a delta is used at most once. The predecessor
+	 * maps are left untouched.
+	 *
 	 * @param[in|out] dem the demand being updated
-	 * @param[in|out] map of demands being merged into dem,
-	 *   ruined after calling
+	 * @param[in] preds the maps being merged into dem
 	 * @param[in] includeLoad when false only execution values are
 	 *     considered. When true, cache loads are also considered.
 	 */
-	void maxMerge(CFRDemand &dem, CFRDemandMap &map, bool includeLoad);
-	uint32_t maxEle(ThreadWCETOMap &dem, uint32_t &idx);
+	void maxMerge(CFRDemand &dem, PredMaps &preds, bool includeLoad);
+	/**
+	 * Debug object, one per thread since demands may be
+	 * calculated concurrently
+	 */
+	static thread_local DBG dbg;
+	/* Where produce() writes the debug output of every thread */
+	TraceFile trace;
+	void dumpCFRs();
+private:
+	uint32_t _threads, _ctx_cost;
+	unsigned int _jobs;
+	string _log_name;
+	CFRG &_cfrg;
+	CFRDemandMap _cfrt, _loopt, _scratcht;
+
 	void switchPass();
 	void updateSwitching(ListDigraph::Node node,
 			     ListDigraph::NodeMap<bool> &visited);
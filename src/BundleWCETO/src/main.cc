@@ -1,4 +1,5 @@
 /* Standard includes */
+#include<cmath>
 #include<iostream>
 #include<getopt.h>
 #include<libxml/xpath.h>
@@ -17,21 +18,369 @@ using namespace std;
 #include "WCETOFactory.h"
 #include "LPFactory.h"
 #include "LPIFactory.h"
+#include "SweepFactory.h"
+#include "SummaryFactory.h"
+#include "JobPool.h"
+#include "Trace.h"
 
 void
 usage(void) {
 	cout << "Usage: BundleWCETO <OPTIONS> <XML Configuration File>" << endl
-	     << "REQUIRED OPTIONS: --CFG --threads" << endl
+	     << "REQUIRED OPTIONS: --CFG --threads|--threads-range" << endl
 	     << "OPTIONS" << endl
 	     << "	-c/--CFG <file> Control Flow Graph from BundleCFG" << endl
 	     << "	-m/--threads #	Number of threads to use" << endl
+	     << "	-r/--threads-range <lo>:<hi>" << endl
+	     << "			Analyze every thread count from lo to hi"
+	     << endl
+	     << "			(replaces --threads)" << endl
+	     << "	-g/--geometry <sets>x<ways>x<line>x<mem latency>[x<latency>]"
+	     << endl
+	     << "			Sweep an instruction cache geometry instead"
+	     << endl
+	     << "			of the XML cache levels, may be repeated"
+	     << endl
+	     << "	--geometries <file> Sweep the geometries in a file" << endl
+	     << "	-o/--sweep-out <file> Sweep results (default <CFG>-sweep.csv)"
+	     << endl
 	     << "	-h/--help	this message" << endl
+	     << "	--ilp-grid <bundle ctx>,.../<thread ctx>,..." << endl
+	     << "			Solve the ILP for every thread count and pair"
+	     << endl
+	     << "			of context switch costs (needs LPSOLVE)"
+	     << endl
+	     << "	-j/--jobs #	Cache levels or geometries analyzed in parallel,"
+	     << endl
+	     << "			jobs left over are used by the WCETO calculation"
+	     << endl
+	     << "	-l/--lp-dump	Write the ILPs in the lp_solve format" << endl
+#ifndef LPSOLVE
+	     << "			(always, built without LPSOLVE)" << endl
+#endif
 	     << "	-t/--ctx-thread	Cycles per thread context switch" << endl
+	     << "	--trace[=<component>:<level>,...]" << endl
+	     << "			enable tracing, level is off, info or debug"
+	     << endl
+	     << "			(default all:debug)" << endl
 	     << "	-x/--ctx-bndl #	Cycles per bundle context switch" << endl
 	     << "	-v/--verbose	enable verbose output" << endl
 	     << endl;
 }
 
+/**
+ * Parses a thread range of the form <lo>:<hi> or <hi>
+ *
+ * @return true if the range is valid
+ */
+static bool
+parse_range(string arg, unsigned int &lo, unsigned int &hi) {
+	size_t idx = arg.find(':');
+	if (idx == string::npos) {
+		lo = 1;
+		hi = atoi(arg.c_str());
+	} else {
+		lo = atoi(arg.substr(0, idx).c_str());
+		hi = atoi(arg.substr(idx + 1).c_str());
+	}
+	return lo > 0 && lo <= hi;
+}
+
+/**
+ * Parses the context switch costs of an ILP grid, of the form
+ * <bundle ctx>,.../<thread ctx>,...
+ *
+ * @return true if both lists are valid
+ */
+static bool
+parse_grid(string arg, vector<uint32_t> &bundle,
+	   vector<uint32_t> &thread) {
+	size_t idx = arg.find('/');
+	if (idx == string::npos) {
+		return false;
+	}
+	string lists[2] = { arg.substr(0, idx), arg.substr(idx + 1) };
+	vector<uint32_t> *costs[2] = { &bundle, &thread };
+	for (int i = 0; i < 2; i++) {
+		stringstream ss(lists[i]);
+		string cost;
+		costs[i]->clear();
+		while (getline(ss, cost, ',')) {
+			if (cost.length() == 0 ||
+			    cost.find_first_not_of("0123456789") != string::npos) {
+				return false;
+			}
+			costs[i]->push_back(atoi(cost.c_str()));
+		}
+		if (costs[i]->size() == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Path of a per thread count output file, the thread count is only
+ * part of the name when a range of thread counts is analyzed
+ */
+static string
+thread_path(string pre, unsigned int threads, bool range, string ext) {
+	if (!range) {
+		return pre + ext;
+	}
+	stringstream ss;
+	ss << pre << "-m" << threads << ext;
+	return ss.str();
+}
+
+static void
+free_caches(map<int, Cache*> &caches) {
+	map<int, Cache*>::iterator mit;
+	for (mit = caches.begin(); mit != caches.end(); ++mit) {
+		delete mit->second;
+	}
+	caches.clear();
+}
+
+/**
+ * Settings of the analysis, shared by every cache level
+ */
+struct Settings {
+	string base;
+	unsigned int lo_threads, n_threads;
+	bool range;
+	int bundle_ctx, thread_ctx;
+	/* Write the .lp and .lp2 files */
+	bool lp_dump;
+	/* Context switch costs of the ILP grid, none if empty */
+	vector<uint32_t> grid_bundle, grid_thread;
+	/* Worker threads of each WCETO calculation */
+	unsigned int wceto_jobs;
+};
+
+/**
+ * Analyzes the CFG with a single cache level, producing the DOT, ILP,
+ * entry and WCETO files of that level
+ *
+ * @param[in] cfg the CFG, frozen and shared by the levels
+ * @param[in] level the cache level
+ * @param[in] cache the cache of the level
+ * @param[in] set the settings of the analysis
+ * @param[in] log_pfx prefix of the log files
+ * @param[in] out where status messages are written
+ */
+static void
+analyze_level(const CFG &cfg, int level, Cache *cache, const Settings &set,
+	      string log_pfx, ostream &out) {
+	unsigned int lo_threads = set.lo_threads, n_threads = set.n_threads;
+	bool range = set.range;
+	int bundle_ctx = set.bundle_ctx, thread_ctx = set.thread_ctx;
+	stringstream ss;
+
+	ss.str("");
+	ss << set.base << "-level-" << level;
+	string pre = ss.str();
+	ss.str("");  ss << pre << ".dot";
+	DOTFactory dot(cfg);
+	dot.setPath(ss.str());
+	dot.setCache(cache);
+	out << "BWCETO> DOT : " << ss.str() << endl;
+	
+	/* Shared functions are analyzed on their own, callees first */
+	SummaryFactory summaries(cfg, *cache, bundle_ctx, log_pfx);
+	if (cfg.isShared()) {
+		out << "BWCETO> Summarizing functions" << endl;
+		summaries.produce();
+	}
+
+	/* Export CFRs to JPGs */
+	CFRFactory cfr_fact(cfg, *cache, log_pfx);
+	cfr_fact.setSummaries(&summaries.summaries());
+	map<ListDigraph::Node, CFR*> cfrs = cfr_fact.produce();
+	map<ListDigraph::Node, CFR*>::iterator cfrit;
+	for (cfrit = cfrs.begin(); cfrit != cfrs.end(); ++cfrit) {
+		ss.str("");
+		ss << pre << "-cfr-";
+		CFR* cfr = cfrit->second;
+		ListDigraph::Node cfr_initial = cfr->getInitial();
+		ss << "0x" << hex << cfr->getAddr(cfr_initial) << dec
+		   << ".dot";
+
+		DOTfromCFR cfrdot(*cfr);
+		cfrdot.setPath(ss.str());
+		cfrdot.setCache(cache);
+		cfrdot.produce();
+
+		ListDigraph::Node cfg_initial =
+			cfr->membership(cfr_initial);
+		dot.setColor(cfg_initial, "yellow");
+		dot.labelNodesCFR(cfr);
+
+		JPGFactory cfrjpg(cfrdot);
+		cfrjpg.produce();
+	}
+	CFRG *cfrg = cfr_fact.getCFRG();
+
+	/*
+	 * The ILPs are built once, the thread count only changes a
+	 * right hand side
+	 */
+	map<unsigned int, pair<double, double> > ilps;
+	LPFactory lp_fact(cfrg, lo_threads, bundle_ctx, thread_ctx);
+	LPIFactory lpi_fact(cfrg, lo_threads, bundle_ctx);
+	if (set.lp_dump) {
+		lp_fact.setPath(thread_path(pre, lo_threads, range, ".lp"));
+		lpi_fact.setPath(thread_path(pre, lo_threads, range, ".lp2"));
+	}
+	lp_fact.produce();
+	lpi_fact.produce();
+	for (unsigned int m = lo_threads; m <= n_threads; m++) {
+		lp_fact.setThreads(m);
+		lpi_fact.setThreads(m);
+		if (set.lp_dump && m > lo_threads) {
+			lp_fact.setPath(thread_path(pre, m, range, ".lp"));
+			lp_fact.write();
+			lpi_fact.setPath(thread_path(pre, m, range, ".lp2"));
+			lpi_fact.write();
+		}
+#ifdef LPSOLVE
+		lp_fact.solve();
+		lpi_fact.solve();
+		ilps[m] = make_pair(lp_fact.objective(), lpi_fact.objective());
+#endif
+	}
+	LPTable grid;
+	if (set.grid_bundle.size() > 0) {
+		vector<uint32_t> threads;
+		for (unsigned int m = lo_threads; m <= n_threads; m++) {
+			threads.push_back(m);
+		}
+		grid = lp_fact.solveGrid(threads, set.grid_bundle,
+					 set.grid_thread);
+	}
+
+	/* Make a graph before doing WCETO processing */
+	WCETOFactory nowceto_fact(*cfrg, n_threads, bundle_ctx);
+	DOTfromCFRG cfrg_nowceto(*cfrg, nowceto_fact);
+	ss.str(""); ss << pre << "-cfrg-nowceto.dot";
+	cfrg_nowceto.setPath(ss.str());
+	cfrg_nowceto.produce(n_threads);
+	JPGFactory nowcet(cfrg_nowceto.getPath());
+	nowcet.produce();
+
+	/* Assigns generation IDs to CFRG nodes */
+	out << "BWECTO> Ordering CFRs" << endl;
+	cfrg->order();
+
+	/*
+	 * Calculate the WCETO for each thread count, the
+	 * switching decisions depend on the thread count so
+	 * each one needs its own pass. The images and entries
+	 * are produced from the last (largest) thread count.
+	 */
+	map<unsigned int, uint32_t> wcetos;
+	WCETOFactory *wceto_fact = NULL;
+	for (unsigned int m = lo_threads; m <= n_threads; m++) {
+		delete wceto_fact;
+		wceto_fact = new WCETOFactory(*cfrg, m, bundle_ctx);
+		wceto_fact->setJobs(set.wceto_jobs);
+		wceto_fact->setLogName(thread_path("wceto", m, range, ".log"));
+		out << "BWCETO> Calculating WCETO";
+		if (range) {
+			out << " for " << m << " threads";
+		}
+		out << endl;
+		wceto_fact->produce();
+		wcetos[m] = wceto_fact->value(
+		    cfrg->findCFR(cfrg->getTerminal()));
+	}
+	
+	/* Produce the images for the Control Flow Region Graph */
+	DOTfromCFRG cfrg_dot(*cfrg, *wceto_fact);
+	ss.str(""); ss << pre << "-cfrg.dot";
+	cfrg_dot.setPath(ss.str());
+	cfrg_dot.produce(n_threads);
+
+	string path = cfrg_dot.getPath();
+	JPGFactory cfrg_jpg(path);
+	cfrg_jpg.produce();
+	out << "BWCETO> CFRG:\t" << cfrg_jpg.getPath() << endl;		
+
+	/* Drop the WCET table per cache level */
+	EntryFactory entries(*cfrg);
+	ss.str(""); ss << pre << ".entry-w-unswitched";
+	entries.setPath(ss.str());
+	entries.produce();
+	entries.setPath(pre + ".entry");
+	entries.produceAllSwitched();
+	
+	/* Produce images for the Control Flow Graphs */
+	dot.produce();
+	JPGFactory jpg(dot);
+	jpg.produce();
+	out << "BWCETO> CFG:\t" << jpg.getPath() << endl;
+	
+#ifdef DEBUG
+	wceto_fact->dumpCFRs(); 
+#endif
+	delete wceto_fact;
+
+	ofstream result(pre + ".wceto");
+	if (range) {
+		result << "Threads\tWCETO" << endl;
+	} else {
+		result << "WCETO" << endl;
+	}
+	map<unsigned int, uint32_t>::iterator wit;
+	for (wit = wcetos.begin(); wit != wcetos.end(); ++wit) {
+		out << "BWECTO> WCETO: " << wit->second;
+		if (range) {
+			out << " (" << wit->first << " threads)";
+			result << wit->first << "\t";
+		}
+		out << endl;
+		result << wit->second << endl;
+	}
+	result.close();
+
+	if (ilps.size() == 0) {
+		return;
+	}
+	/* Current and previous ILP bounds, rounded like lp_solve prints them */
+	ofstream ilp(pre + ".ilp");
+	if (range) {
+		ilp << "Threads\t";
+	}
+	ilp << "Current\tPrevious" << endl;
+	map<unsigned int, pair<double, double> >::iterator iit;
+	for (iit = ilps.begin(); iit != ilps.end(); ++iit) {
+		long long cur = llround(iit->second.first);
+		long long prev = llround(iit->second.second);
+		out << "BWCETO> ILP WCETO: " << cur << " (previous " << prev
+		    << ")";
+		if (range) {
+			out << " (" << iit->first << " threads)";
+			ilp << iit->first << "\t";
+		}
+		out << endl;
+		ilp << cur << "\t" << prev << endl;
+	}
+	ilp.close();
+
+	if (grid.size() == 0) {
+		return;
+	}
+	ofstream grid_out(pre + ".ilp-grid");
+	grid_out << "Threads\tBundleCTX\tThreadCTX\tWCETO" << endl;
+	LPTable::iterator git;
+	for (git = grid.begin(); git != grid.end(); ++git) {
+		grid_out << git->threads << "\t" << git->bundle_ctx << "\t"
+			 << git->thread_ctx << "\t" << llround(git->objective)
+			 << endl;
+	}
+	grid_out.close();
+	out << "BWCETO> ILP grid:\t" << pre << ".ilp-grid" << endl;
+}
+
 /**
  * Entrypoint
  *
@@ -47,20 +396,36 @@ main(int argc, char** argv) {
 		{"ctx-bndl", required_argument, NULL, 'x'},
 		{"ctx-thread", required_argument, NULL, 't'},		
 		{"CFG", required_argument, NULL, 'c'},
+		{"geometry", required_argument, NULL, 'g'},
+		{"geometries", required_argument, NULL, 'G'},
 		{"help", no_argument, &hflag, 1},
+		{"ilp-grid", required_argument, NULL, 'I'},
+		{"jobs", required_argument, NULL, 'j'},
+		{"lp-dump", no_argument, NULL, 'l'},
+		{"sweep-out", required_argument, NULL, 'o'},
 		{"threads", required_argument, NULL, 'm'},
-		{"trace", no_argument, &tflag, 1},
+		{"threads-range", required_argument, NULL, 'r'},
+		{"trace", optional_argument, NULL, 'T'},
 		{"verbose", no_argument, &vflag, 1},
 		{0, 0, 0, 0}
 	};
 
-	string cfgfile, bcfg_file, base;
-	unsigned int n_threads = 0;
+	string cfgfile, bcfg_file, base, sweep_out;
+	vector<string> geom_specs, geom_files;
+	vector<uint32_t> grid_bundle, grid_thread;
+	unsigned int n_threads = 0, lo_threads = 0, jobs = 1;
+	bool range = false;
 	int bundle_ctx = -1, thread_ctx = -1;
+#ifdef LPSOLVE
+	bool lp_dump = false;
+#else
+	/* The ILPs are only solved from the files */
+	bool lp_dump = true;
+#endif
 		
 	while (1) {
 		int opt_ind, c;
-		c = getopt_long(argc, argv, "c:hm:t:vx:", long_options, &opt_ind);
+		c = getopt_long(argc, argv, "c:g:hj:lo:m:r:t:vx:", long_options, &opt_ind);
 		if (c == -1) {
 			/* End of parsed options */
 			break;
@@ -74,15 +439,65 @@ main(int argc, char** argv) {
 		case 'c':
 			bcfg_file = optarg;
 			break;
+		case 'g':
+			geom_specs.push_back(optarg);
+			break;
+		case 'G':
+			geom_files.push_back(optarg);
+			break;
 		case 'h':
 			hflag = 1;
 			break;
+		case 'I':
+			/* Long only */
+#ifndef LPSOLVE
+			cout << "--ilp-grid needs a build with LPSOLVE" << endl;
+			return -1;
+#endif
+			if (!parse_grid(optarg, grid_bundle, grid_thread)) {
+				cout << "Invalid ILP grid: " << optarg << endl;
+				usage();
+				return -1;
+			}
+			break;
+		case 'j':
+			jobs = atoi(optarg);
+			if (jobs == 0) {
+				jobs = 1;
+			}
+			break;
+		case 'l':
+			lp_dump = true;
+			break;
+		case 'o':
+			sweep_out = optarg;
+			break;
 		case 'm':
 			n_threads = atoi(optarg);
 			break;
+		case 'r':
+			range = true;
+			if (!parse_range(optarg, lo_threads, n_threads)) {
+				cout << "Invalid thread range: " << optarg
+				     << endl;
+				usage();
+				return -1;
+			}
+			break;
 		case 't':
 			thread_ctx = atoi(optarg);
 			break;
+		case 'T':
+			/* Long only, -t is the thread context switch */
+			tflag = 1;
+			try {
+				Trace::configure(optarg ? optarg : "all");
+			} catch (runtime_error &e) {
+				cout << e.what() << endl;
+				usage();
+				return -1;
+			}
+			break;
 		case 'x':
 			bundle_ctx = atoi(optarg);
 			break;
@@ -118,6 +533,9 @@ main(int argc, char** argv) {
 		usage();
 		return -1;
 	}
+	if (!range) {
+		lo_threads = n_threads;
+	}
 	if (bundle_ctx == -1) {
 		cout << "No bundle context switch cost [-x] given." << endl;
 		usage();
@@ -132,7 +550,11 @@ main(int argc, char** argv) {
 
 	cout << "BWCETO> Configuration file: " << cfgfile << endl
 	     << "BWCETO> Bundle CFG file: " << bcfg_file << endl
-	     << "BWCETO> Thread Count: " << n_threads << endl
+	     << "BWCETO> Thread Count: " << lo_threads;
+	if (range) {
+		cout << " to " << n_threads;
+	}
+	cout << endl
 	     << "BWCETO> Bundle Context Switch Cost (in Cycles): " << bundle_ctx << endl
 	     << "BWCETO> Thread Context Switch Cost (in Cycles): " << thread_ctx << endl;
 
@@ -159,122 +581,77 @@ main(int argc, char** argv) {
 	CFG cfg;
 	CFGReader cfgr(cfg);
 	cfgr.read(bcfg_file);
+	/* Only read from here on, the analyses share it */
+	cfg.freeze();
 	cout << "BWCETO> CFG initial:\t" << cfg.stringNode(cfg.getInitial()) << endl;
 	cout << "BWECTO> CFG terminal:\t" << cfg.stringNode(cfg.getTerminal()) << endl;
 
 	map<int, Cache*>::iterator mit;
-	for (mit = ins_cache.begin(); mit != ins_cache.end(); ++mit) {
-		stringstream ss;
-
-		CFG copy(cfg);
-		Cache *cache = mit->second;
-		
-		ss.str("");
-		ss << base << "-level-" << mit->first;
-		string pre = ss.str();
-		ss.str("");  ss << pre << ".dot";
-		DOTFactory dot(copy);
-		dot.setPath(ss.str());
-		dot.setCache(cache);
-		cout << "BWCETO> DOT : " << ss.str() << endl;
-		
-		/* Export CFRs to JPGs */
-		CFRFactory cfr_fact(copy, *cache);
-		map<ListDigraph::Node, CFR*> cfrs = cfr_fact.produce();
-		map<ListDigraph::Node, CFR*>::iterator cfrit;
-		for (cfrit = cfrs.begin(); cfrit != cfrs.end(); ++cfrit) {
-			ss.str("");
-			ss << pre << "-cfr-";
-			CFR* cfr = cfrit->second;
-			ListDigraph::Node cfr_initial = cfr->getInitial();
-			ss << "0x" << hex << cfr->getAddr(cfr_initial) << dec
-			   << ".dot";
-
-			DOTfromCFR cfrdot(*cfr);
-			cfrdot.setPath(ss.str());
-			cfrdot.setCache(cache);
-			cfrdot.produce();
-
-			ListDigraph::Node cfg_initial =
-				cfr->membership(cfr_initial);
-			dot.setColor(cfg_initial, "yellow");
-			dot.labelNodesCFR(cfr);
-
-			JPGFactory cfrjpg(cfrdot);
-			cfrjpg.produce();
+	if (geom_specs.size() > 0 || geom_files.size() > 0) {
+		/* Geometries without a hit latency use the first level's */
+		uint32_t latency = 1;
+		if (ins_cache.size() > 0) {
+			latency = ins_cache.begin()->second->latency();
 		}
-		CFRG *cfrg = cfr_fact.getCFRG();
-
-		/* Make a graph before doing WCETO processing */
-		LPFactory lp_fact(cfrg, n_threads, bundle_ctx, thread_ctx, pre + ".lp");
-		lp_fact.produce();
-		LPIFactory lpi_fact(cfrg, n_threads, bundle_ctx, pre + ".lp2");
-		lpi_fact.produce();
-		WCETOFactory wceto_fact(*cfrg, n_threads, bundle_ctx);		
-		DOTfromCFRG cfrg_nowceto(*cfrg, wceto_fact);
-		ss.str(""); ss << pre << "-cfrg-nowceto.dot";
-		cfrg_nowceto.setPath(ss.str());
-		cfrg_nowceto.produce(n_threads);
-		JPGFactory nowcet(cfrg_nowceto.getPath());
-		nowcet.produce();
-
-		/* Assigns generation IDs to CFRG nodes */
-		cout << "BWECTO> Ordering CFRs" << endl;
-		cfrg->order();
-
-		ss.str(""); ss << pre << ".wceto";
-
-		/* Calculate the WCETO for each CFR */
-		CFR *initial_cfr = cfrg->findCFR(cfrg->getInitial());
-		cout << "BWCETO> Calculating WCETO" << endl;
-		wceto_fact.produce();
-		
-		/* Produce the images for the Control Flow Region Graph */
-		DOTfromCFRG cfrg_dot(*cfrg, wceto_fact);
-		ss.str(""); ss << pre << "-cfrg.dot";
-		cfrg_dot.setPath(ss.str());
-		cfrg_dot.produce(n_threads);
-
-		string path = cfrg_dot.getPath();
-		JPGFactory cfrg_jpg(path);
-		cfrg_jpg.produce();
-		cout << "BWCETO> CFRG:\t" << cfrg_jpg.getPath() << endl;		
-
-		/* Drop the WCET table per cache level */
-		EntryFactory entries(*cfrg);
-		ss.str(""); ss << pre << ".entry-w-unswitched";
-		entries.setPath(ss.str());
-		entries.produce();
-		entries.setPath(pre + ".entry");
-		entries.produceAllSwitched();
-		
-		/* Produce images for the Control Flow Graphs */
-		dot.produce();
-		JPGFactory jpg(dot);
-		jpg.produce();
-		cout << "BWCETO> CFG:\t" << jpg.getPath() << endl;
-		
-#ifdef DEBUG
-		wceto_fact.dumpCFRs(); 
-#endif
-		cout << "BWECTO> WCETO: "
-		     << wceto_fact.value(cfrg->findCFR(cfrg->getTerminal()))
-		     << endl;
-		ofstream result(pre + ".wceto");
-		result << "WCETO" << endl 
-		       << wceto_fact.value(cfrg->findCFR(cfrg->getTerminal()))
-		       << endl;
-		result.close();
+		SweepFactory sweep(cfg, bundle_ctx);
+		sweep.setThreads(lo_threads, n_threads);
+		sweep.setJobs(jobs);
+		for (size_t i=0; i < geom_specs.size(); i++) {
+			sweep.addGeometry(Geometry(geom_specs[i], latency));
+		}
+		for (size_t i=0; i < geom_files.size(); i++) {
+			sweep.readGeometries(geom_files[i], latency);
+		}
+		if (sweep_out.length() == 0) {
+			sweep_out = base + "-sweep.csv";
+		}
+		sweep.setPath(sweep_out);
+		sweep.produce();
+		cout << "BWCETO> Sweep:\t" << sweep.getPath() << endl;
 
+		/* The XML cache levels are not analyzed */
+		free_caches(ins_cache);
+		free_caches(dat_cache);
+		return 0;
 	}
 
-	/* Cleanup */
-	for (mit = ins_cache.begin(); mit != ins_cache.end(); ++mit) {
-		delete mit->second;
+	/* Cache levels are independent, analyze them as jobs */
+	Settings settings;
+	settings.base = base;
+	settings.lo_threads = lo_threads;
+	settings.n_threads = n_threads;
+	settings.range = range;
+	settings.bundle_ctx = bundle_ctx;
+	settings.thread_ctx = thread_ctx;
+	settings.lp_dump = lp_dump;
+	settings.grid_bundle = grid_bundle;
+	settings.grid_thread = grid_thread;
+	/* Jobs not taken by other levels go to the WCETO calculation */
+	settings.wceto_jobs = 1;
+	if (ins_cache.size() > 0 && ins_cache.size() < jobs) {
+		settings.wceto_jobs = jobs / ins_cache.size();
 	}
-	for (mit = dat_cache.begin(); mit != dat_cache.end(); ++mit) {
-		delete mit->second;
+
+	JobPool pool(jobs);
+	for (mit = ins_cache.begin(); mit != ins_cache.end(); ++mit) {
+		int level = mit->first;
+		Cache *cache = mit->second;
+		/* Concurrent analyses may not share log files */
+		string log_pfx;
+		if (jobs > 1) {
+			stringstream ss;
+			ss << base << "-level-" << level << "-";
+			log_pfx = ss.str();
+		}
+		pool.add([&cfg, level, cache, &settings, log_pfx](ostream &out) {
+			analyze_level(cfg, level, cache, settings, log_pfx, out);
+		});
 	}
+	pool.run(cout);
+
+	/* Cleanup */
+	free_caches(ins_cache);
+	free_caches(dat_cache);
 	
 	return 0;
 }
@@ -0,0 +1,293 @@
+#include "CFGTest.h"
+#include "CFGReadWrite.h"
+#include <algorithm>
+#include <cstdio>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CFGTest);
+
+void
+CFGTest::setUp()
+{
+}
+
+void
+CFGTest::tearDown()
+{
+}
+
+/* Two calls of sort from main, at 0x4020 and 0x4040 */
+static void
+init_cfg(CFG &cfg, ListDigraph::Node &a, ListDigraph::Node &b)
+{
+	FunctionCall main("main", CallStack({0x0}));
+	FunctionCall first(main, "sort", 0x4020);
+	FunctionCall second(main, "sort", 0x4040);
+
+	a = cfg.addNode();
+	cfg.setAddr(a, 0x5000);
+	cfg.setFunction(a, first);
+
+	b = cfg.addNode();
+	cfg.setFunction(b, second);
+	cfg.setAddr(b, 0x5000);
+}
+
+void
+CFGTest::find()
+{
+	CFG cfg;
+	ListDigraph::Node a, b;
+	init_cfg(cfg, a, b);
+
+	FunctionCall main("main", CallStack({0x0}));
+	FunctionCall first(main, "sort", 0x4020);
+	FunctionCall second(main, "sort", 0x4040);
+	FunctionCall third(main, "sort", 0x4060);
+
+	CPPUNIT_ASSERT_MESSAGE("First call not found",
+			       cfg.find(0x5000, first) == a);
+	CPPUNIT_ASSERT_MESSAGE("Second call not found",
+			       cfg.find(0x5000, second) == b);
+	CPPUNIT_ASSERT_MESSAGE("Third call should not be found",
+			       cfg.find(0x5000, third) == INVALID);
+	CPPUNIT_ASSERT_MESSAGE("Wrong address should not be found",
+			       cfg.find(0x5004, first) == INVALID);
+
+	FunctionCall renamed("other", CallStack({0x4040, 0x0}));
+	CPPUNIT_ASSERT_MESSAGE("findIgnoreName should ignore the name",
+			       cfg.findIgnoreName(0x5000, renamed) == b);
+	FunctionCall shorter("sort", CallStack({0x4040}));
+	CPPUNIT_ASSERT_MESSAGE("findIgnoreName should match whole stacks",
+			       cfg.findIgnoreName(0x5000, shorter) == INVALID);
+}
+
+void
+CFGTest::findAddr()
+{
+	CFG cfg;
+	ListDigraph::Node a, b;
+	init_cfg(cfg, a, b);
+
+	list<ListDigraph::Node> nodes = cfg.find(0x5000);
+	CPPUNIT_ASSERT_MESSAGE("Both calls should be found", nodes.size() == 2);
+	CPPUNIT_ASSERT(std::find(nodes.begin(), nodes.end(), a) != nodes.end());
+	CPPUNIT_ASSERT(std::find(nodes.begin(), nodes.end(), b) != nodes.end());
+	CPPUNIT_ASSERT_MESSAGE("No instruction at 0x5004",
+			       cfg.find(0x5004).size() == 0);
+}
+
+void
+CFGTest::findUpdated()
+{
+	CFG cfg;
+	ListDigraph::Node a, b;
+	init_cfg(cfg, a, b);
+
+	FunctionCall main("main", CallStack({0x0}));
+	FunctionCall first(main, "sort", 0x4020);
+	FunctionCall third(main, "sort", 0x4060);
+
+	cfg.setAddr(a, 0x5004);
+	CPPUNIT_ASSERT_MESSAGE("Old address should not be found",
+			       cfg.find(0x5000, first) == INVALID);
+	CPPUNIT_ASSERT_MESSAGE("New address not found",
+			       cfg.find(0x5004, first) == a);
+	CPPUNIT_ASSERT(cfg.find(0x5000).size() == 1);
+
+	cfg.setFunction(a, third);
+	CPPUNIT_ASSERT_MESSAGE("Old function should not be found",
+			       cfg.find(0x5004, first) == INVALID);
+	CPPUNIT_ASSERT_MESSAGE("New function not found",
+			       cfg.find(0x5004, third) == a);
+}
+
+void
+CFGTest::findCopy()
+{
+	CFG cfg;
+	ListDigraph::Node a, b;
+	init_cfg(cfg, a, b);
+	cfg.addArc(a, b);
+
+	CFG copy(cfg);
+	FunctionCall main("main", CallStack({0x0}));
+	FunctionCall second(main, "sort", 0x4040);
+
+	ListDigraph::Node cb = copy.find(0x5000, second);
+	CPPUNIT_ASSERT_MESSAGE("Copy should be indexed", cb != INVALID);
+	CPPUNIT_ASSERT_MESSAGE("Copy should find its own node",
+			       copy.valid(cb) && copy.getFunction(cb) == second);
+	CPPUNIT_ASSERT(copy.find(0x5000).size() == 2);
+}
+
+/* Compares a CFG read back from a file to the graph of readWrite() */
+static void
+check_read(string path)
+{
+	CFG cfg;
+	CFGReader reader(cfg);
+	reader.read(path);
+
+	FunctionCall main("main", CallStack({0x0}));
+	FunctionCall first(main, "sort", 0x4020);
+	FunctionCall second(main, "sort", 0x4040);
+
+	ListDigraph::Node a = cfg.find(0x5000, first);
+	ListDigraph::Node b = cfg.find(0x5000, second);
+	ListDigraph::Node c = cfg.find(0x5004, second);
+	CPPUNIT_ASSERT_MESSAGE(path + " missing nodes",
+			       a != INVALID && b != INVALID && c != INVALID);
+	CPPUNIT_ASSERT(countNodes(cfg) == 3 && countArcs(cfg) == 3);
+	CPPUNIT_ASSERT(findArc(cfg, a, b) != INVALID);
+	CPPUNIT_ASSERT(findArc(cfg, b, c) != INVALID);
+	CPPUNIT_ASSERT(findArc(cfg, c, b) != INVALID);
+	CPPUNIT_ASSERT_MESSAGE(path + " lost the loop head",
+			       cfg.isHead(b) && cfg.getIters(b) == 7);
+	CPPUNIT_ASSERT(!cfg.isHead(c) && cfg.getHead(c) == b);
+	CPPUNIT_ASSERT(cfg.getHead(a) == INVALID);
+	CPPUNIT_ASSERT(cfg.getInitial() == a);
+	CPPUNIT_ASSERT(cfg.getFunction(c).getName() == "sort");
+}
+
+void
+CFGTest::readWrite()
+{
+	CFG cfg;
+	ListDigraph::Node a, b;
+	init_cfg(cfg, a, b);
+	FunctionCall main("main", CallStack({0x0}));
+	FunctionCall second(main, "sort", 0x4040);
+
+	ListDigraph::Node c = cfg.addNode();
+	cfg.setAddr(c, 0x5004);
+	cfg.setFunction(c, second);
+	cfg.markHead(b);
+	cfg.setIters(b, 7);
+	cfg.setHead(c, b);
+	cfg.addArc(a, b);
+	cfg.addArc(b, c);
+	cfg.addArc(c, b);
+
+	CFGWriter writer(cfg);
+	writer.write("CFGTest-binary.cfg");
+	check_read("CFGTest-binary.cfg");
+	remove("CFGTest-binary.cfg");
+
+	writer.setText();
+	writer.write("CFGTest-text.cfg");
+	check_read("CFGTest-text.cfg");
+	remove("CFGTest-text.cfg");
+}
+
+void
+CFGTest::freeze()
+{
+	CFG cfg;
+	ListDigraph::Node a, b;
+	init_cfg(cfg, a, b);
+	cfg.addArc(a, b);
+	cfg.freeze();
+
+	FunctionCall main("main", CallStack({0x0}));
+	FunctionCall first(main, "sort", 0x4020);
+	CPPUNIT_ASSERT(cfg.frozen());
+	CPPUNIT_ASSERT_THROW(cfg.addNode(), runtime_error);
+	CPPUNIT_ASSERT_THROW(cfg.addArc(b, a), runtime_error);
+	CPPUNIT_ASSERT_THROW(cfg.setAddr(a, 0x5004), runtime_error);
+	CPPUNIT_ASSERT_THROW(cfg.setFunction(b, first), runtime_error);
+	CPPUNIT_ASSERT_THROW(cfg.markHead(a), runtime_error);
+	CPPUNIT_ASSERT_THROW(cfg.setInitial(b), runtime_error);
+
+	const CFG &ro = cfg;
+	CPPUNIT_ASSERT_MESSAGE("A frozen CFG should still be read",
+			       ro.find(0x5000, first) == a);
+	CPPUNIT_ASSERT(countNodes(ro) == 2 && countArcs(ro) == 1);
+
+	CFG copy(cfg);
+	CPPUNIT_ASSERT_MESSAGE("A copy should not be frozen", !copy.frozen());
+	copy.addNode();
+	CPPUNIT_ASSERT(countNodes(copy) == 3 && countNodes(cfg) == 2);
+}
+
+void
+CFGTest::overlay()
+{
+	CFG cfg;
+	ListDigraph::Node a, b;
+	init_cfg(cfg, a, b);
+	cfg.freeze();
+
+	CFGMap<bool> first(cfg, false);
+	CFGMap<string> second(cfg);
+	first[a] = true;
+	second[b] = "b";
+	CPPUNIT_ASSERT(first[a] && !first[b]);
+	CPPUNIT_ASSERT(second[a] == "" && second[b] == "b");
+
+	CFGMap<bool> other(cfg, false);
+	CPPUNIT_ASSERT_MESSAGE("Overlays should not share data", !other[a]);
+	first.fill(false);
+	CPPUNIT_ASSERT(!first[a]);
+}
+
+/* Compares a CFG read back from a file to the graph of shared() */
+static void
+check_shared(string path)
+{
+	CFG cfg;
+	CFGReader reader(cfg);
+	reader.read(path);
+
+	FunctionCall main("main", CallStack({0x0}));
+	FunctionCall sort("sort", CallStack({0x5000}));
+	ListDigraph::Node call = cfg.find(0x4000, main);
+	ListDigraph::Node ret = cfg.find(0x4004, main);
+	ListDigraph::Node entry = cfg.find(0x5000, sort);
+	CPPUNIT_ASSERT_MESSAGE(path + " missing nodes", call != INVALID &&
+			       ret != INVALID && entry != INVALID);
+	CPPUNIT_ASSERT_MESSAGE(path + " lost the call",
+			       cfg.isShared() && cfg.getCallee(call) == entry);
+	CPPUNIT_ASSERT(cfg.getCalls().size() == 1);
+	CPPUNIT_ASSERT(cfg.getCallee(ret) == INVALID);
+	CPPUNIT_ASSERT_MESSAGE(path + " the entry of sort is not initial",
+			       cfg.getInitial() == call);
+	CPPUNIT_ASSERT_MESSAGE(path + " the return of sort is not terminal",
+			       cfg.getTerminal() == ret);
+}
+
+void
+CFGTest::shared()
+{
+	CFG cfg;
+	FunctionCall main("main", CallStack({0x0}));
+	FunctionCall sort("sort", CallStack({0x5000}));
+	ListDigraph::Node nodes[4];
+	iaddr_t addrs[4] = {0x5000, 0x5004, 0x4000, 0x4004};
+	for (int i=0; i < 4; i++) {
+		nodes[i] = cfg.addNode();
+		cfg.setAddr(nodes[i], addrs[i]);
+		cfg.setFunction(nodes[i], i < 2 ? sort : main);
+	}
+	cfg.addArc(nodes[0], nodes[1]);
+	/* The call is followed by its return */
+	cfg.addArc(nodes[2], nodes[3]);
+	CPPUNIT_ASSERT(!cfg.isShared());
+	cfg.setCallee(nodes[2], nodes[0]);
+	CPPUNIT_ASSERT(cfg.isShared() && cfg.getCallee(nodes[2]) == nodes[0]);
+
+	CFG copy(cfg);
+	ListDigraph::Node ccall = copy.find(0x4000, main);
+	CPPUNIT_ASSERT_MESSAGE("A copy should keep its calls",
+			       copy.getCallee(ccall) == copy.find(0x5000, sort));
+
+	CFGWriter writer(cfg);
+	writer.write("CFGTest-shared.cfg");
+	check_shared("CFGTest-shared.cfg");
+	writer.setText();
+	writer.write("CFGTest-shared.cfg");
+	check_shared("CFGTest-shared.cfg");
+	remove("CFGTest-shared.cfg");
+
+	cfg.freeze();
+	CPPUNIT_ASSERT_THROW(cfg.setCallee(nodes[3], nodes[0]), runtime_error);
+}
@@ -0,0 +1,33 @@
+#ifndef CFGTEST_H
+#define CFGTEST_H
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CFG.h"
+#include "CFGMap.h"
+
+class CFGTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(CFGTest);
+	CPPUNIT_TEST(find);
+	CPPUNIT_TEST(findAddr);
+	CPPUNIT_TEST(findUpdated);
+	CPPUNIT_TEST(findCopy);
+	CPPUNIT_TEST(readWrite);
+	CPPUNIT_TEST(freeze);
+	CPPUNIT_TEST(overlay);
+	CPPUNIT_TEST(shared);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp();
+	void tearDown();
+
+	void find();
+	void findAddr();
+	void findUpdated();
+	void findCopy();
+	void readWrite();
+	void freeze();
+	void overlay();
+	void shared();
+};
+
+#endif
@@ -47,3 +47,36 @@ CFRFactoryTest::basic()
 	fact.produce();
 }
 
+void
+CFRFactoryTest::reset()
+{
+	/*
+	 * a → b → c, a and c map to one set of a direct mapped cache so
+	 * c begins a second CFR
+	 */
+	PolicyLRU lru;
+	Cache cache(2, 1, 16, 1, 100, &lru);
+	CFG cfg;
+	ListDigraph::Node a = cfg.addNode(), b = cfg.addNode();
+	ListDigraph::Node c = cfg.addNode();
+	cfg.setInitial(a);
+	cfg.setAddr(a, 0x4000);
+	cfg.setAddr(b, 0x4010);
+	cfg.setAddr(c, 0x4020);
+	cfg.addArc(a, b);
+	cfg.addArc(b, c);
+
+	CFRFactory fact(cfg, cache);
+	NodeCFRMap cfrs = fact.produce();
+	CPPUNIT_ASSERT(cfrs.size() == 2);
+	CPPUNIT_ASSERT(cfrs.count(a) == 1 && cfrs.count(c) == 1);
+
+	/* From b nothing conflicts, c must not keep its old CFR */
+	fact.reset();
+	CPPUNIT_ASSERT(fact.getCFR(a) == NULL);
+	fact.setEntry(b);
+	cfrs = fact.produce();
+	CPPUNIT_ASSERT(cfrs.size() == 1 && cfrs.count(b) == 1);
+	CPPUNIT_ASSERT(fact.getCFR(a) == NULL && fact.getCFR(c) == NULL);
+	CPPUNIT_ASSERT(fact.getCFRG()->getInitialCFR() == fact.getCFR(b));
+}
@@ -10,6 +10,7 @@ class CFRFactoryTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE(CFRFactoryTest);
 	CPPUNIT_TEST(basic);
 	CPPUNIT_TEST(produceLeak);
+	CPPUNIT_TEST(reset);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void setUp();
@@ -17,6 +18,7 @@ public:
 
 	void produceLeak();
 	void basic();	
+	void reset();
 };
 
 #endif
@@ -19,7 +19,73 @@ CFRTest::corruption()
 	ListDigraph::Node a = cfg.addNode();
 	ListDigraph::Node b = cfg.addNode();
 
-	CFR cfr(cfg);
-	ListDigraph::Node c = cfr.addNode(b);
+	ListDigraph::Node c = cfg.addNode();
+
+	CFRMembers members(cfg);
+	CFR cfr(cfg, members);
+	cfr.addNode(a);
+	cfr.addNode(b);
+	CPPUNIT_ASSERT_THROW(cfr.addNode(a), runtime_error);
+	CPPUNIT_ASSERT_THROW(cfr.addNode(b), runtime_error);
+	/* A CFR may begin with a member of another CFR, no more */
+	CFR other(cfg, members);
+	other.addNode(b);
+	CPPUNIT_ASSERT(other.valid(b) && cfr.valid(b));
+	other.addNode(c);
+	CPPUNIT_ASSERT(other.valid(c) && !cfr.valid(c));
+	CFR third(cfg, members);
+	third.addNode(a);
+	CPPUNIT_ASSERT_THROW(third.addNode(c), runtime_error);
+}
+
+void
+CFRTest::view()
+{
+	/*
+	 * a → b → c → d, c → a
+	 * the CFR holds a, b and c
+	 */
+	CFG cfg;
+	ListDigraph::Node a = cfg.addNode(), b = cfg.addNode();
+	ListDigraph::Node c = cfg.addNode(), d = cfg.addNode();
+	cfg.addArc(a, b);
+	cfg.addArc(b, c);
+	cfg.addArc(c, d);
+	cfg.addArc(c, a);
+
+	CFRMembers members(cfg);
+	CFR cfr(cfg, members);
+	cfr.addNode(a);
+	cfr.setInitial(a);
+	cfr.addNode(b);
+	cfr.addNode(c);
+
+	CPPUNIT_ASSERT(cfr.valid(c));
+	CPPUNIT_ASSERT(!cfr.valid(d));
+	CPPUNIT_ASSERT(cfr.toCFG(b) == b);
+	CPPUNIT_ASSERT(cfr.fromCFG(d) == INVALID);
+	CPPUNIT_ASSERT_THROW(cfr.toCFG(d), runtime_error);
+	CPPUNIT_ASSERT(cfr.id(c) == 2 && cfr.maxNodeId() == 2);
+	CPPUNIT_ASSERT(cfr.membership(c) == a);
+	CPPUNIT_ASSERT(cfr.membership(d) == INVALID);
+
+	/* Newest first */
+	CFR::NodeIt nit(cfr);
+	CPPUNIT_ASSERT(nit == c);
+	CPPUNIT_ASSERT(++nit == b);
+	CPPUNIT_ASSERT(++nit == a);
+	CPPUNIT_ASSERT(++nit == INVALID);
+
+	/* Only the arcs between members */
+	CPPUNIT_ASSERT(countOutArcs(cfr, c) == 1);
+	CPPUNIT_ASSERT(cfr.runningNode(CFR::OutArcIt(cfr, c)) == a);
+	CPPUNIT_ASSERT(countInArcs(cfr, a) == 1);
+	CPPUNIT_ASSERT(cfr.str().find("(3v, 3e, ") == 0);
+
+	/* The arc back to the initial instruction is not on the path */
+	LongestPathT<CFR> lp(cfr);
+	lp.run(cfr.getInitial());
+	CPPUNIT_ASSERT(lp.maxDist() == 3);
+	CPPUNIT_ASSERT(lp.position(d) == -1);
 }
 
@@ -9,12 +9,14 @@
 class CFRTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE(CFRTest);
 	CPPUNIT_TEST(corruption);
+	CPPUNIT_TEST(view);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void setUp();
 	void tearDown();
 
 	void corruption();
+	void view();
 };
 
 #endif
@@ -102,3 +102,68 @@ CacheTest::cacheCopy()
 		delete mit->second;
 	}
 }
+
+void
+CacheTest::contents()
+{
+	PolicyLRU lru;
+	Cache cache(NSETS, NWAYS, LINE_SIZE, LATENCY, MEM_LATENCY, &lru);
+	CPPUNIT_ASSERT(cache.isLRU());
+
+	/* Same block */
+	cache.insert(0x4000);
+	CPPUNIT_ASSERT(cache.present(0x4000));
+	CPPUNIT_ASSERT(cache.present(0x401c));
+	CPPUNIT_ASSERT(!cache.present(0x4020));
+
+	/* Same set, the youngest block replaces line 0 */
+	iaddr_t other = 0x4000 + NSETS * LINE_SIZE;
+	CPPUNIT_ASSERT(cache.setIndex(0x4000) == cache.setIndex(other));
+	CacheSet *cs = cache.setOf(other);
+	CPPUNIT_ASSERT(!cs->empty());
+	CPPUNIT_ASSERT(!cs->evicts(other));
+	cache.insert(other);
+	CPPUNIT_ASSERT(cache.present(other));
+	CPPUNIT_ASSERT(!cache.present(0x4000));
+	CPPUNIT_ASSERT(cs->cacheLine(0) != NULL);
+	CPPUNIT_ASSERT(cs->cacheLine(0)->getStartAddress() == other);
+	CPPUNIT_ASSERT(cs->cacheLine(1) == NULL);
+
+	/* Copies do not share contents */
+	Cache copy(cache);
+	copy.clear();
+	CPPUNIT_ASSERT(!copy.present(other));
+	CPPUNIT_ASSERT(cache.present(other));
+	copy.reset(cache);
+	CPPUNIT_ASSERT(copy.present(other));
+
+	Cache direct(NSETS, 1, LINE_SIZE, LATENCY, MEM_LATENCY, &lru);
+	direct.insert(0x4000);
+	CPPUNIT_ASSERT(direct.setOf(other)->evicts(other));
+	CPPUNIT_ASSERT(!direct.setOf(0x4000)->evicts(0x4004));
+}
+
+void
+CacheTest::policyStore()
+{
+	PolicyLRU lru;
+	Cache cache(NSETS, NWAYS, LINE_SIZE, LATENCY, MEM_LATENCY, &lru);
+	CacheSet set(&cache);
+	iaddr_t a = 0x4000, b = a + NSETS * LINE_SIZE;
+	iaddr_t c = b + NSETS * LINE_SIZE;
+
+	lru.store(set, a);
+	CPPUNIT_ASSERT(!set.isFull());
+	lru.store(set, b);
+	CPPUNIT_ASSERT(set.isFull());
+	CPPUNIT_ASSERT(lru.evicts(set, c));
+	CPPUNIT_ASSERT(!lru.evicts(set, a));
+
+	/* Hitting a makes b the oldest */
+	lru.store(set, a);
+	lru.store(set, c);
+	CPPUNIT_ASSERT(set.present(a));
+	CPPUNIT_ASSERT(set.present(c));
+	CPPUNIT_ASSERT(!set.present(b));
+	CPPUNIT_ASSERT(set.cacheLine(0)->getStartAddress() == c);
+}
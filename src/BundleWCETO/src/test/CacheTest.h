@@ -12,6 +12,8 @@ class CacheTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(lineInsert);
 	CPPUNIT_TEST(copySet);
 	CPPUNIT_TEST(cacheCopy);		
+	CPPUNIT_TEST(contents);
+	CPPUNIT_TEST(policyStore);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void setUp();
@@ -22,6 +24,8 @@ public:
 	void lineInsert();
 	void copySet();
 	void cacheCopy();
+	void contents();
+	void policyStore();
 };
 
 #endif
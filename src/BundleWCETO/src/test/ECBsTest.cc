@@ -0,0 +1,72 @@
+#include "ECBsTest.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ECBsTest);
+
+void
+ECBsTest::setUp()
+{
+}
+
+void
+ECBsTest::tearDown()
+{
+}
+
+void
+ECBsTest::dupes()
+{
+	ECBs ecbs(4);
+	ecbs.add(1);
+	ecbs.add(2);
+	CPPUNIT_ASSERT(ecbs.dupeCount() == 0);
+
+	ecbs.add(1);
+	ecbs.add(2);
+	ecbs.add(2);
+	CPPUNIT_ASSERT(ecbs.size() == 5);
+	CPPUNIT_ASSERT(ecbs.dupeCount() == 5);
+
+	ecbs.add(3);
+	ecbs.dupesOnly();
+	CPPUNIT_ASSERT(ecbs.size() == 5);
+	CPPUNIT_ASSERT(ecbs.count(3) == 0);
+}
+
+void
+ECBsTest::setOps()
+{
+	/* Grown past the initial size */
+	ECBs a(2), b;
+	a.add(0);
+	a.add(5);
+	a.add(5);
+	b.add(5);
+	b.add(7);
+
+	ECBs u(a);
+	u.merge(b);
+	CPPUNIT_ASSERT(u.size() == 5);
+	CPPUNIT_ASSERT(u.count(5) == 3);
+	CPPUNIT_ASSERT(u.count(7) == 1);
+
+	ECBs i(a);
+	i.intersect(b);
+	CPPUNIT_ASSERT(i.size() == 1);
+	CPPUNIT_ASSERT(i.count(5) == 1);
+
+	u.unique();
+	CPPUNIT_ASSERT(u.size() == 3);
+	u.clear();
+	CPPUNIT_ASSERT(u.empty());
+}
+
+void
+ECBsTest::str()
+{
+	ECBs ecbs(8);
+	ecbs.add(3);
+	ecbs.add(1);
+	ecbs.add(3);
+	CPPUNIT_ASSERT(ecbs.str() == "(1, 3⨯2)");
+	CPPUNIT_ASSERT(ECBs().str() == "()");
+}
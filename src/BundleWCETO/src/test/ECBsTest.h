@@ -0,0 +1,23 @@
+#ifndef ECBS_TEST_H
+#define ECBS_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CFRECBs.h"
+
+class ECBsTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(ECBsTest);
+	CPPUNIT_TEST(dupes);
+	CPPUNIT_TEST(setOps);
+	CPPUNIT_TEST(str);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp();
+	void tearDown();
+
+	void dupes();
+	void setOps();
+	void str();
+};
+
+#endif /* ECBS_TEST_H */
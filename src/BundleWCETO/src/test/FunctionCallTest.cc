@@ -80,3 +80,58 @@ FunctionCallTest::stack_const()
 	    next.str().compare("loop:T[0x5080, 0x4020, 0x4000]") == 0);
 }
 
+
+void
+FunctionCallTest::interned()
+{
+	CallStack a({0x4020, 0x4000});
+	CallStack b;
+	b.push(0x4000);
+	b.push(0x4020);
+	CPPUNIT_ASSERT_MESSAGE("Equal stacks should share an id",
+			       a == b && a.id() == b.id());
+	CPPUNIT_ASSERT(a.size() == 2 && a.peek() == 0x4020);
+
+	CallStack below({0x4000});
+	CPPUNIT_ASSERT_MESSAGE("Stacks of different depth are unequal",
+			       a != below && a.id() != below.id());
+	b.push(0x5000);
+	CPPUNIT_ASSERT(b.pop() == 0x5000 && b == a);
+	b.pop();
+	CPPUNIT_ASSERT_MESSAGE("Popping should give the interned stack",
+			       b == below && b.str() == "T[0x4000]");
+	b.pop();
+	CPPUNIT_ASSERT(b == CallStack() && b.id() == 0);
+
+	FunctionCall main("main", CallStack({0x4000}));
+	FunctionCall sort(main, "sort", 0x4020);
+	FunctionCall same("sort", a);
+	CPPUNIT_ASSERT(sort == same && sort.id() == same.id());
+	CPPUNIT_ASSERT(sort.id() != main.id());
+	FunctionCall renamed("other", a);
+	CPPUNIT_ASSERT_MESSAGE("Names are part of the function call id",
+			       renamed.id() != sort.id());
+	CPPUNIT_ASSERT_THROW(renamed == sort, runtime_error);
+}
+
+void
+FunctionCallTest::cached_id()
+{
+	FunctionCall main("main", CallStack({0x4000}));
+	uint32_t id = main.id();
+	FunctionCall copy(main);
+	CPPUNIT_ASSERT(copy.id() == id);
+
+	FunctionCall sort(main, "sort", 0x4020);
+	copy.stack().push(0x4020);
+	CPPUNIT_ASSERT_MESSAGE("Pushing through stack() should change the id",
+			       copy.id() != id);
+	copy.setName("sort");
+	CPPUNIT_ASSERT(copy.id() == sort.id());
+	copy.stack().pop();
+	copy.setName("main");
+	CPPUNIT_ASSERT_MESSAGE("Restoring the call should restore the id",
+			       copy.id() == id);
+	copy = sort;
+	CPPUNIT_ASSERT(copy.id() == sort.id());
+}
@@ -11,6 +11,8 @@ class FunctionCallTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(basic);
 	CPPUNIT_TEST(push_const);
 	CPPUNIT_TEST(stack_const);	
+	CPPUNIT_TEST(interned);
+	CPPUNIT_TEST(cached_id);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void setUp();
@@ -21,6 +23,8 @@ public:
 	void basic();
 	void push_const();
 	void stack_const();
+	void interned();
+	void cached_id();
 };
 
 #endif
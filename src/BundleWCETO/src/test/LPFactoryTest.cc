@@ -0,0 +1,132 @@
+#include "LPFactoryTest.h"
+
+#include <stdexcept>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LPFactoryTest);
+
+static bool
+near(double a, double b)
+{
+	return a - b < 0.001 && b - a < 0.001;
+}
+
+void
+LPFactoryTest::setUp()
+{
+	/*
+	 * a → h → b → h, h → x
+	 *
+	 * h heads a loop of 4 iterations, b and x map to the set of a
+	 * in a 2 set direct mapped cache so they start new CFRs.
+	 */
+	cache = new Cache(2, 1, 16, 1, 100, &lru);
+	cfg = new CFG();
+	ListDigraph::Node a = cfg->addNode(), h = cfg->addNode();
+	ListDigraph::Node b = cfg->addNode(), x = cfg->addNode();
+	cfg->setInitial(a);
+	cfg->setAddr(a, 0x4000);
+	cfg->setAddr(h, 0x4010);
+	cfg->setAddr(b, 0x4020);
+	cfg->setAddr(x, 0x4040);
+	cfg->markHead(h);
+	cfg->setIters(h, 4);
+	cfg->setHead(b, h);
+	cfg->addArc(a, h);
+	cfg->addArc(h, b);
+	cfg->addArc(b, h);
+	cfg->addArc(h, x);
+	cfg->setTerminal(x);
+
+	cfr_fact = new CFRFactory(*cfg, *cache);
+	cfr_fact->produce();
+	cfrg = cfr_fact->getCFRG();
+}
+
+void
+LPFactoryTest::tearDown()
+{
+	delete cfr_fact;
+	delete cfg;
+	delete cache;
+}
+
+void
+LPFactoryTest::grid()
+{
+	vector<uint32_t> threads = {1, 2, 4};
+	vector<uint32_t> bundle_ctxs = {0, 50};
+	vector<uint32_t> thread_ctxs = {0, 10};
+
+	LPFactory lp(cfrg, 3, 7, 5);
+	lp.produce();
+#ifdef LPSOLVE
+	LPTable table = lp.solveGrid(threads, bundle_ctxs, thread_ctxs);
+	CPPUNIT_ASSERT(table.size() == 12);
+	/* The thread count changes fastest */
+	CPPUNIT_ASSERT(table[1].threads == 2 && table[1].bundle_ctx == 0);
+	CPPUNIT_ASSERT(table[3].thread_ctx == 10);
+	CPPUNIT_ASSERT_MESSAGE("The parameters should be restored",
+			       lp.getThreads() == 3 &&
+			       lp.getBundleCTX() == 7 &&
+			       lp.getThreadCTX() == 5);
+
+	/* Each warm started point against a model solved on its own */
+	for (size_t i = 0; i < table.size(); i++) {
+		const LPPoint &point = table[i];
+		LPFactory single(cfrg, point.threads, point.bundle_ctx,
+				 point.thread_ctx);
+		single.produce();
+		single.solve();
+		CPPUNIT_ASSERT(near(point.objective, single.objective()));
+		if (i > 0 && table[i - 1].bundle_ctx == point.bundle_ctx &&
+		    table[i - 1].thread_ctx == point.thread_ctx) {
+			CPPUNIT_ASSERT_MESSAGE("More threads cost more",
+			    point.objective >= table[i - 1].objective);
+		}
+	}
+
+	/* Solving the restored parameters gives the single solve */
+	lp.solve();
+	LPFactory single(cfrg, 3, 7, 5);
+	single.produce();
+	single.solve();
+	CPPUNIT_ASSERT(near(lp.objective(), single.objective()));
+#else
+	CPPUNIT_ASSERT_THROW(lp.solveGrid(threads, bundle_ctxs, thread_ctxs),
+			     runtime_error);
+#endif
+}
+
+void
+LPFactoryTest::drop()
+{
+	LPFactory lp(cfrg, 2, 10, 1);
+	lp.produce();
+	int rows = lp.model().countRows();
+	int vars = lp.model().countVars();
+#ifdef LPSOLVE
+	lp.solve();
+	double before = lp.objective();
+	CPPUNIT_ASSERT(lp.model().isSolved());
+
+	/* Building again drops the kept solver model */
+	lp.setThreads(4);
+	lp.produce();
+	CPPUNIT_ASSERT(!lp.model().isSolved());
+	CPPUNIT_ASSERT(lp.model().countRows() == rows);
+	CPPUNIT_ASSERT(lp.model().countVars() == vars);
+	lp.solve();
+	LPFactory single(cfrg, 4, 10, 1);
+	single.produce();
+	single.solve();
+	CPPUNIT_ASSERT(near(lp.objective(), single.objective()));
+
+	/* The rebuilt model is warm started again */
+	lp.setThreads(2);
+	lp.solve();
+	CPPUNIT_ASSERT(near(lp.objective(), before));
+#else
+	CPPUNIT_ASSERT(rows > 0 && vars > 0);
+	CPPUNIT_ASSERT_THROW(lp.solve(), runtime_error);
+#endif
+}
@@ -0,0 +1,29 @@
+#ifndef LPFACTORY_TEST_H
+#define LPFACTORY_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CFRFactory.h"
+#include "LPFactory.h"
+#include "PolicyLRU.h"
+
+class LPFactoryTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(LPFactoryTest);
+	CPPUNIT_TEST(grid);
+	CPPUNIT_TEST(drop);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp();
+	void tearDown();
+
+	void grid();
+	void drop();
+private:
+	PolicyLRU lru;
+	Cache *cache;
+	CFG *cfg;
+	CFRFactory *cfr_fact;
+	CFRG *cfrg;
+};
+
+#endif /* LPFACTORY_TEST_H */
@@ -0,0 +1,119 @@
+#include "LPModelTest.h"
+
+#include <sstream>
+#include <stdexcept>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LPModelTest);
+
+void
+LPModelTest::setUp()
+{
+	/*
+	 * max: x + 2 y;
+	 * x + y <= 4;  x - 10 b <= 0;  y <= 3;
+	 * bin b;
+	 */
+	lp = new LPModel();
+	x = lp->addVar();
+	y = lp->addVar();
+	b = lp->addVar(true);
+	lp->setName(x, "x");
+	lp->setName(y, "y");
+	lp->setName(b, "b");
+	lp->addObjective(x, 1);
+	lp->addObjective(y, 2);
+
+	int row = lp->addRow(LPModel::AT_MOST, 4, "Sum");
+	lp->addTerm(row, x, 1);
+	lp->addTerm(row, y, 1);
+	row = lp->addRow(LPModel::AT_MOST, 0);
+	lp->addTerm(row, x, 1);
+	lp->addTerm(row, b, -10);
+	lp->addComment("Only y");
+	row = lp->addRow(LPModel::AT_MOST, 3);
+	lp->addTerm(row, y, 1);
+}
+
+void
+LPModelTest::tearDown()
+{
+	delete lp;
+}
+
+void
+LPModelTest::rows()
+{
+	CPPUNIT_ASSERT(lp->countVars() == 3);
+	CPPUNIT_ASSERT(lp->countRows() == 3);
+	CPPUNIT_ASSERT(!lp->isBinary(x));
+	CPPUNIT_ASSERT(lp->isBinary(b));
+	CPPUNIT_ASSERT(lp->getName(y) == "y");
+
+	/* Unnamed columns are numbered */
+	int z = lp->addVar();
+	CPPUNIT_ASSERT(lp->getName(z) == "x3");
+	CPPUNIT_ASSERT_THROW(lp->addTerm(0, z + 1, 1), runtime_error);
+}
+
+void
+LPModelTest::write()
+{
+	/* Terms of one column are summed, the single y row is named */
+	int row = lp->addRow(LPModel::EXACTLY, 0);
+	lp->addTerm(row, y, 2);
+	lp->addTerm(row, x, -1);
+	lp->addTerm(row, y, -1);
+
+	stringstream ss;
+	lp->write(ss);
+	CPPUNIT_ASSERT(ss.str() ==
+		       "max: x + 2 y;\n"
+		       "/* Sum */\n"
+		       "\tx + y <= 4;\n"
+		       "\tx - 10 b <= 0;\n"
+		       "/* Only y */\n"
+		       "\tR3: y <= 3;\n"
+		       "\t-x + y = 0;\n"
+		       "\n"
+		       "bin b;\n");
+}
+
+void
+LPModelTest::solve()
+{
+#ifdef LPSOLVE
+	lp->solve();
+	CPPUNIT_ASSERT(lp->isSolved());
+	/* y = 3, x = 1 needs b = 1 */
+	CPPUNIT_ASSERT(lp->objective() > 6.999 && lp->objective() < 7.001);
+	CPPUNIT_ASSERT(lp->value(b) > 0.999);
+#else
+	CPPUNIT_ASSERT_THROW(lp->solve(), runtime_error);
+	CPPUNIT_ASSERT(!lp->isSolved());
+#endif
+}
+
+void
+LPModelTest::update()
+{
+	/* x <= 10 b becomes x <= 2 b, y <= 3 becomes y <= 1 */
+	lp->setTerm(1, b, -2);
+	lp->setRhs(2, 1);
+	CPPUNIT_ASSERT(lp->getTerm(1, b) == -2);
+	CPPUNIT_ASSERT(lp->getTerm(1, y) == 0);
+	CPPUNIT_ASSERT(lp->getRhs(2) == 1);
+	/* A missing term is added */
+	lp->setTerm(2, x, 1);
+	CPPUNIT_ASSERT(lp->getTerm(2, x) == 1);
+	lp->setTerm(2, x, 0);
+#ifdef LPSOLVE
+	lp->solve();
+	/* y = 1, x = 2 */
+	CPPUNIT_ASSERT(lp->objective() > 3.999 && lp->objective() < 4.001);
+	lp->setRhs(2, 3);
+	CPPUNIT_ASSERT(!lp->isSolved());
+	lp->solve();
+	/* y = 3, x = 1 */
+	CPPUNIT_ASSERT(lp->objective() > 6.999 && lp->objective() < 7.001);
+#endif
+}
@@ -0,0 +1,28 @@
+#ifndef LPMODEL_TEST_H
+#define LPMODEL_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "LPModel.h"
+
+class LPModelTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(LPModelTest);
+	CPPUNIT_TEST(rows);
+	CPPUNIT_TEST(write);
+	CPPUNIT_TEST(solve);
+	CPPUNIT_TEST(update);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp();
+	void tearDown();
+
+	void rows();
+	void write();
+	void solve();
+	void update();
+private:
+	LPModel *lp;
+	int x, y, b;
+};
+
+#endif /* LPMODEL_TEST_H */
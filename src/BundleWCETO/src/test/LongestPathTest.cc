@@ -0,0 +1,70 @@
+#include "LongestPathTest.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LongestPathTest);
+
+void
+LongestPathTest::setUp()
+{
+}
+
+void
+LongestPathTest::tearDown()
+{
+}
+
+void
+LongestPathTest::dag()
+{
+	/*
+	 * a → b → d
+	 * a → c → d, c → e → d
+	 * f is not reachable
+	 */
+	ListDigraph g;
+	ListDigraph::Node a = g.addNode(), b = g.addNode(), c = g.addNode();
+	ListDigraph::Node d = g.addNode(), e = g.addNode(), f = g.addNode();
+	g.addArc(a, b);
+	g.addArc(b, d);
+	g.addArc(a, c);
+	g.addArc(c, d);
+	g.addArc(c, e);
+	g.addArc(e, d);
+	g.addArc(f, d);
+
+	LongestPath lp(g);
+	lp.run(a);
+	CPPUNIT_ASSERT(lp.order().size() == 5);
+	CPPUNIT_ASSERT(lp.order().front() == a);
+	CPPUNIT_ASSERT(lp.order().back() == d);
+	CPPUNIT_ASSERT(lp.position(f) == -1);
+	CPPUNIT_ASSERT(lp.position(c) < lp.position(e));
+	CPPUNIT_ASSERT(lp.dist(a) == 1);
+	CPPUNIT_ASSERT(lp.dist(d) == 4);
+	CPPUNIT_ASSERT(lp.dist(f) == 0);
+	CPPUNIT_ASSERT(lp.maxDist() == 4);
+
+	lp.run(a, 3);
+	CPPUNIT_ASSERT(lp.maxDist() == 12);
+}
+
+void
+LongestPathTest::loop()
+{
+	/* a → h → b → h, h → x */
+	ListDigraph g;
+	ListDigraph::Node a = g.addNode(), h = g.addNode(), b = g.addNode();
+	ListDigraph::Node x = g.addNode();
+	g.addArc(a, h);
+	g.addArc(h, b);
+	ListDigraph::Arc back = g.addArc(b, h);
+	g.addArc(h, x);
+
+	LongestPath lp(g);
+	lp.run(a);
+	CPPUNIT_ASSERT(lp.order().size() == 4);
+	CPPUNIT_ASSERT(lp.isBack(back));
+	CPPUNIT_ASSERT(lp.dist(h) == 2);
+	CPPUNIT_ASSERT(lp.dist(b) == 3);
+	CPPUNIT_ASSERT(lp.dist(x) == 3);
+	CPPUNIT_ASSERT(lp.maxDist() == 3);
+}
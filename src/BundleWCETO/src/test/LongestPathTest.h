@@ -0,0 +1,21 @@
+#ifndef LONGEST_PATH_TEST_H
+#define LONGEST_PATH_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "LongestPath.h"
+
+class LongestPathTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(LongestPathTest);
+	CPPUNIT_TEST(dag);
+	CPPUNIT_TEST(loop);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp();
+	void tearDown();
+
+	void dag();
+	void loop();
+};
+
+#endif /* LONGEST_PATH_TEST_H */
@@ -0,0 +1,91 @@
+#include "SweepFactoryTest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SweepFactoryTest);
+
+void
+SweepFactoryTest::setUp()
+{
+}
+
+void
+SweepFactoryTest::tearDown()
+{
+}
+
+void
+SweepFactoryTest::geometry()
+{
+	Geometry geom("8x2x32x100");
+	CPPUNIT_ASSERT(geom.sets == 8 && geom.ways == 2);
+	CPPUNIT_ASSERT(geom.line_size == 32 && geom.mem_latency == 100);
+	CPPUNIT_ASSERT_MESSAGE("The hit latency defaults to 1",
+			       geom.latency == 1);
+	CPPUNIT_ASSERT(geom.str() == "8x2x32x100x1");
+
+	Geometry lat("1x64x16x50", 3);
+	CPPUNIT_ASSERT(lat.latency == 3);
+	Geometry own("16x1x64x80x2", 3);
+	CPPUNIT_ASSERT_MESSAGE("The spec's hit latency comes first",
+			       own.latency == 2);
+}
+
+void
+SweepFactoryTest::invalid()
+{
+	/* Malformed */
+	CPPUNIT_ASSERT_THROW(Geometry(""), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x2x32"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x2x32x100x1x1"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x2xx32x100"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x2x32x100x"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x2x32kx100"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("-8x2x32x100"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x+2x32x100"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x 2x32x100"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x2x32x4294967296"), runtime_error);
+	/* Zero fields */
+	CPPUNIT_ASSERT_THROW(Geometry("0x2x32x100"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x0x32x100"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x2x32x100x0"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x2x32x100", 0), runtime_error);
+	/* Not a power of two */
+	CPPUNIT_ASSERT_THROW(Geometry("6x2x32x100"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Geometry("8x2x24x100"), runtime_error);
+	/* More ways than a CacheSet holds */
+	CPPUNIT_ASSERT_THROW(Geometry("8x65x32x100"), runtime_error);
+	Geometry ways("8x3x32x100");
+	CPPUNIT_ASSERT_MESSAGE("Any way count up to 64 is valid",
+			       ways.ways == 3);
+}
+
+void
+SweepFactoryTest::readGeometries()
+{
+	const char *path = "SweepFactoryTest.geom";
+	ofstream out(path);
+	out << "# sets x ways x line x memory [x hit]" << endl
+	    << "8x1x32x100" << endl
+	    << endl
+	    << "  4x2x16x50x2  trailing words are ignored" << endl;
+	out.close();
+
+	CFG cfg;
+	SweepFactory sweep(cfg, 0);
+	sweep.readGeometries(path, 4);
+	CPPUNIT_ASSERT(sweep.geometries().size() == 2);
+	CPPUNIT_ASSERT(sweep.geometries()[0].str() == "8x1x32x100x4");
+	CPPUNIT_ASSERT(sweep.geometries()[1].str() == "4x2x16x50x2");
+
+	out.open(path);
+	out << "8x1x32x100" << endl << "12x1x32x100" << endl;
+	out.close();
+	SweepFactory bad(cfg, 0);
+	CPPUNIT_ASSERT_THROW(bad.readGeometries(path, 1), runtime_error);
+	remove(path);
+
+	CPPUNIT_ASSERT_THROW(bad.readGeometries(path, 1), runtime_error);
+}
@@ -0,0 +1,23 @@
+#ifndef SWEEP_FACTORY_TEST_H
+#define SWEEP_FACTORY_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SweepFactory.h"
+
+class SweepFactoryTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(SweepFactoryTest);
+	CPPUNIT_TEST(geometry);
+	CPPUNIT_TEST(invalid);
+	CPPUNIT_TEST(readGeometries);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp();
+	void tearDown();
+
+	void geometry();
+	void invalid();
+	void readGeometries();
+};
+
+#endif /* SWEEP_FACTORY_TEST_H */
@@ -0,0 +1,102 @@
+#include "TraceTest.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TraceTest);
+
+static const char *trace_path = "TraceTest.log";
+
+/* Counts the calls, to see if trace arguments are evaluated */
+static int
+counted(int &calls) {
+	return ++calls;
+}
+
+void
+TraceTest::setUp()
+{
+	Trace::reset();
+}
+
+void
+TraceTest::tearDown()
+{
+	Trace::reset();
+	remove(trace_path);
+}
+
+void
+TraceTest::configure()
+{
+	CPPUNIT_ASSERT(Trace::level("cfrg") == TRACE_OFF);
+
+	Trace::configure("cfrg:info,wceto");
+	CPPUNIT_ASSERT(Trace::level("cfrg") == TRACE_INFO);
+	CPPUNIT_ASSERT(Trace::level("wceto") == TRACE_DEBUG);
+	CPPUNIT_ASSERT(Trace::level("cfr") == TRACE_OFF);
+	CPPUNIT_ASSERT(Trace::enabled("cfrg", TRACE_INFO));
+	CPPUNIT_ASSERT(!Trace::enabled("cfrg", TRACE_DEBUG));
+
+	/* Later entries win */
+	Trace::configure("all:info,cfr:off");
+	CPPUNIT_ASSERT(Trace::level("wceto") == TRACE_INFO);
+	CPPUNIT_ASSERT(Trace::level("cfr") == TRACE_OFF);
+
+	CPPUNIT_ASSERT_THROW(Trace::configure("nothing"), runtime_error);
+	CPPUNIT_ASSERT_THROW(Trace::configure("cfr:loud"), runtime_error);
+}
+
+void
+TraceTest::file()
+{
+	Trace::configure("cfrg:info");
+	DBG dbg("cfrg");
+	TraceFile tf;
+	tf.open(trace_path, "cfrg", TRACE_INFO);
+	CPPUNIT_ASSERT(tf.on());
+
+	dbg.inc("test: ");
+	for (int i = 0; i < 10000; i++) {
+		DBG_OUT(dbg, TRACE_INFO) << "line " << i << endl;
+		/* Not at this level */
+		DBG_OUT(dbg, TRACE_DEBUG) << "detail " << i << endl;
+		dbg.flush(tf);
+	}
+	dbg.dec();
+	TRACE_OUT(tf) << "last" << endl;
+	tf.close();
+	CPPUNIT_ASSERT(!tf.on());
+
+	ifstream in(trace_path);
+	string line, last;
+	int lines = 0;
+	while (getline(in, line)) {
+		CPPUNIT_ASSERT(line.find("detail") == string::npos);
+		last = line;
+		lines++;
+	}
+	CPPUNIT_ASSERT(lines == 10001);
+	CPPUNIT_ASSERT(last == "last");
+}
+
+void
+TraceTest::disabled()
+{
+	DBG dbg("cfrg");
+	TraceFile tf;
+	tf.open(trace_path, "cfrg", TRACE_INFO);
+	CPPUNIT_ASSERT(!tf.on());
+	CPPUNIT_ASSERT(!dbg.on(TRACE_INFO));
+
+	int calls = 0;
+	DBG_OUT(dbg, TRACE_INFO) << counted(calls) << endl;
+	DBG_BUF(dbg, TRACE_INFO) << counted(calls) << endl;
+	TRACE_OUT(tf) << counted(calls) << endl;
+	CPPUNIT_ASSERT(calls == 0);
+	CPPUNIT_ASSERT(dbg.buf.str().empty());
+
+	/* Nothing was created */
+	ifstream in(trace_path);
+	CPPUNIT_ASSERT(!in);
+}
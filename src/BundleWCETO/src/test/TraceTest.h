@@ -0,0 +1,24 @@
+#ifndef TRACE_TEST_H
+#define TRACE_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Trace.h"
+#include "DBG.h"
+
+class TraceTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(TraceTest);
+	CPPUNIT_TEST(configure);
+	CPPUNIT_TEST(file);
+	CPPUNIT_TEST(disabled);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp();
+	void tearDown();
+
+	void configure();
+	void file();
+	void disabled();
+};
+
+#endif /* TRACE_TEST_H */
@@ -0,0 +1,95 @@
+#include "WCETOFactoryTest.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WCETOFactoryTest);
+
+void
+WCETOFactoryTest::setUp()
+{
+	cache = new Cache(32, 2, 32, 10, 100, &lru);
+	cfg = new CFG();
+	ListDigraph::Node a = cfg->addNode();
+	cfg->setInitial(a);
+	cfg->setAddr(a, 0x4000);
+
+	cfr_fact = new CFRFactory(*cfg, *cache);
+	cfr = cfr_fact->produce().begin()->second;
+	/* The predecessors are only keys of the merged maps */
+	members = new CFRMembers(*cfg);
+	pa = new CFR(*cfg, *members);
+	pb = new CFR(*cfg, *members);
+}
+
+void
+WCETOFactoryTest::tearDown()
+{
+	delete pa;
+	delete pb;
+	delete members;
+	delete cfr_fact;
+	delete cfg;
+	delete cache;
+}
+
+void
+WCETOFactoryTest::maxMerge()
+{
+	WCETOFactory fact(*cfr_fact->getCFRG(), 4, 0);
+	CFRDemand dem(*cfr);
+	ThreadWCETOMap &twmap = dem.getWCETOMap();
+	for (uint32_t i = 1; i <= 4; i++) {
+		twmap[i] = 1;
+	}
+	ThreadWCETOMap a, b;
+	a[1] = 10;
+	a[2] = 3;
+	b[1] = 7;
+	b[2] = 5;
+	b[3] = 2;
+	PredMaps preds;
+	preds[pa] = &a;
+	preds[pb] = &b;
+
+	/* Threads take 10, 7, 5 and 3 */
+	fact.maxMerge(dem, preds, true);
+	CPPUNIT_ASSERT(twmap.get(1) == 11);
+	CPPUNIT_ASSERT(twmap.get(2) == 8);
+	CPPUNIT_ASSERT(twmap.get(3) == 6);
+	CPPUNIT_ASSERT(twmap.get(4) == 4);
+	CPPUNIT_ASSERT_MESSAGE("The predecessor maps are left untouched",
+			       a.get(1) == 10 && b.get(3) == 2);
+}
+
+void
+WCETOFactoryTest::maxMergeExhausted()
+{
+	/* Every predecessor delta is used before the last thread */
+	WCETOFactory fact(*cfr_fact->getCFRG(), 5, 0);
+	CFRDemand dem(*cfr);
+	ThreadWCETOMap &twmap = dem.getWCETOMap();
+	twmap[1] = 4;
+	ThreadWCETOMap a, b;
+	a[1] = 9;
+	/* A zero delta is skipped, b[6] is past the thread count */
+	b[2] = 6;
+	b[6] = 2;
+	PredMaps preds;
+	preds[pa] = &a;
+	preds[pb] = &b;
+
+	fact.maxMerge(dem, preds, true);
+	CPPUNIT_ASSERT(twmap.get(1) == 13);
+	CPPUNIT_ASSERT(twmap.get(2) == 6);
+	CPPUNIT_ASSERT(twmap.get(3) == 0);
+	CPPUNIT_ASSERT(twmap.get(5) == 0);
+
+	/* Predecessors without any delta */
+	ThreadWCETOMap empty, zeros;
+	zeros[1] = 0;
+	zeros[2] = 0;
+	PredMaps none;
+	none[pa] = &empty;
+	none[pb] = &zeros;
+	fact.maxMerge(dem, none, true);
+	CPPUNIT_ASSERT(twmap.get(1) == 13 && twmap.get(2) == 6);
+	CPPUNIT_ASSERT(twmap.get(3) == 0);
+}
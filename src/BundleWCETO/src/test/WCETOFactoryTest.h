@@ -0,0 +1,30 @@
+#ifndef WCETOFACTORY_TEST_H
+#define WCETOFACTORY_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CFRFactory.h"
+#include "PolicyLRU.h"
+#include "WCETOFactory.h"
+
+class WCETOFactoryTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(WCETOFactoryTest);
+	CPPUNIT_TEST(maxMerge);
+	CPPUNIT_TEST(maxMergeExhausted);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp();
+	void tearDown();
+
+	void maxMerge();
+	void maxMergeExhausted();
+private:
+	PolicyLRU lru;
+	Cache *cache;
+	CFG *cfg;
+	CFRFactory *cfr_fact;
+	CFRMembers *members;
+	CFR *cfr, *pa, *pb;
+};
+
+#endif /* WCETOFACTORY_TEST_H */
@@ -65,10 +65,28 @@ namespace cfglib
     /*! Loops of this Cfg */
     std::vector<Loop*> loops ;
 
+    /*! true when the per-node adjacency lists do not reflect `edges`
+     * (edges whose ends are not resolved yet, after unserialisation
+     * or cloning). */
+    bool adjacency_stale ;
+
   private:
     /*! Create an uninitialised Edge */
     Edge* CreateNewEdge() ;
 
+    /*! Records an edge in the adjacency lists of its end nodes */
+    void LinkEdge(Edge* e) ;
+
+    /*! Removes an edge from the adjacency lists of its end nodes */
+    void UnlinkEdge(Edge* e) ;
+
+    /*! Rebuilds the adjacency lists of every node from `edges` if
+     * they are stale. */
+    void RebuildAdjacency() ;
+
+    /*! Loops redirect edges in place when peeled. */
+    friend class Loop;
+
   public:
     /*! Basic constructor. */
     // Cfg(Program* program, std::string name); 
@@ -169,20 +187,24 @@ namespace cfglib
     /*! Set an existing node as an end node. */
     void SetEndNode(Node* node);
 
-    /*! Return the incoming edges of a node. */
-    std::vector<Edge*> GetIncomingEdges(Node* node);
+    /*! Return the incoming edges of a node. The returned
+     * reference is invalidated by any edge modification. */
+    const std::vector<Edge*>& GetIncomingEdges(Node* node);
 
-    /*! Return the predecessors of a node. */
-    std::vector<Node*> GetPredecessors(Node* node);
+    /*! Return the predecessors of a node. The returned
+     * reference is invalidated by any edge modification. */
+    const std::vector<Node*>& GetPredecessors(Node* node);
 
-    /*! Return the edges outgoing from a node. */
-    std::vector<Edge*> GetOutgoingEdges(Node* node);
+    /*! Return the edges outgoing from a node. The returned
+     * reference is invalidated by any edge modification. */
+    const std::vector<Edge*>& GetOutgoingEdges(Node* node);
 
     /*! Return the successors of a node. The successors vector
      * is empty if you pass an end Node. Function call are
      * simple Nodes, the successor of a function call Node
-     * is the next basic block in the caller Cfg. */
-    std::vector<Node*> GetSuccessors(Node* node);
+     * is the next basic block in the caller Cfg. The returned
+     * reference is invalidated by any edge modification. */
+    const std::vector<Node*>& GetSuccessors(Node* node);
 
     /*! Return the origin of an edge */
     Node* GetSourceNode(Edge* edge);
@@ -42,6 +42,7 @@ namespace cfglib
 {
   /* #includes and forward declarations : */
   class Cfg ; // cf. cfg/cfg.h
+  class Edge ; // cf. cfg/edge.h
 
   /*! possible Node types */
   enum node_type { BB, Call } ;
@@ -83,6 +84,14 @@ namespace cfglib
     /*! Instruction list */
     std::vector<Instruction*> instructions ;
 
+    /*! Incoming and outgoing edges of this node, and the matching
+     * predecessor and successor nodes. Maintained by the owning Cfg,
+     * see Cfg::RebuildAdjacency(). */
+    std::vector<Edge*> in_edges ;
+    std::vector<Edge*> out_edges ;
+    std::vector<Node*> predecessors ;
+    std::vector<Node*> successors ;
+
     /*! Constructor. This constructor is private
      * and meaned to be only called via friend
      * `Cfg::CreateNode()` */
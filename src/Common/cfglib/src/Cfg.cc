@@ -26,6 +26,7 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <algorithm>
 #include "Helper.h"
 #include "Handle.h"
 #include "Cfg.h"
@@ -35,12 +36,13 @@
 /*! this namespace is the global namespace */
 namespace cfglib {
   Cfg::Cfg(Program* program, ListOfString name) :
-    program(program), name(name), external(true), startNode(0) {
+    program(program), name(name), external(true), startNode(0),
+    adjacency_stale(false) {
   }
 
   //TP
   /*! constructor for a free Cfg (used in clone function) */
-  Cfg::Cfg(ListOfString name) : name(name) {}
+  Cfg::Cfg(ListOfString name) : name(name), adjacency_stale(true) {}
 
   //TP
   /*! Cloning function */
@@ -184,6 +186,7 @@ namespace cfglib {
   Edge* Cfg::CreateNewEdge(Node* origin, Node* destination) {
     Edge* pE_created = new Edge(origin, destination, this);
     this->edges.push_back(pE_created) ;
+    LinkEdge(pE_created);
     return pE_created;
   }
 
@@ -193,6 +196,7 @@ namespace cfglib {
     for (std::vector<Edge*>::iterator it = this->edges.begin() ; it
 	   != this->edges.end() ; it++) {
       if ((*it) == e) {
+	UnlinkEdge(e);
 	delete e;
 	this->edges.erase(it);
 	return;
@@ -206,6 +210,7 @@ namespace cfglib {
     for (std::vector<Edge*>::iterator it = this->edges.begin() ; it
 	   != this->edges.end() ; it++) {
       if ((*it) == e) {
+	UnlinkEdge(e);
 	this->edges.erase(it);
 	return;
       }
@@ -216,16 +221,74 @@ namespace cfglib {
    * to use with edges removed by RemoveEdgeNoDelete */
   void Cfg::putEdge(Edge* E){
     this->edges.push_back(E);
+    LinkEdge(E);
   }
 
 
-  /*! internal function for adding a Edge not-initialised */
+  /*! internal function for adding a Edge not-initialised. Its ends
+   * are resolved later, so the adjacency lists are rebuilt on the
+   * next query. */
   Edge* Cfg::CreateNewEdge() {
     Edge* pE_created = new Edge();
     this->edges.push_back(pE_created) ;
+    this->adjacency_stale = true;
     return pE_created;
   }
 
+  /*! Records an edge in the adjacency lists of its end nodes. Nothing
+   * to do while the lists are stale, they are rebuilt from `edges`. */
+  void Cfg::LinkEdge(Edge* e) {
+    if (this->adjacency_stale) {
+      return;
+    }
+    e->origin->out_edges.push_back(e);
+    e->origin->successors.push_back(e->destination);
+    e->destination->in_edges.push_back(e);
+    e->destination->predecessors.push_back(e->origin);
+  }
+
+  /*! Removes an edge from the adjacency lists of its end nodes, the
+   * order of the remaining edges is kept. */
+  void Cfg::UnlinkEdge(Edge* e) {
+    if (this->adjacency_stale) {
+      return;
+    }
+    Node* origin = e->origin;
+    std::vector<Edge*>::iterator oit =
+      std::find(origin->out_edges.begin(), origin->out_edges.end(), e);
+    assert(oit != origin->out_edges.end());
+    origin->successors.erase(origin->successors.begin() +
+			     (oit - origin->out_edges.begin()));
+    origin->out_edges.erase(oit);
+
+    Node* destination = e->destination;
+    std::vector<Edge*>::iterator iit =
+      std::find(destination->in_edges.begin(), destination->in_edges.end(), e);
+    assert(iit != destination->in_edges.end());
+    destination->predecessors.erase(destination->predecessors.begin() +
+				    (iit - destination->in_edges.begin()));
+    destination->in_edges.erase(iit);
+  }
+
+  /*! Rebuilds the adjacency lists of every node from `edges`, in
+   * edge order, if they are stale. */
+  void Cfg::RebuildAdjacency() {
+    if (!this->adjacency_stale) {
+      return;
+    }
+    for (std::vector<Node*>::iterator it = this->nodes.begin(); it != this->nodes.end(); it++) {
+      (*it)->in_edges.clear();
+      (*it)->out_edges.clear();
+      (*it)->predecessors.clear();
+      (*it)->successors.clear();
+    }
+    this->adjacency_stale = false;
+    for (std::vector<Edge*>::iterator it = this->edges.begin(); it != this->edges.end(); it++) {
+      assert((*it)->origin != NULL && (*it)->destination != NULL);
+      LinkEdge(*it);
+    }
+  }
+
   /*! internal function for deserialisation of Loops */
   Loop* Cfg::CreateNewLoop() {
     Loop* new_loop = new Loop();
@@ -251,6 +314,15 @@ namespace cfglib {
   /*! Get the Edge between the two argument nodes. Return NULL if
    * there is no such Edge */
   Edge* Cfg::FindEdge(Node const* origin, Node const* destination) const {
+    if (!this->adjacency_stale) {
+      for (std::vector<Edge*>::const_iterator it = origin->out_edges.begin() ; it
+	     != origin->out_edges.end() ; it++) {
+	if ((*it)->destination == destination) {
+	  return (*it);
+	}
+      }
+      return 0;
+    }
     for (std::vector<Edge*>::const_iterator it = this->edges.begin() ; it
 	   != this->edges.end() ; it++) {
       if (((*it)->destination == destination) && ((*it)->origin == origin )) {
@@ -293,53 +365,28 @@ namespace cfglib {
   }
 
   /*! Return the incoming edges of a node. */
-  std::vector<Edge*> Cfg::GetIncomingEdges(Node* node) {
-    std::vector<Edge*> incomingEdges;
-    for (std::vector<Edge*>::iterator it = this->edges.begin() ; it
-	   != this->edges.end() ; it++) {
-      if ((*it)->destination == node) {
-	incomingEdges.push_back(*it) ;
-      }
-    }
-    return incomingEdges;
+  const std::vector<Edge*>& Cfg::GetIncomingEdges(Node* node) {
+    RebuildAdjacency();
+    return node->in_edges;
   }
 
   /*! Return the predecessors of a node. */
-  std::vector<Node*> Cfg::GetPredecessors(Node* node) 
+  const std::vector<Node*>& Cfg::GetPredecessors(Node* node) 
   {
-    std::vector<Node*> pred;
-    for (std::vector<Edge*>::const_iterator it = this->edges.begin() ; it != this->edges.end() ; it++) 
-      {
-	if ((*it)->destination == node) {
-	  pred.push_back((*it)->origin) ;
-	}
-      }
-    return pred;
+    RebuildAdjacency();
+    return node->predecessors;
   }
 
   /*! Return the edges outgoing from a node. */
-  std::vector<Edge*> Cfg::GetOutgoingEdges(Node* node) {
-    std::vector<Edge*> outEdges;
-    for (std::vector<Edge*>::iterator it = this->edges.begin() ; it != this->edges.end() ; it++) 
-      {
-      if ((*it)->origin == node) {
-	outEdges.push_back(*it) ;
-      }
-    }
-    return outEdges;
+  const std::vector<Edge*>& Cfg::GetOutgoingEdges(Node* node) {
+    RebuildAdjacency();
+    return node->out_edges;
   }
 
   /*! Return the successors of a node. */
-  std::vector<Node*> Cfg::GetSuccessors(Node* node) {
-    std::vector<Node*> succ;
-    for (std::vector<Edge*>::const_iterator it = this->edges.begin() ; 
-	 it != this->edges.end() ; 
-	 it++) {
-      if ((*it)->origin == node) {
-	succ.push_back((*it)->destination) ;
-      }
-    }
-    return succ;
+  const std::vector<Node*>& Cfg::GetSuccessors(Node* node) {
+    RebuildAdjacency();
+    return node->successors;
   }
 
   /*! Return the origin of an edge */
@@ -322,6 +322,7 @@ namespace cfglib
       if (e->destination == head && origin_it == temp.end()) {
         //	cout << "Incoming edge " << e->origin << " -> " << e->destination << endl;
 	e->destination = temp[head];
+	cfg->adjacency_stale = true;
 	continue;
       }
 
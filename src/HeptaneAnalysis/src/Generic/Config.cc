@@ -276,7 +276,7 @@ Analysis* Config::mkAnalyzerObject(string directive, Program *p, ParamAnalysis *
       // FIXME: nice error handling
       assert (cp != NULL);
       if (ps->level > MaxLevelCacheAnalysis) MaxLevelCacheAnalysis=ps->level;
-      return new ICacheAnalysis (p, cp->nbsets, cp->nbways, cp->cachelinesize, cp->replacement_policy, ps->level, ps->apply_must, ps->apply_persistence, ps->apply_may, ps->keep_age);
+      return new ICacheAnalysis (p, cp->nbsets, cp->nbways, cp->cachelinesize, cp->replacement_policy, ps->level, ps->apply_must, ps->apply_persistence, ps->apply_may, ps->keep_age, ps->nb_threads);
     }
 
   if (directive == "DATAADDRESS") 
@@ -292,7 +292,7 @@ Analysis* Config::mkAnalyzerObject(string directive, Program *p, ParamAnalysis *
       // FIXME: nice error handling
       assert (cp != NULL);
       if (ps->level > MaxLevelCacheAnalysis) MaxLevelCacheAnalysis=ps->level;
-      return new DCacheAnalysis (p, cp->nbsets, cp->nbways, cp->cachelinesize, cp->replacement_policy, ps->level, ps->apply_must, ps->apply_persistence, ps->apply_may);
+      return new DCacheAnalysis (p, cp->nbsets, cp->nbways, cp->cachelinesize, cp->replacement_policy, ps->level, ps->apply_must, ps->apply_persistence, ps->apply_may, ps->nb_threads);
     }
   if (directive == "PIPELINE")
     {
@@ -304,7 +304,7 @@ Analysis* Config::mkAnalyzerObject(string directive, Program *p, ParamAnalysis *
   if (directive == "IPET")
     {
       ParamIPET *ps = (ParamIPET *) pa;
-      return new IPETAnalysis (p, ps->m, ps->solver, ps->attach_WCET_info, ps->generate_node_freq, getNbICacheLevels (), getNbDCacheLevels (), cache_latencies, ps->latICache, ps->latDCache);
+      return new IPETAnalysis (p, ps->m, ps->solver, ps->attach_WCET_info, ps->generate_node_freq, getNbICacheLevels (), getNbDCacheLevels (), cache_latencies, ps->latICache, ps->latDCache, ps->ilp_file);
     }
 
   // Already testesd before in getParameters() ?
@@ -685,6 +685,10 @@ ParamICache::ParamICache (XmlTag const &tag):
   s = tag.getAttributeString ("keep_age");
   assert (s == "on" || s == "off");
   this->keep_age = (s == "on");
+
+  // optional, 0 (not set) or 1 for the sequential fixed points
+  this->nb_threads = tag.getAttributeInt ("threads");
+  assert (nb_threads >= 0);
 }
 
 ParamDCache::ParamDCache (XmlTag const &tag):
@@ -704,6 +708,10 @@ ParamDCache::ParamDCache (XmlTag const &tag):
   s = tag.getAttributeString ("may");
   assert (s == "on" || s == "off");
   this->apply_may = (s == "on");
+
+  // optional, 0 (not set) or 1 for the sequential fixed points
+  this->nb_threads = tag.getAttributeInt ("threads");
+  assert (nb_threads >= 0);
 }
 
 // Data address extraction
@@ -738,12 +746,16 @@ ParamIPET::ParamIPET (XmlTag const &tag):
   this->generate_node_freq = (s == "true");
 
   s = tag.getAttributeString ("solver");
-  assert (s == "cplex" || s == "lp_solve");
+  assert (s == "cplex" || s == "lp_solve" || s == "lp_solve_lib");
   if (s == "cplex")
     this->solver = CPLEX;
+  else if (s == "lp_solve_lib")
+    this->solver = LP_SOLVE_LIB;
   else
     this->solver = LP_SOLVE;
 
+  this->ilp_file = tag.getAttributeString ("ilp_file");
+
   ListXmlTag lt = tag.searchChildren ("METHOD");
   assert(lt.size () == 1);
   XmlTag method = lt[0];
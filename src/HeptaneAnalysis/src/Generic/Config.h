@@ -63,6 +63,7 @@ using namespace cfglib;
 /** Solver */
 #define LP_SOLVE 0
 #define CPLEX 1
+#define LP_SOLVE_LIB 2
 
 /** Supported architectures */
 
@@ -279,6 +280,7 @@ class ParamICache:public ParamAnalysis
 public:
   int level;
   bool apply_must, apply_persistence, apply_may, keep_age;
+  int nb_threads;
     ParamICache (XmlTag const &tag);
 };
 class ParamDCache:public ParamAnalysis
@@ -286,6 +288,7 @@ class ParamDCache:public ParamAnalysis
 public:
   int level;
   bool apply_must, apply_persistence, apply_may;
+  int nb_threads;
     ParamDCache (XmlTag const &tag);
 };
 
@@ -314,6 +317,7 @@ public:
   int m; // method
   int latDCache, latICache;
   int solver;
+  string ilp_file; // dump of the ILP system, none if empty (lp_solve_lib)
   bool attach_WCET_info;
   bool generate_node_freq;
     ParamIPET (XmlTag const &tag);
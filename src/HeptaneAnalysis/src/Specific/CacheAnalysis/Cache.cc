@@ -28,14 +28,124 @@
 
 
 #include <iostream>
-#include <map>
-#include <utility>
+#include <iterator>
+#include <algorithm>
 #include <cassert>
 
 #include "Cache.h"
 
 using namespace std;
 
+/**************************************************
+ *
+ *  Sorted lines helpers
+ *
+ *************************************************/
+
+/** Compares the tag of a line of an abstract cache set with an address (see lower_bound) */
+struct LineTagLess
+{
+  bool operator() (const AgedLine & l, t_address tag) const { return l.tag < tag; }
+  bool operator() (const PSLine & l, t_address tag) const { return l.tag < tag; }
+};
+
+/** @return the position of the line tag in lines, lines.size() if absent */
+template < typename L > static size_t
+findLine (const vector < L > &lines, t_address tag)
+{
+  typename vector < L >::const_iterator it = lower_bound (lines.begin (), lines.end (), tag, LineTagLess ());
+  if (it != lines.end () && it->tag == tag) { return it - lines.begin (); }
+  return lines.size ();
+}
+
+/** Sets the age of the line tag to 0, the line is inserted if absent */
+static void
+setMRU (vector < AgedLine > &lines, t_address tag)
+{
+  vector < AgedLine >::iterator it = lower_bound (lines.begin (), lines.end (), tag, LineTagLess ());
+  if (it != lines.end () && it->tag == tag)
+    {
+      it->age = 0;
+      return;
+    }
+  AgedLine l;
+  l.tag = tag;
+  l.age = 0;
+  lines.insert (it, l);
+}
+
+/** Increments the age of the lines younger than age, the lines reaching nb_ways are removed */
+static void
+ageLines (vector < AgedLine > &lines, unsigned int age, unsigned int nb_ways)
+{
+  size_t w = 0;
+  for (size_t r = 0; r < lines.size (); r++)
+    {
+      AgedLine l = lines[r];
+      l.age += (l.age < age);
+      lines[w] = l;
+      w += (l.age < nb_ways);
+    }
+  lines.resize (w);
+}
+
+/** Print the lines of a MUST or MAY abstract cache set, age by age */
+static void
+printAgedLines (const vector < AgedLine > &lines, unsigned int nb_ways)
+{
+  cout << hex;
+
+  for (unsigned int i = 0; i < nb_ways; i++)
+    {
+      cout << "{";
+      bool first = true;
+      for (size_t l = 0; l < lines.size (); l++)
+	{
+	  if (lines[l].age != i) { continue; }
+	  if (!first) { cout << ","; }
+	  cout << lines[l].tag;
+	  first = false;
+	}
+      cout << "}";
+      if (i + 1 < nb_ways) { cout << " | "; }
+    }
+  cout << endl << dec;
+}
+
+/** @return true if the sorted vector v contains a */
+static bool
+containsSorted (const vector < t_address > &v, t_address a)
+{
+  return binary_search (v.begin (), v.end (), a);
+}
+
+/** Inserts a in the sorted vector v */
+static void
+insertSorted (vector < t_address > &v, t_address a)
+{
+  vector < t_address >::iterator it = lower_bound (v.begin (), v.end (), a);
+  if (it == v.end () || *it != a) { v.insert (it, a); }
+}
+
+/** Removes a from the sorted vector v */
+static void
+eraseSorted (vector < t_address > &v, t_address a)
+{
+  vector < t_address >::iterator it = lower_bound (v.begin (), v.end (), a);
+  if (it != v.end () && *it == a) { v.erase (it); }
+}
+
+/** Inserts the sorted range [first, last) in the sorted vector v */
+template < typename It > static void
+unionSorted (vector < t_address > &v, It first, It last)
+{
+  if (first == last) { return; }
+  vector < t_address > result;
+  result.reserve (v.size () + distance (first, last));
+  set_union (v.begin (), v.end (), first, last, back_inserter (result));
+  v.swap (result);
+}
+
 /**************************************************
  *
  *  MUST implementation
@@ -47,7 +157,6 @@ MUST::MUST (unsigned int nbways, unsigned int nbways_removed)
 {
   nb_ways = nbways;
   nb_ways_removed = nbways_removed;
-  contents.resize (nb_ways);
 }
 
 /** returns true if the cache line containing addr is absent from the abstract cache set and false otherwise */
@@ -64,33 +173,15 @@ MUST::Absent (t_address addr) const
 unsigned int
 MUST::GetAge (t_address addr) const
 {
-  for (unsigned int i = 0; i < nb_ways; i++)
-    {
-      if (contents[i].find (addr) != contents[i].end ()) { return i; }
-    }
-  return nb_ways + nb_ways_removed;
+  size_t i = findLine (lines, addr);
+  return (i < lines.size ()) ? lines[i].age : nb_ways + nb_ways_removed;
 }
 
 /** Print the Abstract Cache Set for debugging purpose */
 void
 MUST::Print () const
 {
-  cout << hex;
-
-  for (unsigned int i = 0; i < nb_ways; i++)
-    {
-      cout << "{";
-      unsigned int cpt = 0;
-      for (set < t_address >::const_iterator iter = contents[i].begin (); iter != contents[i].end (); iter++)
-	{
-	  cout << *iter;
-	  if (cpt + 1 != contents[i].size ()) { cout << ","; }
-	  cpt++;
-	}
-      cout << "}";
-      if (i + 1 < nb_ways) { cout << " | "; }
-    }
-  cout << endl << dec;
+  printAgedLines (lines, nb_ways);
 }
 
 /** Update function when only one address is accessed */
@@ -98,33 +189,13 @@ void
 MUST::Update (t_address addr)
 {
   assert (nb_ways > 0);
-  assert (contents[0].size () <= 1);
-
-  if (contents[0].find (addr) != contents[0].end ()) { return; } //nothing change in the set addr is alone in the first way
-
-  bool found = false;
-  int pos = nb_ways;
-  for (unsigned int i = 1; i < nb_ways && !found; i++)
-    {
-      if (contents[i].erase (addr) == 1)
-	{
-	  found = true;
-	  pos = i;
-	}
-    }
 
-  //The contents of way pos is merged with pos-1
-  if (found) { contents[pos].insert (contents[pos - 1].begin (), contents[pos - 1].end ()); }
+  unsigned int pos = GetAge (addr);
+  if (pos == 0) { return; } //nothing change in the set addr is alone in the first way
 
-  //update the age
-  for (int i = pos - 1; i > 0; i--) 
-    { 
-      contents[i] = contents[i - 1]; 
-    }
-
-  //insert addr as MRU
-  contents[0].clear ();
-  contents[0].insert (addr);
+  //the lines younger than addr get older, addr is inserted as MRU
+  ageLines (lines, pos, nb_ways);
+  setMRU (lines, addr);
 }
 
 /** Update function when a set of addresses is accessed
@@ -134,7 +205,6 @@ void
 MUST::Update (const set < t_address > &addrs)
 {
   assert (nb_ways > 0);
-  assert (contents[0].size () <= 1);
 
   unsigned int max_age = 0;
   // Find max_age: the age of the oldest accessed block.
@@ -146,16 +216,8 @@ MUST::Update (const set < t_address > &addrs)
   // only one line in addrs at the MRU position (the cache set is unchanged)
   if (max_age == 0) { return; } 
 
-  if (max_age < nb_ways) { contents[max_age].insert (contents[max_age - 1].begin (), contents[max_age - 1].end ()); }
-
-  //update the age
-  for (unsigned int i = min (max_age, nb_ways) - 1; i > 0; i--)
-    {
-      contents[i] = contents[i - 1];
-    }
-
-  //clear the MRU position
-  contents[0].clear ();
+  //the lines younger than max_age get older, the MRU position is left empty
+  ageLines (lines, max_age, nb_ways);
 }
 
 /** Join function */
@@ -164,47 +226,25 @@ MUST::Join (const MUST & c)
 {
   assert (nb_ways == c.nb_ways);
 
-  set < t_address > intersect;
-
-  //build the resulting ACS
-  vector < set < t_address > >result;
-  result.resize (nb_ways);
-
-  //compute the addr present in both ACS and keep there maximal age
-  for (unsigned int i = 0; i < nb_ways; i++)
+  //keep the lines present in both ACS with their maximal age
+  vector < AgedLine > result;
+  size_t i = 0, j = 0;
+  while (i < lines.size () && j < c.lines.size ())
     {
-      for (set < t_address >::const_iterator iter = contents[i].begin (); iter != contents[i].end (); iter++)
-	{
-	  set < t_address >::iterator search = intersect.find (*iter);
-
-	  if (search != intersect.end ())	//already in the other cache, thus i is the maximal age
-	    {
-	      result[i].insert (*iter);
-	      intersect.erase (search);
-	    }
-	  else
-	    {
-	      intersect.insert (*iter);
-	    }
-	}
-
-      for (set < t_address >::const_iterator iter = c.contents[i].begin (); iter != c.contents[i].end (); iter++)
+      const AgedLine & a = lines[i];
+      const AgedLine & b = c.lines[j];
+      if (a.tag == b.tag)
 	{
-	  set < t_address >::iterator search = intersect.find (*iter);
-
-	  if (search != intersect.end ())	//already in the other cache, thus i is the maximal age
-	    {
-	      result[i].insert (*iter);
-	      intersect.erase (search);
-	    }
-	  else
-	    {
-	      intersect.insert (*iter);
-	    }
+	  AgedLine l;
+	  l.tag = a.tag;
+	  l.age = max (a.age, b.age);
+	  result.push_back (l);
 	}
+      i += (a.tag <= b.tag);
+      j += (b.tag <= a.tag);
     }
 
-  contents.swap (result);
+  lines.swap (result);
 }
 
 /** returns true if this is equal to c and false otherwise */
@@ -212,7 +252,7 @@ bool
 MUST::Equals (const MUST & c) const
 {
   assert (nb_ways == c.nb_ways);
-  return this->contents == c.contents;
+  return this->lines == c.lines;
 }
 
 /**************************************************
@@ -225,83 +265,33 @@ MUST::Equals (const MUST & c) const
 MAY::MAY (unsigned int nbways)
 {
   nb_ways = nbways;
-  contents.resize (nb_ways);
 }
 
 /** returns true if the cache line containing addr is absent from the abstract cache set and false otherwise */
 bool
 MAY::Absent (t_address addr) const
 {
-  for (unsigned int i = 0; i < nb_ways; i++)
-    {
-      if (contents[i].find (addr) != contents[i].end ()) { return false; }
-    }
-  return true;
+  return findLine (lines, addr) == lines.size ();
 }
 
 /** Print the Abstract Cache Set for debugging purpose */
 void
 MAY::Print () const
 {
-  cout << hex;
-
-  for (unsigned int i = 0; i < nb_ways; i++)
-    {
-      cout << "{";
-      unsigned int cpt = 0;
-      for (set < t_address >::iterator iter = contents[i].begin (); iter != contents[i].end (); iter++)
-	{
-	  cout << *iter;
-	  if (cpt + 1 != contents[i].size ()) { cout << ","; }
-	  cpt++;
-	}
-      cout << "}";
-      if (i + 1 < nb_ways) { cout << " | "; }
-    }
-  cout << endl << dec;
+  printAgedLines (lines, nb_ways);
 }
 
 /** Update function when only one address is accessed */
 void
 MAY::Update (t_address addr)
 {
-  bool found = false;
-  int pos = nb_ways;
-
-  // Find the position of addr in the cache and remove it.
-  for (unsigned int i = 0; i < nb_ways && !found; i++)
-    {
-      if (contents[i].erase (addr) == 1)
-	{
-	  found = true;
-	  pos = i;
-	}
-    }
-
-  // Shift lines from the MRU to the position of addr in cache, or the LRU.
-  if (pos == 0)			//addr was found
-    {
-      if (nb_ways > 1 && contents[0].size () != 0)
-	{
-	  contents[1].insert (contents[0].begin (), contents[0].end ());
-	}
-    }
-  else
-    {
-      if (found)
-	{
-	  contents[pos].insert (contents[pos - 1].begin (), contents[pos - 1].end ());
-	}
+  size_t i = findLine (lines, addr);
+  unsigned int pos = (i < lines.size ()) ? lines[i].age : nb_ways;
 
-      for (int i = pos - 1; i > 0; --i)
-	{
-	  contents[i] = contents[i - 1];
-	}
-    }
-
-  // Set addr as the most recently used block.
-  contents[0].clear ();
-  contents[0].insert (addr);
+  // The lines younger than addr get older (the other MRU lines when addr is MRU),
+  // and addr is set as the most recently used block.
+  ageLines (lines, max (pos, 1u), nb_ways);
+  setMRU (lines, addr);
 }
 
 /** Update function when a set of addresses is accessed
@@ -310,20 +300,28 @@ MAY::Update (t_address addr)
 void
 MAY::Update (const set < t_address > &addrs)
 {
-  //remove addrs from the abstractCacheSet
-  for (set < t_address >::const_iterator it = addrs.begin (); it != addrs.end (); it++)
+  //set addrs at age 0, the other lines are unchanged
+  vector < AgedLine > result;
+  result.reserve (lines.size () + addrs.size ());
+  size_t i = 0;
+  set < t_address >::const_iterator it = addrs.begin ();
+  while (i < lines.size () || it != addrs.end ())
     {
-      for (unsigned int i = 0; i < nb_ways; i++)
+      if (it == addrs.end () || (i < lines.size () && lines[i].tag < *it))
 	{
-	  if (contents[i].erase (*it) == 1)
-	    {
-	      break;
-	    }
+	  result.push_back (lines[i]);
+	  i++;
+	  continue;
 	}
+      AgedLine l;
+      l.tag = *it;
+      l.age = 0;
+      result.push_back (l);
+      if (i < lines.size () && lines[i].tag == *it) { i++; }
+      it++;
     }
 
-  //add addrs at age 0
-  contents[0].insert (addrs.begin (), addrs.end ());
+  lines.swap (result);
 }
 
 /** Join function */
@@ -332,45 +330,25 @@ MAY::Join (const MAY & c)
 {
   assert (nb_ways == c.nb_ways);
 
-  set < t_address > intersect;
-
-  //build the resulting ACS
-  vector < set < t_address > >result;
-  result.resize (nb_ways);
-
-  //compute the addr present in both ACS and keep there minimal age
-  for (unsigned int i = 0; i < nb_ways; i++)
+  //keep the lines present in one of the ACS with their minimal age
+  vector < AgedLine > result;
+  result.reserve (lines.size () + c.lines.size ());
+  size_t i = 0, j = 0;
+  while (i < lines.size () && j < c.lines.size ())
     {
-      for (set < t_address >::const_iterator iter = contents[i].begin (); iter != contents[i].end (); iter++)
-	{
-	  set < t_address >::iterator search = intersect.find (*iter);
-	  if (search == intersect.end ())	//not present already thus i is the minimal age
-	    {
-	      result[i].insert (*iter);
-	      intersect.insert (*iter);
-	    }
-	  else
-	    {
-	      intersect.erase (search);
-	    }
-	}
-
-      for (set < t_address >::const_iterator iter = c.contents[i].begin (); iter != c.contents[i].end (); iter++)
-	{
-	  set < t_address >::iterator search = intersect.find (*iter);
-	  if (search == intersect.end ())	//not present already thus i is the minimal age
-	    {
-	      result[i].insert (*iter);
-	      intersect.insert (*iter);
-	    }
-	  else
-	    {
-	      intersect.erase (search);
-	    }
-	}
+      const AgedLine & a = lines[i];
+      const AgedLine & b = c.lines[j];
+      AgedLine l;
+      l.tag = min (a.tag, b.tag);
+      l.age = (a.tag == b.tag) ? min (a.age, b.age) : (a.tag < b.tag) ? a.age : b.age;
+      result.push_back (l);
+      i += (a.tag <= b.tag);
+      j += (b.tag <= a.tag);
     }
+  result.insert (result.end (), lines.begin () + i, lines.end ());
+  result.insert (result.end (), c.lines.begin () + j, c.lines.end ());
 
-  contents.swap (result);
+  lines.swap (result);
 }
 
 /** returns true if this is equal to c and false otherwise */
@@ -378,7 +356,7 @@ bool
 MAY::Equals (const MAY & c) const
 {
   assert (nb_ways == c.nb_ways);
-  return this->contents == c.contents;
+  return this->lines == c.lines;
 }
 
 
@@ -399,12 +377,12 @@ PS::PS (unsigned int nbways, unsigned int nbways_removed)
 bool
 PS::Absent (t_address addr) const
 {
-  map < t_address, set < t_address > >::const_iterator it_this = contents.find (addr);
-  if (it_this == contents.end ())
+  size_t i = findLine (lines, addr);
+  if (i == lines.size ())
     {
       return true;
     }
-  assert (it_this->second.size () < nb_ways);	//check for evicted
+  assert (lines[i].conflicts.size () < nb_ways);	//check for evicted
   return false;
 }
 
@@ -415,36 +393,36 @@ PS::Absent (t_address addr) const
 unsigned int
 PS::GetAge (t_address addr) const
 {
-  map < t_address, set < t_address > >::const_iterator it_this = contents.find (addr);
-  if (it_this == contents.end ())
+  size_t i = findLine (lines, addr);
+  if (i == lines.size ())
     {
       return nb_ways;
     }
-  assert (it_this->second.size () < nb_ways);	//check for evicted
-  return it_this->second.size () + nb_ways_removed;
+  assert (lines[i].conflicts.size () < nb_ways);	//check for evicted
+  return lines[i].conflicts.size () + nb_ways_removed;
 }
 
 /** Print the Abstract Cache Set for debugging purpose */
 void
 PS::Print () const
 {
-  for (map < t_address, set < t_address > >::const_iterator it = contents.begin (); it != contents.end (); it++)
+  for (size_t i = 0; i < lines.size (); i++)
     {
-      if (it != contents.begin ())
+      if (i != 0)
 	{
 	  cout << "|";
 	}
-      cout << "{" << hex << it->first << dec << ";" << it->second.size () << "}";	//{addr;#conflict}
+      cout << "{" << hex << lines[i].tag << dec << ";" << lines[i].conflicts.size () << "}";	//{addr;#conflict}
     }
 
   cout << " | [";
-  for (set < t_address >::const_iterator it = evicted.begin (); it != evicted.end (); it++)
+  for (size_t i = 0; i < evicted.size (); i++)
     {
-      if (it != evicted.begin ())
+      if (i != 0)
 	{
 	  cout << ",";
 	}
-      cout << *it;
+      cout << evicted[i];
     }
 
   cout << "]" << endl;
@@ -454,25 +432,41 @@ PS::Print () const
 void
 PS::Update (t_address addr)
 {
-  set < t_address > to_evict;
+  vector < t_address > to_evict;	//sorted, as lines
 
-  for (map < t_address, set < t_address > >::iterator it_this = contents.begin (); it_this != contents.end (); it_this++)
+  //add the conflict to all the lines, and remove the evicted ones
+  size_t w = 0;
+  for (size_t r = 0; r < lines.size (); r++)
     {
-      it_this->second.insert (addr);
-      if (it_this->second.size () == nb_ways)
+      insertSorted (lines[r].conflicts, addr);
+      if (lines[r].conflicts.size () >= nb_ways)
+	{
+	  to_evict.push_back (lines[r].tag);
+	  continue;
+	}
+      if (w != r)
 	{
-	  to_evict.insert (it_this->first);
+	  lines[w].tag = lines[r].tag;
+	  lines[w].conflicts.swap (lines[r].conflicts);
 	}
+      w++;
     }
+  lines.erase (lines.begin () + w, lines.end ());
+  unionSorted (evicted, to_evict.begin (), to_evict.end ());
 
-  for (set < t_address >::const_iterator it = to_evict.begin (); it != to_evict.end (); it++)
+  //addr has no conflict
+  vector < PSLine >::iterator it = lower_bound (lines.begin (), lines.end (), addr, LineTagLess ());
+  if (it != lines.end () && it->tag == addr)
     {
-      contents.erase (*it);
-      evicted.insert (*it);
+      it->conflicts.clear ();
     }
-
-  contents[addr].clear ();
-  evicted.erase (addr);
+  else
+    {
+      PSLine l;
+      l.tag = addr;
+      lines.insert (it, l);
+    }
+  eraseSorted (evicted, addr);
 }
 
 /** Update function when a set of addresses is accessed
@@ -481,49 +475,62 @@ PS::Update (t_address addr)
 void
 PS::Update (const set < t_address > &addrs)
 {
-  set < t_address > absent = addrs;	//used to determine the addrs not already present in the map
-  set < t_address > to_evict;	//use to determine the addrs evicted by this access 
+  vector < t_address > accessed (addrs.begin (), addrs.end ());
+  vector < t_address > absent;	//the addrs not already present in lines
+  vector < t_address > to_evict;	//use to determine the addrs evicted by this access 
 
-  //add the conflicts to all the addresses present in the cache before the access 
-  for (map < t_address, set < t_address > >::iterator it_this = contents.begin (); it_this != contents.end (); it_this++)
+  for (size_t i = 0; i < accessed.size (); i++)
     {
-      it_this->second.insert (addrs.begin (), addrs.end ());
-
-      if (addrs.find (it_this->first) != addrs.end ())
+      if (findLine (lines, accessed[i]) == lines.size () && !containsSorted (evicted, accessed[i]))
 	{
-	  it_this->second.erase (it_this->first);
-	  absent.erase (it_this->first);
+	  absent.push_back (accessed[i]);
 	}
+    }
 
-      if (it_this->second.size () >= nb_ways)
+  //add the conflicts to all the addresses present in the cache before the access 
+  size_t w = 0;
+  for (size_t r = 0; r < lines.size (); r++)
+    {
+      PSLine & l = lines[r];
+      unionSorted (l.conflicts, accessed.begin (), accessed.end ());
+      if (containsSorted (accessed, l.tag))
 	{
-	  to_evict.insert (it_this->first);
+	  eraseSorted (l.conflicts, l.tag);
 	}
-    }
 
-  //remove from absent addrs which are in the evicted set
-  for (set < t_address >::const_iterator it = evicted.begin (); it != evicted.end () && absent.size () > 0; it++)
-    {
-      absent.erase (*it);
+      if (l.conflicts.size () >= nb_ways)
+	{
+	  to_evict.push_back (l.tag);
+	  continue;
+	}
+      if (w != r)
+	{
+	  lines[w].tag = l.tag;
+	  lines[w].conflicts.swap (l.conflicts);
+	}
+      w++;
     }
+  lines.erase (lines.begin () + w, lines.end ());
 
   //insert addresses of addrs not present in the cache before this access
-  for (set < t_address >::iterator it = absent.begin (); it != absent.end (); it++)
+  for (size_t i = 0; i < absent.size (); i++)
     {
-      contents[*it].insert (addrs.begin (), addrs.end ());
-      contents[*it].erase (*it);
-      if (contents[*it].size () >= nb_ways)
+      PSLine l;
+      l.tag = absent[i];
+      l.conflicts = accessed;
+      eraseSorted (l.conflicts, absent[i]);
+      if (l.conflicts.size () >= nb_ways)
 	{
-	  to_evict.insert (*it);
+	  to_evict.push_back (absent[i]);
+	  continue;
 	}
+      vector < PSLine >::iterator it = lower_bound (lines.begin (), lines.end (), absent[i], LineTagLess ());
+      lines.insert (it, l);
     }
 
   //manage eviction
-  evicted.insert (to_evict.begin (), to_evict.end ());
-  for (set < t_address >::const_iterator it = to_evict.begin (); it != to_evict.end (); it++)
-    {
-      contents.erase (*it);
-    }
+  sort (to_evict.begin (), to_evict.end ());
+  unionSorted (evicted, to_evict.begin (), to_evict.end ());
 }
 
 /** Join function */
@@ -532,27 +539,55 @@ PS::Join (const PS & c)
 {
   assert (nb_ways == c.nb_ways);
 
-  //merge contents
-  for (map < t_address, set < t_address > >::const_iterator it_c = c.contents.begin (); it_c != c.contents.end (); it_c++)
+  vector < PSLine > result;
+  vector < t_address > to_evict;	//sorted, as lines
+  result.reserve (lines.size () + c.lines.size ());
+
+  //merge the lines of both ACS, the lines in this->evicted are not inserted,
+  //the lines in c.evicted are removed
+  size_t i = 0, j = 0;
+  while (i < lines.size () || j < c.lines.size ())
     {
-      if (evicted.find (it_c->first) != evicted.end ())	{ continue; }			//if in this->evicted no need to insert it
-      contents[it_c->first].insert (it_c->second.begin (), it_c->second.end ());
-      map < t_address, set < t_address > >::iterator it_this = contents.find (it_c->first);
-      if (it_this->second.size () >= nb_ways)
+      PSLine l;
+      if (j == c.lines.size () || (i < lines.size () && lines[i].tag < c.lines[j].tag))
 	{
-	  evicted.insert (it_this->first);
-	  contents.erase (it_this);
+	  l.tag = lines[i].tag;
+	  l.conflicts.swap (lines[i].conflicts);
+	  i++;
+	}
+      else if (i == lines.size () || c.lines[j].tag < lines[i].tag)
+	{
+	  j++;
+	  if (containsSorted (evicted, c.lines[j - 1].tag)) { continue; }
+	  l = c.lines[j - 1];
+	}
+      else
+	{
+	  l.tag = lines[i].tag;
+	  l.conflicts.swap (lines[i].conflicts);
+	  if (!containsSorted (evicted, l.tag))
+	    {
+	      unionSorted (l.conflicts, c.lines[j].conflicts.begin (), c.lines[j].conflicts.end ());
+	    }
+	  i++;
+	  j++;
 	}
-    }
 
-  //erase all c.evicted from this->contents
-  for (set < t_address >::const_iterator it = c.evicted.begin (); it != c.evicted.end (); it++)
-    {
-      contents.erase (*it);
+      if (l.conflicts.size () >= nb_ways)
+	{
+	  to_evict.push_back (l.tag);
+	  continue;
+	}
+      if (containsSorted (c.evicted, l.tag)) { continue; }
+      result.push_back (PSLine ());
+      result.back ().tag = l.tag;
+      result.back ().conflicts.swap (l.conflicts);
     }
+  lines.swap (result);
 
   //merge evicted sets
-  evicted.insert (c.evicted.begin (), c.evicted.end ());
+  unionSorted (evicted, to_evict.begin (), to_evict.end ());
+  unionSorted (evicted, c.evicted.begin (), c.evicted.end ());
 }
 
 /** returns true if this is equal to c and false otherwise */
@@ -560,5 +595,5 @@ bool
 PS::Equals (const PS & c) const
 {
   assert (nb_ways == c.nb_ways);
-  return this->contents == c.contents && this->evicted == c.evicted;
+  return this->lines == c.lines && this->evicted == c.evicted;
 }
@@ -42,6 +42,48 @@
 
 using namespace std;
 
+/**************************************************
+ *
+ * Cache accesses
+ *
+ *************************************************/
+
+/** Access classification of a cache access (CAC attribute value, "N" accesses are not recorded) */
+enum t_access_class
+{
+  ACCESS_ALWAYS,		// "A"
+  ACCESS_UNCERTAIN,		// "U" or "UN"
+  ACCESS_BLOCKS			// several cache lines of one set, unpredictable (data cache analysis)
+};
+
+/** A cache access */
+struct CacheAccess
+{
+  /** Address of the cache line, index in AccessStream::blocks for ACCESS_BLOCKS */
+  t_address line;
+  /** Cache set of the line */
+  unsigned int set;
+  t_access_class cac;
+};
+
+/** @return the access to the cache line containing addr, in a cache of nbsets sets of cachelinesize bytes lines */
+inline CacheAccess mkCacheAccess (t_address addr, unsigned int nbsets, unsigned int cachelinesize, t_access_class cac)
+{
+  CacheAccess a;
+  a.line = addr - (addr % cachelinesize);
+  a.set = (a.line / cachelinesize) % nbsets;
+  a.cac = cac;
+  return a;
+}
+
+/** Cache accesses of a basic block in a context, in program order */
+struct AccessStream
+{
+  vector < CacheAccess > accesses;
+  /** Cache lines of the ACCESS_BLOCKS accesses */
+  vector < set < t_address > >blocks;
+};
+
 /**************************************************
  *
  * AbstractCache
@@ -102,6 +144,12 @@ template < typename T > class AbstractCache
       contents.resize (nb_sets, tmp);
     }
 
+  /** returns the number of sets */
+  unsigned int GetNbSets () const
+  {
+    return nb_sets;
+  }
+
   /** Print the Abstract Cache for debugging purpose */
   void Print () const
   {
@@ -194,6 +242,33 @@ template < typename T > class AbstractCache
     return false;
   }
 
+  /** returns the abstract cache made of the count sets from first, renumbered from 0
+      (set-partitioned analysis). The sets are copied: the result shares no set with this.
+  */
+  AbstractCache < T > SelectSets (unsigned int first, unsigned int count) const
+  {
+    assert (first + count <= nb_sets);
+    AbstractCache < T > c;
+    c.nb_sets = count;
+    c.nb_ways = nb_ways;
+    c.cacheline_size = cacheline_size;
+    for (unsigned int s = 0; s < count; s++)
+      {
+	c.contents.push_back (cow_ptr < T > (*(contents[first + s])));
+      }
+    return c;
+  }
+
+  /** Replaces the sets from first by the sets of c (merge of a set-partitioned analysis, see SelectSets) */
+  void CopySets (const AbstractCache < T > &c, unsigned int first)
+  {
+    assert (first + c.nb_sets <= nb_sets && c.nb_ways == nb_ways && c.cacheline_size == cacheline_size);
+    for (unsigned int s = 0; s < c.nb_sets; s++)
+      {
+	contents[first + s] = c.contents[s];
+      }
+  }
+
   /** Join function */
   void Join (const AbstractCache < T > &c)
   {
@@ -226,6 +301,35 @@ template < typename T > class AbstractCache
       }
   }
 
+  /** Update function replaying the accesses of a basic block */
+  void Update (const AccessStream & stream)
+  {
+    if (nb_sets == 0 || nb_ways == 0) { return; }
+
+    const vector < CacheAccess > &accesses = stream.accesses;
+    for (size_t i = 0; i < accesses.size (); i++)
+      {
+	const CacheAccess & a = accesses[i];
+	assert (a.set < nb_sets);
+	switch (a.cac)
+	  {
+	  case ACCESS_ALWAYS:
+	    contents[a.set]->Update (a.line);
+	    break;
+	  case ACCESS_UNCERTAIN:
+	    {
+	      T before = *(contents[a.set]);
+	      contents[a.set]->Update (a.line);
+	      contents[a.set]->Join (before);
+	    }
+	    break;
+	  case ACCESS_BLOCKS:
+	    contents[a.set]->Update (stream.blocks[a.line]);
+	    break;
+	  }
+      }
+  }
+
   /** Update function when a set of addresses is accessed 
       used by the data cache analysis
   */
@@ -269,6 +373,38 @@ template < typename T > class AbstractCache
 };
 
 
+/**************************************************
+ *
+ *  Abstract cache set representations
+ *
+ *************************************************/
+
+/** A cache line of a MUST or MAY abstract cache set with its age.
+    The lines of a set are kept sorted by tag, each tag at most once,
+    so that the join is a linear merge and the equality a plain comparison. */
+struct AgedLine
+{
+  t_address tag;
+  unsigned int age;
+
+  bool operator== (const AgedLine & l) const
+  {
+    return tag == l.tag && age == l.age;
+  }
+};
+
+/** A cache line of a PS abstract cache set with the (sorted) cache lines conflicting with it */
+struct PSLine
+{
+  t_address tag;
+  vector < t_address > conflicts;
+
+  bool operator== (const PSLine & l) const
+  {
+    return tag == l.tag && conflicts == l.conflicts;
+  }
+};
+
 /**************************************************
  *
  *  AbstractCacheSet MUST
@@ -281,7 +417,7 @@ class MUST
   unsigned int nb_ways;		//the value corresponds to the number of ways to consider during the analysis
   //(cf. cache abstract factory in ICacheAnalysis.cc or DCacheAnalysis.cc)
   unsigned int nb_ways_removed;	//used in function GetAge and useful when a non LRU policy is used
-  vector < set < t_address > >contents;	//abstract cache sets
+  vector < AgedLine > lines;	//abstract cache set: lines of age [0..nb_ways-1], sorted by tag
 
  public:
 
@@ -325,7 +461,7 @@ class MAY
  private:
   unsigned int nb_ways;		//the value corresponds to the number of ways to consider during the analysis
   //(cf. cache abstract factory in ICacheAnalysis.cc or DCacheAnalysis.cc)
-  vector < set < t_address > >contents;	//abstract cache sets
+  vector < AgedLine > lines;	//abstract cache set: lines of age [0..nb_ways-1], sorted by tag
 
  public:
 
@@ -368,8 +504,8 @@ class PS
   unsigned int nb_ways;		//the value corresponds to the number of ways to consider during the analysis
   //(cf. cache abstract factory in ICacheAnalysis.cc or DCacheAnalysis.cc)
   unsigned int nb_ways_removed;	//used in function GetAge and useful when a non LRU policy is used
-  map < t_address, set < t_address > >contents;	//abstract cache sets
-  set < t_address > evicted;	//used to reduce the size of the map (contents). No need to maintain the conflicts of evicted cache lines
+  vector < PSLine > lines;	//abstract cache set, sorted by tag (less than nb_ways conflicts per line)
+  vector < t_address > evicted;	//sorted, used to reduce the size of lines. No need to maintain the conflicts of evicted cache lines
 
  public:
 
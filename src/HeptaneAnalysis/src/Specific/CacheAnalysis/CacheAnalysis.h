@@ -27,22 +27,25 @@ See CREDITS.txt for credits of authorship
 #ifndef CACHE_ANALYSIS_H
 #define CACHE_ANALYSIS_H
 
+#include <vector>
+#include <map>
+#include <string>
+#include "Specific/CacheAnalysis/Cache.h"
+#include "Generic/ContextHelper.h"
+
 
 /*************************************************************************************************************************
  Names of internal attributes
  **************************************************************************************************************************/
 
-// ACSMAY_in and ACSMAY_out, of type AbstractCacheStateAttribute<MAY>, attached to nodes
+// ACSMAY_in, of type AbstractCacheStateAttribute<MAY>, attached to nodes (see ACSTable::WriteBack)
 #define ACSMAYInName "ACSMAY_in"
-#define ACSMAYOutName "ACSMAY_out"
 
-// ACSMUST_in and ACSMUST_out, of type AbstractCacheStateAttribute<MUST>, attached to nodes
+// ACSMUST_in, of type AbstractCacheStateAttribute<MUST>, attached to nodes (see ACSTable::WriteBack)
 #define ACSMUSTInName "ACSMUST_in"
-#define ACSMUSTOutName "ACSMUST_out"
 
-// ACSPS_in and ACSPS_out, of type AbstractCacheStateAttribute<PS>, attached to nodes (PS: persistent)
+// ACSPS_in, of type AbstractCacheStateAttribute<PS>, attached to nodes (PS: persistent, see ACSTable::WriteBack)
 #define ACSPSInName "ACSPS_in"
-#define ACSPSOutName "ACSPS_out"
 
 
 /*************************************************************************************************************************
@@ -84,4 +87,321 @@ public:
   };
 };
 
+/*************************************************************************************************************************
+ Contextual node index
+ **************************************************************************************************************************/
+
+// ------------------------------------------------------
+// Dense index of the contextual nodes of a program.
+//
+// One slot per (context, node of the context function), the
+// slots of a context are contiguous and indexed by the position
+// of the node in its cfg.
+// -----------------------------------------------------
+/**
+ * Dense index of the contextual nodes, by context id and node
+ */
+class ContextualNodeIndex
+{
+ private:
+  /** First slot of each context, by context id */
+  vector < size_t > base;
+  /** Position of each node in its cfg */
+  map < Node *, size_t > node_index;
+  /** Contexts of the program, by context id */
+  vector < Context * > contexts;
+  /** Number of slots */
+  size_t nb_slots;
+
+ public:
+  ContextualNodeIndex ():nb_slots (0)
+  {
+  }
+
+  /** Builds the slots of all the contexts of p */
+  void Reset (Program * p)
+  {
+    Clear ();
+
+    const ContextTree & tree = (ContextTree &) p->GetAttribute (ContextTreeAttributeName);
+    size_t nb_contexts = tree.getContextsCount ();
+    contexts.resize (nb_contexts, NULL);
+    base.resize (nb_contexts, 0);
+
+    for (size_t c = 0; c < nb_contexts; c++)
+      {
+	Context *context = tree.getContext (c);
+	assert (context->getId () < nb_contexts);
+	contexts[context->getId ()] = context;
+	base[context->getId ()] = nb_slots;
+
+	vector < Node * >nodes = context->getCurrentFunction ()->GetAllNodes ();
+	for (size_t n = 0; n < nodes.size (); n++)
+	  {
+	    node_index[nodes[n]] = n;
+	  }
+	nb_slots += nodes.size ();
+      }
+  }
+
+  /** Frees the index */
+  void Clear ()
+  {
+    vector < size_t > ().swap (base);
+    map < Node *, size_t > ().swap (node_index);
+    vector < Context * > ().swap (contexts);
+    nb_slots = 0;
+  }
+
+  /** @return the slot of a contextual node */
+  size_t Slot (const ContextualNode & cn) const
+  {
+    map < Node *, size_t >::const_iterator it = node_index.find (cn.node);
+    assert (it != node_index.end ());
+    return base[cn.context->getId ()] + it->second;
+  }
+
+  /** @return the number of slots */
+  size_t Size () const
+  {
+    return nb_slots;
+  }
+
+  /** @return the number of contexts */
+  size_t GetNbContexts () const
+  {
+    return contexts.size ();
+  }
+
+  /** @return the context of id c */
+  Context *GetContext (size_t c) const
+  {
+    return contexts[c];
+  }
+
+  /** @return the slot of the first node of the context of id c */
+  size_t GetBase (size_t c) const
+  {
+    return base[c];
+  }
+};
+
+/*************************************************************************************************************************
+ AbstractCache state table
+ **************************************************************************************************************************/
+
+// ------------------------------------------------------
+// Abstract cache states of the contextual nodes during a
+// fixed point computation, one per slot of a ContextualNodeIndex.
+//
+// The fixed points read and write the states here instead of
+// the in + context / out + context attributes, WriteBack()
+// attaches the ACS_in to the nodes once the fixed point is
+// reached (ClassifCHMC* functions).
+//
+// generic type T stands for MUST, MAY or PS (see Cache.h for more details)
+// -----------------------------------------------------
+/**
+ * Abstract cache states of the contextual nodes
+ */
+template < typename T > class ACSTable
+{
+ private:
+  const ContextualNodeIndex *index;
+
+  /** ACS_in and ACS_out of each slot */
+  vector < AbstractCache < T > > acs_in, acs_out;
+  /** true when the contextual node of the slot takes part in the analysis */
+  vector < bool > attached;
+
+  /** Initial ACS of the attached contextual nodes */
+  AbstractCache < T > empty;
+
+ public:
+  ACSTable ():index (NULL)
+  {
+  }
+
+  /** Builds the slots of the index, none is attached */
+  void Reset (const ContextualNodeIndex * cn_index, const AbstractCache < T > &ACS_empty)
+  {
+    Clear ();
+    index = cn_index;
+    empty = ACS_empty;
+    acs_in.resize (index->Size ());
+    acs_out.resize (index->Size ());
+    attached.resize (index->Size (), false);
+  }
+
+  /** Frees the table */
+  void Clear ()
+  {
+    index = NULL;
+    vector < AbstractCache < T > > ().swap (acs_in);
+    vector < AbstractCache < T > > ().swap (acs_out);
+    vector < bool > ().swap (attached);
+    empty = AbstractCache < T > ();
+  }
+
+  /** Attaches a contextual node, its ACS_in and ACS_out are the empty ACS */
+  void Attach (const ContextualNode & cn)
+  {
+    size_t s = index->Slot (cn);
+    acs_in[s] = empty;
+    acs_out[s] = empty;
+    attached[s] = true;
+  }
+
+  /** Attaches a node in all the contexts of its cfg */
+  void AttachNode (Cfg * c, Node * n)
+  {
+    assert (c->HasAttribute (ContextListAttributeName));
+    const ContextList & cl = (ContextList &) c->GetAttribute (ContextListAttributeName);
+    for (ContextList::const_iterator context = cl.begin (); context != cl.end (); context++)
+      {
+	Attach (ContextualNode (*context, n));
+      }
+  }
+
+  /** @return true if the contextual node takes part in the analysis */
+  bool IsAttached (const ContextualNode & cn) const
+  {
+    return attached[index->Slot (cn)];
+  }
+
+  /** ACS_in of an attached contextual node */
+  AbstractCache < T > &In (const ContextualNode & cn)
+  {
+    size_t s = index->Slot (cn);
+    assert (attached[s]);
+    return acs_in[s];
+  }
+
+  /** ACS_out of an attached contextual node */
+  AbstractCache < T > &Out (const ContextualNode & cn)
+  {
+    size_t s = index->Slot (cn);
+    assert (attached[s]);
+    return acs_out[s];
+  }
+
+  /** @return the number of slots */
+  size_t Size () const
+  {
+    return attached.size ();
+  }
+
+  /** @return the initial ACS of the attached contextual nodes */
+  const AbstractCache < T > &GetEmpty () const
+  {
+    return empty;
+  }
+
+  /** @return true if the contextual node of slot s takes part in the analysis */
+  bool IsAttachedSlot (size_t s) const
+  {
+    return attached[s];
+  }
+
+  /** ACS_in of an attached slot */
+  AbstractCache < T > &InSlot (size_t s)
+  {
+    assert (attached[s]);
+    return acs_in[s];
+  }
+
+  /** Attaches the ACS_in of every attached contextual node to its node,
+      as the attribute inAnalysisName + context id, and frees the table.
+      Remark: inAnalysisName ::= ACSMUSTInName | ACSMAYInName | ACSPSInName. */
+  void WriteBack (const string & inAnalysisName)
+  {
+    for (size_t c = 0; c < index->GetNbContexts (); c++)
+      {
+	Context *context = index->GetContext (c);
+	if (context == NULL)
+	  continue;
+	string id = inAnalysisName + context->getStringId ();
+	vector < Node * >nodes = context->getCurrentFunction ()->GetAllNodes ();
+	for (size_t n = 0; n < nodes.size (); n++)
+	  {
+	    size_t s = index->GetBase (c) + n;
+	    if (attached[s])
+	      {
+		AbstractCacheStateAttribute < T > att (acs_in[s]);
+		nodes[n]->SetAttribute (id, att);
+	      }
+	  }
+      }
+    Clear ();
+  }
+};
+
+/** applyToAllNodesRecursive function, attaches n in all its contexts to the ACSTable < T > param */
+template < typename T > bool AttachACSTableNode (Cfg * c, Node * n, void *param)
+{
+  ((ACSTable < T > *)param)->AttachNode (c, n);
+  return true;
+}
+
+/*************************************************************************************************************************
+ Access stream table
+ **************************************************************************************************************************/
+
+// ------------------------------------------------------
+// Cache accesses of the contextual nodes (see AccessStream in
+// Cache.h), one per slot of a ContextualNodeIndex.
+//
+// The streams are compiled once from the CAC attributes of the
+// analysed level, before the MUST, PS and MAY fixed points which
+// replay them. They are only valid for this level: the CAC of the
+// next level depends on the classification of this one.
+// -----------------------------------------------------
+/**
+ * Cache accesses of the contextual nodes
+ */
+class AccessStreamTable
+{
+ private:
+  const ContextualNodeIndex *index;
+  vector < AccessStream > streams;
+
+ public:
+  AccessStreamTable ():index (NULL)
+  {
+  }
+
+  /** Builds an empty stream for every slot of the index */
+  void Reset (const ContextualNodeIndex * cn_index)
+  {
+    Clear ();
+    index = cn_index;
+    streams.resize (index->Size ());
+  }
+
+  /** Frees the table */
+  void Clear ()
+  {
+    index = NULL;
+    vector < AccessStream > ().swap (streams);
+  }
+
+  /** @return the accesses of a contextual node */
+  AccessStream & Get (const ContextualNode & cn)
+  {
+    return streams[index->Slot (cn)];
+  }
+
+  /** @return the number of slots */
+  size_t Size () const
+  {
+    return streams.size ();
+  }
+
+  /** @return the accesses of the contextual node of slot s */
+  const AccessStream & GetSlot (size_t s) const
+  {
+    return streams[s];
+  }
+};
+
 #endif
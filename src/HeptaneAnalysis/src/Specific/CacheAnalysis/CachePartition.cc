@@ -0,0 +1,346 @@
+/* ---------------------------------------------------------------------
+
+Copyright IRISA, 2003-2014
+
+This file is part of Heptane, a tool for Worst-Case Execution Time (WCET)
+estimation.
+APP deposit IDDN.FR.001.510039.000.S.P.2003.000.10600
+
+Heptane is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Heptane is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details (COPYING.txt).
+
+See CREDITS.txt for credits of authorship
+
+------------------------------------------------------------------------ */
+
+#include <pthread.h>
+#include <algorithm>
+
+#include "Specific/CacheAnalysis/CachePartition.h"
+
+/*************************************************************************************************************************
+ Contextual graph
+ **************************************************************************************************************************/
+
+void ContextualGraph::Reset(const ContextualNodeIndex * cn_index)
+{
+  Clear();
+  index = cn_index;
+  explored.resize(index->Size(), false);
+  succ.resize(index->Size());
+  pred.resize(index->Size());
+  rank.resize(index->Size(), index->Size());
+}
+
+void ContextualGraph::Clear()
+{
+  index = NULL;
+  vector < bool > ().swap(explored);
+  vector < vector < size_t > >().swap(succ);
+  vector < vector < size_t > >().swap(pred);
+  vector < size_t > ().swap(wto);
+  vector < size_t > ().swap(rank);
+}
+
+/*
+  Explores the contextual nodes reachable from roots, with the successors and predecessors
+  given by GetContextualSuccessors and GetContextualPredecessors.
+*/
+void ContextualGraph::AddReachable(const set < ContextualNode > &roots)
+{
+  vector < ContextualNode > todo(roots.begin(), roots.end());
+
+  while (!todo.empty())
+    {
+      ContextualNode current = todo.back();
+      todo.pop_back();
+      size_t s = index->Slot(current);
+      if (explored[s])
+	continue;
+      explored[s] = true;
+
+      vector < ContextualNode > successors = GetContextualSuccessors(current);
+      for (size_t i = 0; i < successors.size(); i++)
+	{
+	  succ[s].push_back(index->Slot(successors[i]));
+	  todo.push_back(successors[i]);
+	}
+
+      vector < ContextualNode > predecessors = GetContextualPredecessors(current);
+      for (size_t i = 0; i < predecessors.size(); i++)
+	{
+	  pred[s].push_back(index->Slot(predecessors[i]));
+	}
+    }
+}
+
+/** State of the weak topological order computation */
+struct WTOState
+{
+  const ContextualGraph *graph;
+
+  /** Depth-first numbers, 0 for a slot not visited yet, WTO_DONE for a slot in the order */
+  vector < size_t > dfn;
+  size_t num;
+  vector < size_t > stack;
+
+  /** The order is built backward, the components are prepended */
+  vector < size_t > reversed;
+};
+
+#define WTO_DONE ((size_t) -1)
+
+static void ComponentWTO(WTOState & st, size_t v);
+
+/* Bourdoncle's visit: @return the depth-first number of the head of the component of v */
+static size_t VisitWTO(WTOState & st, size_t v)
+{
+  st.stack.push_back(v);
+  st.num++;
+  st.dfn[v] = st.num;
+  size_t head = st.num;
+  bool loop = false;
+
+  const vector < size_t > &succ = st.graph->GetSuccessors(v);
+  for (size_t i = 0; i < succ.size(); i++)
+    {
+      size_t w = succ[i];
+      size_t min = (st.dfn[w] == 0) ? VisitWTO(st, w) : st.dfn[w];
+      if (min <= head)
+	{
+	  head = min;
+	  loop = true;
+	}
+    }
+
+  if (head == st.dfn[v])
+    {
+      st.dfn[v] = WTO_DONE;
+      size_t element = st.stack.back();
+      st.stack.pop_back();
+      if (loop)
+	{
+	  // v is the head of a component, its body is ordered again without v
+	  while (element != v)
+	    {
+	      st.dfn[element] = 0;
+	      element = st.stack.back();
+	      st.stack.pop_back();
+	    }
+	  ComponentWTO(st, v);
+	}
+      else
+	{
+	  st.reversed.push_back(v);
+	}
+    }
+  return head;
+}
+
+/* Bourdoncle's component: the head v followed by the order of its body */
+static void ComponentWTO(WTOState & st, size_t v)
+{
+  const vector < size_t > &succ = st.graph->GetSuccessors(v);
+  for (size_t i = 0; i < succ.size(); i++)
+    {
+      if (st.dfn[succ[i]] == 0)
+	VisitWTO(st, succ[i]);
+    }
+  st.reversed.push_back(v);
+}
+
+void ContextualGraph::ComputeWTO(const set < size_t > &roots)
+{
+  WTOState st;
+  st.graph = this;
+  st.num = 0;
+  st.dfn.resize(rank.size(), 0);
+  for (size_t r = 0; r < wto.size(); r++)
+    {
+      st.dfn[wto[r]] = WTO_DONE;
+    }
+
+  for (set < size_t >::const_iterator it = roots.begin(); it != roots.end(); it++)
+    {
+      if (st.dfn[*it] == 0)
+	VisitWTO(st, *it);
+    }
+
+  for (size_t i = st.reversed.size(); i > 0; i--)
+    {
+      rank[st.reversed[i - 1]] = wto.size();
+      wto.push_back(st.reversed[i - 1]);
+    }
+}
+
+set < size_t > ContextualGraph::Slots(const set < ContextualNode > &cns) const
+{
+  set < size_t > slots;
+  for (set < ContextualNode >::const_iterator it = cns.begin(); it != cns.end(); it++)
+    {
+      slots.insert(index->Slot(*it));
+    }
+  return slots;
+}
+
+/*************************************************************************************************************************
+ Set partition fixed point
+ **************************************************************************************************************************/
+
+AccessStream SelectSets(const AccessStream & stream, unsigned int first, unsigned int count)
+{
+  AccessStream selected;
+  for (size_t i = 0; i < stream.accesses.size(); i++)
+    {
+      CacheAccess a = stream.accesses[i];
+      if (a.set < first || a.set >= first + count)
+	continue;
+      a.set -= first;
+      if (a.cac == ACCESS_BLOCKS)
+	{
+	  selected.blocks.push_back(stream.blocks[a.line]);
+	  a.line = selected.blocks.size() - 1;
+	}
+      selected.accesses.push_back(a);
+    }
+  return selected;
+}
+
+/*
+  The slots are resolved in the weak topological order: the predecessors of a slot are resolved before it,
+  except on the backedges. An identity slot whose resolved predecessors all have the same alias, and no
+  other predecessor, is an alias of it (the chains are collapsed). The other identity slots are computed
+  as a join of their inputs, their ACS_out is their ACS_in.
+*/
+void CollapseIdentitySlots(const ContextualGraph & graph, const vector < bool > &kept, const vector < bool > &identity,
+			   vector < size_t > &alias, vector < vector < size_t > > &inputs, vector < vector < size_t > > &outputs)
+{
+  alias.assign(kept.size(), UNREACHED_SLOT);
+  inputs.assign(kept.size(), vector < size_t > ());
+  outputs.assign(kept.size(), vector < size_t > ());
+  vector < bool > resolved(kept.size(), false);
+
+  for (size_t r = 0; r < graph.NbOrdered(); r++)
+    {
+      size_t s = graph.SlotAt(r);
+      resolved[s] = true;
+      if (!kept[s] && !identity[s])
+	continue;
+
+      vector < size_t > &in = inputs[s];
+      bool backedge = false;
+      const vector < size_t > &pred = graph.GetPredecessors(s);
+      for (size_t i = 0; i < pred.size(); i++)
+	{
+	  size_t p = pred[i];
+	  if (!kept[p] && !identity[p])
+	    continue;
+	  if (!resolved[p])
+	    {
+	      backedge = true;
+	      in.push_back(p);
+	    }
+	  else if (alias[p] != UNREACHED_SLOT)
+	    in.push_back(alias[p]);
+	}
+      sort(in.begin(), in.end());
+      in.erase(unique(in.begin(), in.end()), in.end());
+
+      if (kept[s] || backedge || in.size() > 1)
+	alias[s] = s;
+      else if (in.size() == 1)
+	{
+	  alias[s] = in[0];
+	  in.clear();
+	}
+    }
+
+  // the backedges are resolved once all the slots are
+  for (size_t s = 0; s < kept.size(); s++)
+    {
+      if (alias[s] != s)
+	continue;
+      vector < size_t > &in = inputs[s];
+      for (size_t i = 0; i < in.size(); i++)
+	{
+	  in[i] = alias[in[i]];
+	}
+      in.erase(remove(in.begin(), in.end(), UNREACHED_SLOT), in.end());
+      sort(in.begin(), in.end());
+      in.erase(unique(in.begin(), in.end()), in.end());
+      for (size_t i = 0; i < in.size(); i++)
+	{
+	  outputs[in[i]].push_back(s);
+	}
+    }
+}
+
+/** Jobs of RunParallel, the next job is taken under the lock */
+struct ParallelJobs
+{
+  void (*job) (size_t, void *);
+  void *param;
+  size_t nb_jobs;
+  size_t next;
+  pthread_mutex_t lock;
+};
+
+static void *RunJobs(void *arg)
+{
+  ParallelJobs *jobs = (ParallelJobs *) arg;
+  while (true)
+    {
+      pthread_mutex_lock(&jobs->lock);
+      size_t i = jobs->next++;
+      pthread_mutex_unlock(&jobs->lock);
+      if (i >= jobs->nb_jobs)
+	break;
+      jobs->job(i, jobs->param);
+    }
+  return NULL;
+}
+
+/*
+  Runs the jobs on nb_threads threads, the calling thread included.
+  When a thread cannot be created, the jobs are shared by the threads already running.
+*/
+void RunParallel(size_t nb_jobs, void (*job) (size_t, void *), void *param, unsigned int nb_threads)
+{
+  if (nb_threads <= 1 || nb_jobs < 2)
+    {
+      for (size_t i = 0; i < nb_jobs; i++)
+	{
+	  job(i, param);
+	}
+      return;
+    }
+
+  ParallelJobs jobs;
+  jobs.job = job;
+  jobs.param = param;
+  jobs.nb_jobs = nb_jobs;
+  jobs.next = 0;
+  pthread_mutex_init(&jobs.lock, NULL);
+
+  vector < pthread_t > threads;
+  for (size_t t = 1; t < nb_threads && t < nb_jobs; t++)
+    {
+      pthread_t thread;
+      if (pthread_create(&thread, NULL, RunJobs, (void *)&jobs) != 0)
+	break;
+      threads.push_back(thread);
+    }
+  RunJobs((void *)&jobs);
+  for (size_t t = 0; t < threads.size(); t++)
+    {
+      pthread_join(threads[t], NULL);
+    }
+  pthread_mutex_destroy(&jobs.lock);
+}
@@ -0,0 +1,442 @@
+/* ---------------------------------------------------------------------
+
+Copyright IRISA, 2003-2014
+
+This file is part of Heptane, a tool for Worst-Case Execution Time (WCET)
+estimation.
+APP deposit IDDN.FR.001.510039.000.S.P.2003.000.10600
+
+Heptane is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Heptane is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details (COPYING.txt).
+
+See CREDITS.txt for credits of authorship
+
+------------------------------------------------------------------------ */
+
+
+/**
+ Set-partitioned MUST, MAY and PS fixed points, shared by the Instruction and Data cache analysis.
+
+ The abstract cache sets are independent: AbstractCache::Join, Equals and Update(AccessStream)
+ work set by set. The sets of the cache are split in groups (partitions) and the fixed point
+ of each partition is computed on its own thread, with the accesses to its sets only. The
+ ACS_in of the partitions are then merged back into the ACSTable, before the classification.
+
+ The fixed point of a partition only computes the nodes that access its sets, and the nodes
+ that join them: the chains of other nodes leave the ACS of the partition unchanged, and are
+ collapsed into the node that precedes them. Their ACS_in are copied once the fixed point is reached.
+
+ The threads share no mutable state: the contextual graph is computed beforehand (the cfglib
+ and ContextHelper functions are not thread safe), and each partition holds copies of its sets
+ (cow_ptr reference counts are not atomic). The sequential analysis is a single partition.
+
+ The nodes are computed in the weak topological order of the contextual graph (one copy of each
+ cfg per context): the inner loops are stabilized before the nodes that follow them are computed.
+
+ paper:
+ - Efficient chaotic iteration strategies with widenings. F. Bourdoncle. FMPA 1993.
+  */
+
+#ifndef CACHE_PARTITION_H
+#define CACHE_PARTITION_H
+
+#include <vector>
+#include <set>
+#include "Specific/CacheAnalysis/Cache.h"
+#include "Specific/CacheAnalysis/CacheAnalysis.h"
+#include "Generic/ContextHelper.h"
+
+// Number of partitions per thread, more partitions than threads balance the load
+// between the groups of sets that are accessed often and the others.
+#define SET_PARTITIONS_PER_THREAD 4
+
+/*************************************************************************************************************************
+ Contextual graph
+ **************************************************************************************************************************/
+
+/**
+ * Contextual successors and predecessors of the slots of a ContextualNodeIndex,
+ * and weak topological order of the slots
+ */
+class ContextualGraph
+{
+ private:
+  const ContextualNodeIndex *index;
+
+  /** true when the successors and predecessors of the slot are computed */
+  vector < bool > explored;
+
+  /** Contextual successors and predecessors of each slot */
+  vector < vector < size_t > > succ, pred;
+
+  /** Slots in weak topological order, and position of each slot in wto */
+  vector < size_t > wto, rank;
+
+ public:
+  ContextualGraph ():index (NULL)
+  {
+  }
+
+  /** Builds an empty graph over the slots of the index */
+  void Reset (const ContextualNodeIndex * cn_index);
+
+  /** Frees the graph */
+  void Clear ();
+
+  /** Computes the successors and predecessors of the contextual nodes reachable from roots */
+  void AddReachable (const set < ContextualNode > &roots);
+
+  /** @return the slots of a set of contextual nodes */
+  set < size_t > Slots (const set < ContextualNode > &cns) const;
+
+  /** @return the number of slots */
+  size_t Size () const
+  {
+    return explored.size ();
+  }
+
+  /** @return true when the successors and predecessors of the slot s are computed */
+  bool IsExplored (size_t s) const
+  {
+    return explored[s];
+  }
+
+  /** @return the successors of the slot s */
+  const vector < size_t > &GetSuccessors (size_t s) const
+  {
+    assert (explored[s]);
+    return succ[s];
+  }
+
+  /** @return the predecessors of the slot s */
+  const vector < size_t > &GetPredecessors (size_t s) const
+  {
+    assert (explored[s]);
+    return pred[s];
+  }
+
+  /** Appends to the weak topological order the slots reachable from roots that are not ordered yet
+      (Bourdoncle's recursive strategy). The slots must be explored (see AddReachable). */
+  void ComputeWTO (const set < size_t > &roots);
+
+  /** @return the number of ordered slots */
+  size_t NbOrdered () const
+  {
+    return wto.size ();
+  }
+
+  /** @return the position of the slot s in the weak topological order */
+  size_t Rank (size_t s) const
+  {
+    assert (rank[s] < wto.size ());
+    return rank[s];
+  }
+
+  /** @return the slot at position r of the weak topological order */
+  size_t SlotAt (size_t r) const
+  {
+    return wto[r];
+  }
+};
+
+/**
+ * Worklist of slots, the slot of lowest rank in the weak topological order is taken first.
+ * One bit per ordered slot.
+ */
+class WTOWorklist
+{
+ private:
+  static const size_t WORD_BITS = 8 * sizeof (unsigned long);
+
+  const ContextualGraph *graph;
+  vector < unsigned long > bits;
+
+  /** No bit is set in the words before first_word */
+  size_t first_word;
+
+ public:
+  WTOWorklist (const ContextualGraph & g):graph (&g), bits ((g.NbOrdered () + WORD_BITS - 1) / WORD_BITS, 0), first_word (bits.size ())
+  {
+  }
+
+  void Push (size_t s)
+  {
+    size_t r = graph->Rank (s);
+    bits[r / WORD_BITS] |= 1UL << (r % WORD_BITS);
+    if (r / WORD_BITS < first_word)
+      first_word = r / WORD_BITS;
+  }
+
+  bool Empty ()
+  {
+    while (first_word < bits.size () && bits[first_word] == 0)
+      first_word++;
+    return first_word == bits.size ();
+  }
+
+  /** Removes and returns the slot of lowest rank (the worklist must not be empty) */
+  size_t Pop ()
+  {
+    Empty ();			// moves first_word to the first word with a bit set
+    assert (first_word < bits.size ());
+    unsigned long word = bits[first_word];
+    size_t b = 0;
+    while ((word & (1UL << b)) == 0)
+      b++;
+    bits[first_word] &= ~(1UL << b);
+    return graph->SlotAt (first_word * WORD_BITS + b);
+  }
+};
+
+/*************************************************************************************************************************
+ Set partition fixed point
+ **************************************************************************************************************************/
+
+/** Runs job(i, param) for i in [0, nb_jobs) on nb_threads threads (the calling thread included) */
+void RunParallel (size_t nb_jobs, void (*job) (size_t, void *), void *param, unsigned int nb_threads);
+
+/** @return the accesses of stream to the count sets from first, renumbered from 0 */
+AccessStream SelectSets (const AccessStream & stream, unsigned int first, unsigned int count);
+
+/** Alias of the identity slots that no computed slot reaches */
+#define UNREACHED_SLOT ((size_t) -1)
+
+/**
+ * Collapses the chains of identity slots of a partition: the slots that do not access its sets,
+ * and leave its ACS unchanged (ACS_out = ACS_in).
+ * @param kept true for the roots and the slots that access the sets of the partition
+ * @param identity true for the other slots of the partition
+ * @param alias the computed slot whose ACS_out is the ACS_in of an identity slot of a chain (UNREACHED_SLOT if none),
+ *        alias[s] is s for the computed slots: the kept slots and the identity slots that join several inputs
+ * @param inputs the computed slots whose ACS_out are joined in the ACS_in of a computed slot
+ * @param outputs the computed slots of which a computed slot is an input
+ */
+void CollapseIdentitySlots (const ContextualGraph & graph, const vector < bool > &kept, const vector < bool > &identity,
+			    vector < size_t > &alias, vector < vector < size_t > > &inputs, vector < vector < size_t > > &outputs);
+
+/**
+ * Fixed point of a group of cache sets
+ *
+ * generic type T stands for MUST, MAY or PS (see Cache.h for more details)
+ */
+template < typename T > class CacheSetPartition
+{
+ private:
+  const ContextualGraph *graph;
+  const ACSTable < T > *table;
+
+  /** First set of the partition, and number of sets */
+  unsigned int first_set, nb_sets;
+
+  /** Accesses of the slots to the sets of the partition */
+  vector < AccessStream > streams;
+
+  /** ACS_in and ACS_out of each slot, restricted to the sets of the partition */
+  vector < AbstractCache < T > > acs_in, acs_out;
+
+ public:
+  CacheSetPartition ():graph (NULL), table (NULL), first_set (0), nb_sets (0)
+  {
+  }
+
+  /** Builds the partition of the count sets from first, the attached slots of t hold the empty ACS */
+  void Reset (const ContextualGraph * g, const ACSTable < T > *t, const AccessStreamTable & access_streams, unsigned int first,
+	      unsigned int count)
+  {
+    graph = g;
+    table = t;
+    first_set = first;
+    nb_sets = count;
+
+    AbstractCache < T > empty = table->GetEmpty ().SelectSets (first, count);
+    streams.resize (table->Size ());
+    acs_in.resize (table->Size ());
+    acs_out.resize (table->Size ());
+    for (size_t s = 0; s < table->Size (); s++)
+      {
+	if (table->IsAttachedSlot (s))
+	  {
+	    streams[s] = SelectSets (access_streams.GetSlot (s), first, count);
+	    acs_in[s] = empty;
+	    acs_out[s] = empty;
+	  }
+      }
+  }
+
+  /** Fixed point computation from the slots of roots, in the weak topological order of the graph.
+      The chains of slots that do not access the sets of the partition are collapsed (see CollapseIdentitySlots):
+      only the roots, the slots that access the sets of the partition and the slots that join several of them
+      are computed.
+      The ACS_in of a slot is the join of the ACS_out of its inputs already computed:
+      a loop head is first computed from the entry of the loop only, which replaces the first step
+      of the MUST analysis without the backedges (the empty MAY and PS ACS are neutral for Join).
+      All the computed slots reached are computed at least once: the sets of the partition may be left
+      unchanged by the first nodes, which would stop the propagation.
+      This is a deliberate precision change for the instruction cache MAY and PS analyses: they used
+      to stop there, and the nodes after were classified from the empty ACS (PS accesses NC instead
+      of FM in benchmarks/crc, see make crc_test). The MUST and the data cache analyses already
+      computed every node once. The result is a fixed point of the same equations, from the same
+      initial ACS: it is as sound as theirs.
+      The ACS_in of the slots of the chains are then the ACS_out of their alias.
+      @return the number of ACS_out computed (iterations), the slots popped with an unchanged ACS_in are not counted */
+  size_t FixPoint (const set < size_t > &roots)
+  {
+    WTOWorklist work (*graph);
+    vector < bool > visited (table->Size (), false);
+    size_t nb_iterations = 0;
+
+    vector < bool > kept (table->Size (), false), identity (table->Size (), false);
+    for (size_t s = 0; s < table->Size (); s++)
+      {
+	if (!table->IsAttachedSlot (s) || !graph->IsExplored (s))
+	  continue;
+	if (streams[s].accesses.empty () && roots.find (s) == roots.end ())
+	  identity[s] = true;
+	else
+	  kept[s] = true;
+      }
+    vector < size_t > alias;
+    vector < vector < size_t > > inputs, outputs;
+    CollapseIdentitySlots (*graph, kept, identity, alias, inputs, outputs);
+
+    for (set < size_t >::const_iterator it = roots.begin (); it != roots.end (); it++)
+      {
+	if (kept[*it])
+	  work.Push (*it);
+      }
+
+    while (!work.Empty ())
+      {
+	size_t s = work.Pop ();
+
+	// ACS_in
+	const vector < size_t > &pred = inputs[s];
+	AbstractCache < T > new_ACS_in;
+	bool first = true;
+	for (size_t i = 0; i < pred.size (); i++)
+	  {
+	    if (!visited[pred[i]])
+	      continue;
+	    if (first)
+	      {
+		first = false;
+		new_ACS_in = acs_out[pred[i]];
+	      }
+	    else
+	      {
+		new_ACS_in.Join (acs_out[pred[i]]);
+	      }
+	  }
+	if (!first)
+	  {
+	    if (visited[s] && acs_in[s].Equals (new_ACS_in))
+	      continue;
+	    acs_in[s] = new_ACS_in;
+	  }
+	else if (visited[s])
+	  continue;
+
+	// ACS_out
+	nb_iterations++;
+	AbstractCache < T > ACS_out = acs_in[s];
+	ACS_out.Update (streams[s]);
+	if (visited[s] && acs_out[s].Equals (ACS_out))
+	  continue;
+	visited[s] = true;
+	acs_out[s] = ACS_out;
+
+	const vector < size_t > &succ = outputs[s];
+	for (size_t i = 0; i < succ.size (); i++)
+	  {
+	    work.Push (succ[i]);
+	  }
+      }
+
+    for (size_t s = 0; s < table->Size (); s++)
+      {
+	if (identity[s] && alias[s] != s && alias[s] != UNREACHED_SLOT && visited[alias[s]])
+	  acs_in[s] = acs_out[alias[s]];
+      }
+    return nb_iterations;
+  }
+
+  /** Copies the ACS_in of the partition into the attached slots of t (the calling thread must own t) */
+  void Merge (ACSTable < T > &t)
+  {
+    for (size_t s = 0; s < t.Size (); s++)
+      {
+	if (t.IsAttachedSlot (s) && acs_in[s].GetNbSets () == nb_sets)
+	  {
+	    t.InSlot (s).CopySets (acs_in[s], first_set);
+	  }
+      }
+  }
+};
+
+/** Parameters of the jobs of SetPartitionedFixPoint */
+template < typename T > struct SetPartitionJobs
+{
+  vector < CacheSetPartition < T > >*partitions;
+  const ContextualGraph *graph;
+  const ACSTable < T > *table;
+  const AccessStreamTable *streams;
+  const set < size_t > *roots;
+  unsigned int nb_sets;
+
+  /** Number of iterations of each partition */
+  vector < size_t > iterations;
+};
+
+/** RunParallel job: fixed point of the i-th partition */
+template < typename T > void SetPartitionJob (size_t i, void *param)
+{
+  SetPartitionJobs < T > *jobs = (SetPartitionJobs < T > *)param;
+  size_t nb_partitions = jobs->partitions->size ();
+  unsigned int first = (unsigned int) (i * jobs->nb_sets / nb_partitions);
+  unsigned int last = (unsigned int) ((i + 1) * jobs->nb_sets / nb_partitions);
+
+  CacheSetPartition < T > &partition = (*jobs->partitions)[i];
+  partition.Reset (jobs->graph, jobs->table, *jobs->streams, first, last - first);
+  jobs->iterations[i] = partition.FixPoint (*jobs->roots);
+}
+
+/**
+ * Fixed point computation of the attached slots of table from the slots of roots, by groups of cache sets
+ * on nb_threads threads (a single group when nb_threads is 1). The ACS_in of the groups are then merged into table.
+ * @return the number of iterations, summed over the groups
+ */
+template < typename T > size_t SetPartitionedFixPoint (ACSTable < T > &table, const AccessStreamTable & streams, const ContextualGraph & graph,
+						       const set < size_t > &roots, unsigned int nb_sets, unsigned int nb_threads)
+{
+  size_t nb_partitions = 1;
+  if (nb_threads > 1)
+    nb_partitions = min ((size_t) nb_sets, (size_t) nb_threads * SET_PARTITIONS_PER_THREAD);
+  vector < CacheSetPartition < T > >partitions (nb_partitions);
+
+  SetPartitionJobs < T > jobs;
+  jobs.partitions = &partitions;
+  jobs.graph = &graph;
+  jobs.table = &table;
+  jobs.streams = &streams;
+  jobs.roots = &roots;
+  jobs.nb_sets = nb_sets;
+  jobs.iterations.resize (nb_partitions, 0);
+  RunParallel (nb_partitions, SetPartitionJob < T >, (void *)&jobs, nb_threads);
+
+  size_t nb_iterations = 0;
+  for (size_t i = 0; i < partitions.size (); i++)
+    {
+      partitions[i].Merge (table);
+      nb_iterations += jobs.iterations[i];
+    }
+  return nb_iterations;
+}
+
+#endif
@@ -62,7 +62,6 @@
 
 // inlines...
 #define getACSNode(T, NODE, IDATTR) ((AbstractCacheStateAttribute < T > &)NODE->GetAttribute(IDATTR))
-#define getACSContextualNode(T, ELEM, IDATTR) getACSNode(T, ELEM.node,IDATTR)
 
 
 /*************************************************************************************************************************
@@ -418,43 +417,63 @@ bool static StubFunction(Cfg * c, Node * n, void *param)
 }
 
 /*
-   @return the ACS_out, for an analysis T, of a ContextualNode (current). The initial ACS_out is the given by the ACS_in of the current analysis provided by inAnalysisName for the context.
-   (inAnalysisName ::= ACSMUSTInName | ACSMAYInName | ACSPSInName )
+   Compiles the load accesses of node n, in all the contexts of its cfg, from the CAC attributes of the analysed level.
+   The "N" accesses are not recorded. The addresses of a load are grouped per cache set as in AbstractCache::Update:
+   a load that fits in a unique cache line is an ALWAYS or UNCERTAIN access, otherwise every accessed set
+   is updated with its set of lines (unpredictable access).
 */
-template < typename T > AbstractCache < T > DCacheAnalysis::compute_ACS_out(ContextualNode & current, string & inAnalysisName)
+void DCacheAnalysis::CompileAccessStreams(Cfg * c, Node * n)
 {
   string attributeAccessName = CACAttributeNameData(levelAnalysis);
-  string idCurrentContext = current.context->getStringId();
-  string idAccessName;
 
-  AbstractCacheStateAttribute < T > &ca_attr_in = getACSContextualNode(T, current, inAnalysisName + idCurrentContext);
-  AbstractCache < T > ACS_out = ca_attr_in.cache;
+  if (nb_sets == 0 || nb_ways == 0) { return; }
 
-  idAccessName = AnalysisHelper::mkContextAttrName(attributeAccessName, idCurrentContext);
-  vector < Instruction * >vi = current.node->GetAsm();
-  for (size_t i = 0; i < vi.size(); i++)
+  assert(c->HasAttribute(ContextListAttributeName));
+  const ContextList & contexts = (ContextList &) c->GetAttribute(ContextListAttributeName);
+  vector < Instruction * >vi = n->GetAsm();
+  for (ContextList::const_iterator context = contexts.begin(); context != contexts.end(); context++)
     {
-      if (Arch::isLoad(vi[i]->GetCode()))
+      AccessStream & stream = access_streams.Get(ContextualNode(*context, n));
+      string idAccessName = AnalysisHelper::mkContextAttrName(attributeAccessName, (*context)->getStringId());
+      for (size_t i = 0; i < vi.size(); i++)
 	{
+	  if (!Arch::isLoad(vi[i]->GetCode())) { continue; }
+
 	  assert(vi[i]->HasAttribute(idAccessName));
 	  string accessValue = ((SerialisableStringAttribute &) (vi[i]->GetAttribute(idAccessName))).GetValue();
-	  if (accessValue != "N")
+	  if (accessValue == "N") { continue; }
+
+	  set < t_address > add = getDataAddress(vi[i], *context);
+	  map < unsigned int, set < t_address > >inserted;
+	  for (set < t_address >::const_iterator it = add.begin(); it != add.end(); it++)
 	    {
-	      set < t_address > add = getDataAddress(vi[i], current.context);
-	      ACS_out.Update(add, accessValue);
+	      CacheAccess a = mkCacheAccess(*it, nb_sets, cacheline_size, ACCESS_ALWAYS);
+	      inserted[a.set].insert(a.line);
+	    }
+
+	  if (inserted.size() == 1 && inserted.begin()->second.size() == 1)
+	    {
+	      t_access_class cac = (accessValue == "A") ? ACCESS_ALWAYS : ACCESS_UNCERTAIN;
+	      stream.accesses.push_back(mkCacheAccess(*(inserted.begin()->second.begin()), nb_sets, cacheline_size, cac));
+	      continue;
+	    }
+	  for (map < unsigned int, set < t_address > >::const_iterator it = inserted.begin(); it != inserted.end(); it++)
+	    {
+	      CacheAccess a;
+	      a.line = stream.blocks.size();
+	      a.set = it->first;
+	      a.cac = ACCESS_BLOCKS;
+	      stream.blocks.push_back(it->second);
+	      stream.accesses.push_back(a);
 	    }
 	}
     }
-  return ACS_out;
 }
 
-/*
-  Insert in vSet the contextual successors of vContNode. 
- */
-void DCacheAnalysis::insertContextualSuccessors(ContextualNode & vContNode, set < ContextualNode > &vSet)
+static bool CompileNodeAccessStreams(Cfg * c, Node * n, void *param)
 {
-  vector < ContextualNode > succ = GetContextualSuccessors(vContNode);
-  vSet.insert(succ.begin(), succ.end());
+  ((DCacheAnalysis *) param)->CompileAccessStreams(c, n);
+  return true;
 }
 
 /*
@@ -495,234 +514,20 @@ void DCacheAnalysis::printSet(set < ContextualNode > &work)
  MUST ANALYSIS
 **************************************************************************************************************************/
 
-//-------------------------------------------------------
-// Initialization of abstract cache for MUST analysis
-//-------------------------------------------------------
-static bool initACSMUST(Cfg * c, Node * n, void *param)
-{
-  DCacheAnalysis *ca = (DCacheAnalysis *) param;
-  AbstractCache < MUST > ACS_empty = ca->CacheFactoryMUST();
-  AbstractCacheStateAttribute < MUST > att(ACS_empty);
-
-  string in = ACSMUSTInName;
-  string out = ACSMUSTOutName;
-
-  assert(c->HasAttribute(ContextListAttributeName));
-  const ContextList & contexts = (ContextList &) c->GetAttribute(ContextListAttributeName);
-  for (ContextList::const_iterator context = contexts.begin(); context != contexts.end(); context++)
-    {
-      string currentContext = (*context)->getStringId();
-      n->SetAttribute(in + currentContext, att);
-      n->SetAttribute(out + currentContext, att);
-    }
-
-  return true;
-}
-
-/* FixPointMust1stStep analysis: Compute the ACS_out a set of nodes (work), without considering backedges.
-   @return a set of nodes for which the ACS_in must be computed. */
-set < ContextualNode > DCacheAnalysis::FixPointMust1stStep_ACS_out(set < ContextualNode > &work, set < Edge * >&backedges)
-{
-  string in = ACSMUSTInName;
-  string out = ACSMUSTOutName;
-  set < ContextualNode > work_in;
-
-  for (set < ContextualNode >::iterator it = work.begin(); it != work.end(); it++)
-    {
-      ContextualNode current = *it;
-      AbstractCache < MUST > ACS_out = compute_ACS_out < MUST > (current, in);
-
-      AbstractCacheStateAttribute < MUST > &ca_attr_out = getACSContextualNode(MUST, current, out + current.context->getStringId());
-      if (!ca_attr_out.cache.Equals(ACS_out))
-	{
-	  ca_attr_out.cache = ACS_out;
-	  vector < ContextualNode > succ = GetContextualSuccessors(current);
-
-	  for (size_t i = 0; i < succ.size(); i++)
-	    {
-	      if (current.node->GetCfg() == succ[i].node->GetCfg())
-		{
-		  Edge *edge = current.node->GetCfg()->FindEdge(current.node, succ[i].node);
-		  if (backedges.find(edge) == backedges.end())	// If backedge, ignore it
-		    {
-		      work_in.insert(succ[i]);
-		    }
-		}
-	      else
-		{
-		  work_in.insert(succ[i]);
-		}
-	    }
-	}
-    }
-  return work_in;
-}
-
-/* FixPointMust1stStep analysis: Compute the ACS_in of a set of nodes (work) without considering backedges.
-   @return a set of nodes for which the ACS_out must be computed. */
-set < ContextualNode > DCacheAnalysis::FixPointMust1stStep_ACS_in(set < ContextualNode > &work_in, set < Edge * >&backedges)
-{
-  string in = ACSMUSTInName;
-  string out = ACSMUSTOutName;
-  set < ContextualNode > work;
-  string idAttr;
-  bool b;
-  ContextualNode pred;
-
-  for (set < ContextualNode >::iterator it = work_in.begin(); it != work_in.end(); it++)
-    {
-      ContextualNode current = *it;
-
-      const vector < ContextualNode > &predecessors = GetContextualPredecessors(current);
-      assert(predecessors.size() != 0);	//it should not be the program's entry node
-
-      AbstractCache < MUST > new_ACS_in;
-      bool first = true;
-      for (size_t i = 0; i < predecessors.size(); i++)
-	{
-	  pred = predecessors[i];
-	  b = true;
-	  if (pred.node->GetCfg() == current.node->GetCfg())
-	    {
-	      Edge *edge = current.node->GetCfg()->FindEdge(pred.node, current.node);
-	      b = (backedges.find(edge) == backedges.end());	//If backedge ignore it
-	    }
-	  if (b)
-	    {
-	      idAttr = out + pred.context->getStringId();
-	      if (first)
-		{
-		  first = false;
-		  new_ACS_in = getACSContextualNode(MUST, pred, idAttr).cache;
-		}
-	      else
-		{
-		  new_ACS_in.Join( getACSContextualNode(MUST, pred, idAttr).cache);
-		}
-	    }
-	}
-
-      AbstractCacheStateAttribute < MUST > &ca_attr_in = getACSContextualNode(MUST, current, in + current.context->getStringId());
-
-      if (!ca_attr_in.cache.Equals(new_ACS_in))
-	{
-	  ca_attr_in.cache = new_ACS_in;
-	  work.insert(current);
-	}
-    }
-  return work;
-}
-
-/* First Step of the MUST analysis: Fixed point computation of MUST Abstract Cache States (ACS) without considering backedges.
-   Remarks: Introduced for a precise classification of access performed inside loops.
-   This approach avoids a bottom state in the ACS as defined in Ferdinand's Thesis.
-*/
-bool DCacheAnalysis::FixPointMust1stStep()
-{
-  set < ContextualNode > work_in, work;
-
-  AnalysisHelper::applyToAllNodesRecursive(p, initACSMUST, (void *)this);
-  set < Edge * >backedges = AnalysisHelper::compute_backedges(p, call_graph); // getting the backedges.
-  work = initWork();
-  while (!work.empty())
-    {
-      work_in = FixPointMust1stStep_ACS_out(work, backedges);
-      work.clear();
-      work = FixPointMust1stStep_ACS_in(work_in, backedges);
-      work_in.clear();
-    }
-
-  return true;
-}
-
-/* MustAnalysis analysis: Compute the ACS_out a set of nodes (work).
-   @return a set of nodes for which the ACS_in must be computed (all the nodes have to be visited at least once).*/
-set < ContextualNode > DCacheAnalysis::MustAnalysis_ACS_out(set < ContextualNode > &work, set < ContextualNode > &visited)
-{
-  string in = ACSMUSTInName;
-  string out = ACSMUSTOutName;
-  set < ContextualNode > work_in;
-  string attributeAccessName = CACAttributeNameData(levelAnalysis);
-
-  for (set < ContextualNode >::iterator it = work.begin(); it != work.end(); it++)
-    {
-      ContextualNode current = *it;
-
-      AbstractCache < MUST > ACS_out = compute_ACS_out < MUST > (current, in);
-      AbstractCacheStateAttribute < MUST > &ca_attr_out = getACSContextualNode( MUST, current, out + current.context->getStringId());
-      if (!ca_attr_out.cache.Equals(ACS_out))
-	{
-	  ca_attr_out.cache = ACS_out;
-	  insertContextualSuccessors(current, work_in);
-	}
-
-      //To force the visit of all nodes
-      if (visited.find(current) == visited.end())
-	{
-	  visited.insert(current);
-	  insertContextualSuccessors(current, work_in);
-	}
-    }
-  return work_in;
-}
-
-/* MustAnalysis: Compute the ACS_in of a set of nodes (work). 
-   @return a set of nodes for which the ACS_out must be computed (all the nodes have to be visited at least once). */
-set < ContextualNode > DCacheAnalysis::MustAnalysis_ACS_in(set < ContextualNode > &work_in, set < ContextualNode > &visited)
-{
-  string out = ACSMUSTOutName;
-  string in = ACSMUSTInName;
-  set < ContextualNode > work;
-
-  for (set < ContextualNode >::iterator it = work_in.begin(); it != work_in.end(); it++)
-    {
-      ContextualNode current = *it;
-
-      const vector < ContextualNode > &predecessors = GetContextualPredecessors(current);
-      assert(predecessors.size() != 0);	//it should not be the program's entry node
-
-      AbstractCache < MUST > new_ACS_in = getACSContextualNode( MUST, predecessors[0], out + predecessors[0].context->getStringId()).cache;
-      for (size_t i = 1; i < predecessors.size(); i++)
-	{
-	  new_ACS_in.Join(getACSContextualNode (MUST, predecessors[i], out + predecessors[i].context->getStringId()).cache);
-	}
-
-      AbstractCacheStateAttribute < MUST > &ca_attr_in = getACSContextualNode( MUST, current, in + current.context->getStringId());
-      if (!ca_attr_in.cache.Equals(new_ACS_in))
-	{
-	  ca_attr_in.cache = new_ACS_in;
-	  work.insert(current);
-	}
-
-      //To force the visit of all nodes
-      if (visited.find(current) == visited.end())
-	{
-	  work.insert(current);
-	}
-    }
-  return work;
-}
-
-
-
 /* MUST ANALYSIS.
    Fixed point computation of MUST Abstract Cache States (ACS).
    All nodes have to be visited at least once. */
 bool DCacheAnalysis::MustAnalysis()
 {
-  set < ContextualNode > work, visited, work_in;
+  acs_must.Reset(&cn_index, CacheFactoryMUST());
+  AnalysisHelper::applyToAllNodesRecursive(p, AttachACSTableNode < MUST >, (void *)&acs_must);
 
-  FixPointMust1stStep();
-  work = initWork();
-  while (!work.empty())
-    {
-      // printSet(work); // debug
-      work_in = MustAnalysis_ACS_out(work, visited);
-      work.clear();
-      work = MustAnalysis_ACS_in(work_in, visited);
-      work_in.clear();
-    }
+  size_t nb_iterations = SetPartitionedFixPoint(acs_must, access_streams, cn_graph, cn_graph.Slots(initWork()), nb_sets, nb_threads);
+  stringstream infostr;
+  infostr << "DCacheAnalysis: MUST iterations: " << nb_iterations;
+  Logger::addInfo(infostr.str());
 
+  acs_must.WriteBack(ACSMUSTInName);
   return true;
 }
 
@@ -738,7 +543,6 @@ bool static ClassifCHMCMust(Cfg * c, Node * n, void *param)
   DCacheAnalysis *ca = (DCacheAnalysis *) param;
   string CHMCAttName = CHMCAttributeNameData(ca->getLevelAnalysis());
   string in = ACSMUSTInName;
-  string out = ACSMUSTOutName;
 
   assert(c->HasAttribute(ContextListAttributeName));
   const ContextList & contexts = (ContextList &) c->GetAttribute(ContextListAttributeName);
@@ -777,7 +581,6 @@ bool static ClassifCHMCMust(Cfg * c, Node * n, void *param)
 
       // Remove the ACS_in and ACS_out attributes
       n->RemoveAttribute(in + currentContext);
-      n->RemoveAttribute(out + currentContext);
     }
   return true;
 }
@@ -786,102 +589,6 @@ bool static ClassifCHMCMust(Cfg * c, Node * n, void *param)
  MAY ANALYSIS
 **************************************************************************************************************************/
 
-//-------------------------------------------------------
-// Initialization of abstract cache for MAY analysis
-//-------------------------------------------------------
-bool static initACSMAY(Cfg * c, Node * n, void *param)
-{
-  DCacheAnalysis *ca = (DCacheAnalysis *) param;
-  AbstractCache < MAY > ACS_empty = ca->CacheFactoryMAY();
-  AbstractCacheStateAttribute < MAY > att(ACS_empty);
-
-  string in = ACSMAYInName;
-  string out = ACSMAYOutName;
-
-  assert(c->HasAttribute(ContextListAttributeName));
-  const ContextList & contexts = (ContextList &) c->GetAttribute(ContextListAttributeName);
-  for (ContextList::const_iterator context = contexts.begin(); context != contexts.end(); context++)
-    {
-      string currentContext = (*context)->getStringId();
-      n->SetAttribute(in + currentContext, att);
-      n->SetAttribute(out + currentContext, att);
-    }
-
-  return true;
-}
-
-/* MayAnalysis analysis: Compute the ACS_out a set of nodes (work).
-   @return a set of nodes for which the ACS_in must be computed (all the nodes have to be visited at least once).*/
-set < ContextualNode > DCacheAnalysis::MayAnalysis_ACS_out(set < ContextualNode > &work, set < ContextualNode > &visited)
-{
-  string in = ACSMAYInName;
-  string out = ACSMAYOutName;
-  string attributeAccessName = CACAttributeNameData(levelAnalysis);
-
-  set < ContextualNode > work_in;
-
-  //compute ACS_out
-  for (set < ContextualNode >::iterator it = work.begin(); it != work.end(); it++)
-    {
-      ContextualNode current = *it;
-
-      AbstractCache < MAY > ACS_out = compute_ACS_out < MAY > (current, in);
-      AbstractCacheStateAttribute < MAY > &ca_attr_out =getACSContextualNode(MAY, current, out + current.context->getStringId());
-
-      if (!ca_attr_out.cache.Equals(ACS_out))
-	{
-	  ca_attr_out.cache = ACS_out;
-	  insertContextualSuccessors(current, work_in);
-	}
-
-      //To force the visit of all nodes
-      if (visited.find(current) == visited.end())
-	{
-	  insertContextualSuccessors(current, work_in);
-	  visited.insert(current);
-	}
-    }
-  return work_in;
-}
-
-/* MayAnalysis: Compute the ACS_in of a set of nodes (work). 
-   @return a set of nodes for which the ACS_out must be computed (all the nodes have to be visited at least once). */
-set < ContextualNode > DCacheAnalysis::MayAnalysis_ACS_in(set < ContextualNode > &work_in, set < ContextualNode > &visited)
-{
-  string in = ACSMAYInName;
-  string out = ACSMAYOutName;
-  set < ContextualNode > work;
-
-  for (set < ContextualNode >::iterator it = work_in.begin(); it != work_in.end(); it++)
-    {
-      ContextualNode current = *it;
-
-      const vector < ContextualNode > &predecessors = GetContextualPredecessors(current);
-      assert(predecessors.size() != 0);	//it should not be the program's entry node
-
-      AbstractCache < MAY > new_ACS_in =getACSContextualNode (MAY, predecessors[0], out + predecessors[0].context->getStringId()).cache;
-      for (size_t i = 1; i < predecessors.size(); i++)
-	{
-	  new_ACS_in.Join(getACSContextualNode(MAY, predecessors[i], out + predecessors[i].context->getStringId()).cache);
-	}
-
-      AbstractCacheStateAttribute < MAY > &ca_attr_in =getACSContextualNode ( MAY, current, in + current.context->getStringId());
-
-      if (!ca_attr_in.cache.Equals(new_ACS_in))
-	{
-	  ca_attr_in.cache = new_ACS_in;
-	  work.insert(current);
-	}
-
-      //To force the visit of all nodes
-      if (visited.find(current) == visited.end())
-	{
-	  work.insert(current);
-	}
-    }
-  return work;
-}
-
 /*
   MAY ANALYSIS.
   Fixed point computation of MAY Abstract Cache States (ACS).
@@ -889,17 +596,15 @@ set < ContextualNode > DCacheAnalysis::MayAnalysis_ACS_in(set < ContextualNode >
 */
 bool DCacheAnalysis::MayAnalysis()
 {
-  set < ContextualNode > visited, work_in, work;
+  acs_may.Reset(&cn_index, CacheFactoryMAY());
+  AnalysisHelper::applyToAllNodesRecursive(p, AttachACSTableNode < MAY >, (void *)&acs_may);
 
-  AnalysisHelper::applyToAllNodesRecursive(p, initACSMAY, (void *)this);
-  work = initWork();
-  while (!work.empty())
-    {
-      work_in = MayAnalysis_ACS_out(work, visited);
-      work.clear();
-      work = MayAnalysis_ACS_in(work_in, visited);
-      work_in.clear();
-    }
+  size_t nb_iterations = SetPartitionedFixPoint(acs_may, access_streams, cn_graph, cn_graph.Slots(initWork()), nb_sets, nb_threads);
+  stringstream infostr;
+  infostr << "DCacheAnalysis: MAY iterations: " << nb_iterations;
+  Logger::addInfo(infostr.str());
+
+  acs_may.WriteBack(ACSMAYInName);
   return true;
 }
 
@@ -915,7 +620,6 @@ bool static ClassifCHMCMay(Cfg * c, Node * n, void *param)
   DCacheAnalysis *ca = (DCacheAnalysis *) param;
   string CHMCAttName = CHMCAttributeNameData(ca->getLevelAnalysis());
   string in = ACSMAYInName;
-  string out = ACSMAYOutName;
 
   assert(c->HasAttribute(ContextListAttributeName));
   const ContextList & contexts = (ContextList &) c->GetAttribute(ContextListAttributeName);
@@ -958,7 +662,6 @@ bool static ClassifCHMCMay(Cfg * c, Node * n, void *param)
 
       // Remove the ACS_in and ACS_out attributes
       n->RemoveAttribute(in + currentContext);
-      n->RemoveAttribute(out + currentContext);
     }
   return true;
 }
@@ -980,15 +683,10 @@ bool static ClassifCHMCMay(Cfg * c, Node * n, void *param)
 
 //possible improvement: computation of identical loops in only one context
 
-set < ContextualNode > initACSPS(Program * p, DCacheAnalysis * a)
+set < ContextualNode > initACSPS(Program * p, DCacheAnalysis * a, ACSTable < PS > &acs_ps)
 {
-  string in = ACSPSInName;
-  string out = ACSPSOutName;
   set < ContextualNode > result;
 
-  AbstractCache < PS > abstractCache = a->CacheFactoryPS();
-  AbstractCacheStateAttribute < PS > ca(abstractCache);
-
   vector < Cfg * >cfgs = p->GetAllCfgs();
 
   for (size_t i = 0; i < cfgs.size(); i++)
@@ -1001,16 +699,14 @@ set < ContextualNode > initACSPS(Program * p, DCacheAnalysis * a)
 	  for (ContextList::const_iterator context_it = contexts.begin(); context_it != contexts.end(); context_it++)
 	    {
 	      Context *context = *context_it;
-	      string context_id = context->getStringId();
 
 	      if (AnalysisHelper::CallerInLoop(context))	//if the current context is called in a loop
 		{
 		  vector < Node * >nodes = cfgs[i]->GetAllNodes();
 		  for (size_t j = 0; j < nodes.size(); j++)
 		    {
-		      // Attach the attribute to all nodes in the cfg.
-		      nodes[j]->SetAttribute(in + context_id, ca);
-		      nodes[j]->SetAttribute(out + context_id, ca);
+		      // Attach all nodes in the cfg.
+		      acs_ps.Attach(ContextualNode(context, nodes[j]));
 		    }
 		}
 	      else
@@ -1044,9 +740,8 @@ set < ContextualNode > initACSPS(Program * p, DCacheAnalysis * a)
 		      vector < Node * >nodes = loopsOuter[j]->GetAllNodes();
 		      for (size_t k = 0; k < nodes.size(); ++k)
 			{
-			  // Attach the attribute to all nodes in the loop.
-			  nodes[k]->SetAttribute(in + context_id, ca);
-			  nodes[k]->SetAttribute(out + context_id, ca);
+			  // Attach all nodes in the loop.
+			  acs_ps.Attach(ContextualNode(context, nodes[k]));
 			}
 		    }
 		}
@@ -1056,118 +751,25 @@ set < ContextualNode > initACSPS(Program * p, DCacheAnalysis * a)
   return result;
 }
 
-/* PSAnalysis: Compute the ACS_out of a set of nodes (work).
-   @return a set of nodes for which the ACS_in must be computed (all the nodes have to be visited at least once). */
-set < ContextualNode > DCacheAnalysis::PSAnalysis_ACS_out(set < ContextualNode > &work, set < ContextualNode > &visited)
-{
-  string in = ACSPSInName;
-  string out = ACSPSOutName;
-  set < ContextualNode > work_in;
-  string attributeAccessName = CACAttributeNameData(levelAnalysis);
-  bool b;
-
-  for (set < ContextualNode >::iterator it = work.begin(); it != work.end(); it++)
-    {
-      ContextualNode current = *it;
-      AbstractCache < PS > ACS_out = compute_ACS_out < PS > (current, in);
-
-      AbstractCacheStateAttribute < PS > &ca_attr_out = getACSContextualNode(PS, current, out + current.context->getStringId());
-      b = false;
-      if (!ca_attr_out.cache.Equals(ACS_out))
-	{
-	  ca_attr_out.cache = ACS_out;
-	  b = true;
-	}
-
-      // To force the visit of all nodes
-      if (visited.find(current) == visited.end())
-	{
-	  b = true;
-	  visited.insert(current);
-	}
-
-      if (b)
-	{
-	  vector < ContextualNode > succ = GetContextualSuccessors(current);
-	  for (size_t i = 0; i < succ.size(); i++)
-	    {
-	      // A successor is added only if it is present in the loop
-	      if (succ[i].node->HasAttribute(in + succ[i].context->getStringId())) 
-		{
-		  work_in.insert(succ[i]);
-		}
-	    }
-	}
-    }
-  return work_in;
-}
-
-/* PSAnalysis: Compute the ACS_in of a set of nodes (work). 
-   @return a set of nodes for which the ACS_out must be computed (all the nodes have to be visited at least once). */
-set < ContextualNode > DCacheAnalysis::PSAnalysis_ACS_in(set < ContextualNode > &work_in, set < ContextualNode > &visited)
-{
-  string in = ACSPSInName;
-  string out = ACSPSOutName;
-  set < ContextualNode > work;
-
-  for (set < ContextualNode >::iterator it = work_in.begin(); it != work_in.end(); it++)
-    {
-      ContextualNode current = *it;
-
-      const vector < ContextualNode > &predecessors = GetContextualPredecessors(current);
-      assert(predecessors.size() != 0);	//it should not be the program's entry node
-
-      AbstractCache < PS > new_ACS_in;
-      bool first = true;
-      for (size_t i = 0; i < predecessors.size(); i++)
-	{
-	  if (predecessors[i].node->HasAttribute(out + predecessors[i].context->getStringId()))
-	    {
-	      if (first)
-		{
-		  first = false;
-		  new_ACS_in =getACSContextualNode(PS, predecessors[i], out + predecessors[i].context->getStringId()).cache;
-		}
-	      else
-		{
-		  new_ACS_in.Join(getACSContextualNode( PS, predecessors[i], out + predecessors[i].context->getStringId()).cache);
-		}
-	    }
-	}
-
-      AbstractCacheStateAttribute < PS > &ca_attr_in =getACSContextualNode(PS, current, in + current.context->getStringId());
-
-      if (!ca_attr_in.cache.Equals(new_ACS_in))
-	{
-	  ca_attr_in.cache = new_ACS_in;
-	  work.insert(current);
-	}
-      // To force the visit of all nodes
-      if (visited.find(current) == visited.end())
-	{
-	  work.insert(current);
-	}
-    }
-  return work;
-}
-
 /* PS ANALYSIS.
     Fixed point computation of PS Abstract Cache States (ACS).
     All the nodes have to be visited at least once.
 */
 bool DCacheAnalysis::PSAnalysis()
 {
-  set < ContextualNode > work, work_in, visited;
+  acs_ps.Reset(&cn_index, CacheFactoryPS());
+  set < ContextualNode > work = initACSPS(p, this, acs_ps);
 
-  work = initACSPS(p, this);
-  while (!work.empty())
-    {
-      work_in = PSAnalysis_ACS_out(work, visited);
-      work.clear();
-      work = PSAnalysis_ACS_in(work_in, visited);
-      work_in.clear();
-    }
+  // the outer loops are usually reachable from the entry point, and already ordered
+  cn_graph.AddReachable(work);
+  cn_graph.ComputeWTO(cn_graph.Slots(work));
 
+  size_t nb_iterations = SetPartitionedFixPoint(acs_ps, access_streams, cn_graph, cn_graph.Slots(work), nb_sets, nb_threads);
+  stringstream infostr;
+  infostr << "DCacheAnalysis: PS iterations: " << nb_iterations;
+  Logger::addInfo(infostr.str());
+
+  acs_ps.WriteBack(ACSPSInName);
   return true;
 }
 
@@ -1187,7 +789,6 @@ bool static ClassifCHMCPS(Cfg * c, Node * n, void *param)
   DCacheAnalysis *ca = (DCacheAnalysis *) param;
   string CHMCAttName = CHMCAttributeNameData(ca->getLevelAnalysis());
   string in = ACSPSInName;
-  string out = ACSPSOutName;
 
   assert(c->HasAttribute(ContextListAttributeName));
   const ContextList & contexts = (ContextList &) c->GetAttribute(ContextListAttributeName);
@@ -1229,9 +830,8 @@ bool static ClassifCHMCPS(Cfg * c, Node * n, void *param)
 		}
 	    }
 
-	  //remove the ACS_in and ACS_out attributes
+	  //remove the ACS_in attribute
 	  n->RemoveAttribute(in + currentContext);
-	  n->RemoveAttribute(out + currentContext);
 	}
     }
   return true;
@@ -1321,6 +921,16 @@ bool DCacheAnalysis::PerformAnalysis()
       AnalysisHelper::applyToAllNodesRecursive(p, initL1AccessAttributeForData, NULL);
     }
 
+  // Accesses of the contextual nodes, replayed by the MUST, PS and MAY analyses
+  cn_index.Reset(p);
+  access_streams.Reset(&cn_index);
+  AnalysisHelper::applyToAllNodesRecursive(p, CompileNodeAccessStreams, (void *)this);
+
+  // Contextual graph of the fixed points, in weak topological order
+  cn_graph.Reset(&cn_index);
+  cn_graph.AddReachable(initWork());
+  cn_graph.ComputeWTO(cn_graph.Slots(initWork()));
+
   float time = 0.0;
   //------------------------
   // MUST analysis
@@ -1366,6 +976,10 @@ bool DCacheAnalysis::PerformAnalysis()
       infostr << "DcacheAnalysis: MAY done: " << time;
       Logger::addInfo(infostr.str());
     }
+  cn_graph.Clear();
+  access_streams.Clear();
+  cn_index.Clear();
+
   //------------------------
   // NC classification
   //------------------------
@@ -1420,7 +1034,7 @@ bool DCacheAnalysis::CheckInputAttributes()
 // and cac_computation map initialization
 //------------------------------------------------
  DCacheAnalysis::DCacheAnalysis(Program * p, int nbsets, int nbways, int cachelinesize, t_replacement_policy r, int levelCache, 
-				bool apply_must, bool apply_persistence, bool apply_may):Analysis (p)
+				bool apply_must, bool apply_persistence, bool apply_may, int nbthreads):Analysis (p)
 {
   if (r != LRU)
     {
@@ -1437,6 +1051,8 @@ bool DCacheAnalysis::CheckInputAttributes()
   perform_persistence_analysis = apply_persistence;
   perform_may_analysis = apply_may;
 
+  nb_threads = (nbthreads > 1) ? nbthreads : 1;
+
   this->call_graph = new CallGraph(p);
 
   //-------------------------------------
@@ -29,6 +29,7 @@ See CREDITS.txt for credits of authorship
 #include "Analysis.h"
 #include "Specific/CacheAnalysis/Cache.h"
 #include "Specific/CacheAnalysis/CacheAnalysis.h"
+#include "Specific/CacheAnalysis/CachePartition.h"
 #include "Generic/CallGraph.h"
 #include "Generic/ContextHelper.h"
 
@@ -87,8 +88,22 @@ private:
   /** Program call graph (used for detection of dead code to speed up the analysis). */
   CallGraph *call_graph;
 
-  /** First Step of the MUST analysis: Fixed point computation of MUST Abstract Cache States (ACS) without considering backedges. */
-  bool FixPointMust1stStep ();
+  /** Number of threads of the fixed points, computed by groups of cache sets when > 1 */
+  unsigned int nb_threads;
+
+  /** Index of the contextual nodes in acs_must, acs_may, acs_ps and access_streams */
+  ContextualNodeIndex cn_index;
+
+  /** Cache accesses of the contextual nodes at the analysed level (see CompileAccessStreams) */
+  AccessStreamTable access_streams;
+
+  /** Contextual graph of the fixed points, in weak topological order */
+  ContextualGraph cn_graph;
+
+  /** ACS of the contextual nodes during the MUST, MAY and PS fixed points */
+  ACSTable < MUST > acs_must;
+  ACSTable < MAY > acs_may;
+  ACSTable < PS > acs_ps;
 
   /** Fixed point computation of MUST Abstract Cache States (ACS). */
   bool MustAnalysis ();
@@ -99,51 +114,10 @@ private:
   /** Fixed point computation of PS Abstract Cache States (ACS). */
   bool PSAnalysis ();
 
-  /** @return the ACS_out, for an analysis T, of a ContextualNode (current). 
-      The initial ACS_out is the ACS_in of the current analysis (given by the attribute inAnalysisName in the context of current).
-      Then the ACS_out is updated for each Load instructions of the node.
-      Remark: inAnalysisName ::= ACSMUSTInName | ACSMAYInName | ACSPSInName. */
-  template<typename T> AbstractCache < T > compute_ACS_out(ContextualNode &current, string &inAnalysisName);
-
   /** @retrun the initial contextual node of the program.
       (ie first context of the entry point of the program, the start node of the entry point)*/
   set < ContextualNode > initWork();
 
-  /** Insert in vSet the contextual successors of vContNode. */
-  void insertContextualSuccessors(ContextualNode & vContNode, set < ContextualNode > &vSet);
-
-  /** FixPointMust1stStep analysis: Compute the ACS_out a set of nodes (work), without considering backedges.
-      @return a set of nodes for which the ACS_in must be computed. */
-  set < ContextualNode > FixPointMust1stStep_ACS_out(set < ContextualNode >&work_in, set < Edge * >& backedges );
-
-  /** FixPointMust1stStep analysis: Compute the ACS_in of a set of nodes (work) without considering backedges.
-      @return a set of nodes for which the ACS_out must be computed. */
-  set < ContextualNode > FixPointMust1stStep_ACS_in(set < ContextualNode >&work, set < Edge * >& backedges );
-
-  /** MustAnalysis analysis: Compute the ACS_out a set of nodes (work).
-      @return a set of nodes for which the ACS_in must be computed (all the nodes have to be visited at least once).*/
-  set < ContextualNode > MustAnalysis_ACS_out(set < ContextualNode >&work, set < ContextualNode > &visited);
-
-  /** MustAnalysis: Compute the ACS_in of a set of nodes (work_in). 
-      @return a set of nodes for which the ACS_out must be computed (all the nodes have to be visited at least once). */
-  set < ContextualNode > MustAnalysis_ACS_in(set < ContextualNode >&work_in, set < ContextualNode > &visited);
-
-  /** MayAnalysis analysis: Compute the ACS_out a set of nodes (work).
-      @return a set of nodes for which the ACS_in must be computed (all the nodes have to be visited at least once).*/
-  set < ContextualNode > MayAnalysis_ACS_out(set < ContextualNode > &work);
-
-  /** MayAnalysis: Compute the ACS_in of a set of nodes (work_in). 
-      @return a set of nodes for which the ACS_out must be computed (all the nodes have to be visited at least once). */
-  set < ContextualNode > MayAnalysis_ACS_in(set < ContextualNode > &work_in);
-
-  /** PSAnalysis: Compute the ACS_out of a set of nodes (work).
-       @return a set of nodes for which the ACS_in must be computed. */
-  set < ContextualNode > PSAnalysis_ACS_out(set < ContextualNode >&work);
-
-  /** PSAnalysis: Compute the ACS_in of a set of nodes (work_in). 
-      @return a set of nodes for which the ACS_out must be computed. */
-  set < ContextualNode > PSAnalysis_ACS_in(set < ContextualNode >&work_in);
-
 public:
 
   /** @return an empty Must cache */
@@ -156,9 +130,11 @@ public:
   /** Map used to determine the next level CAC based on current CAC and CHMC */
     map < string, map < string, SerialisableStringAttribute > >cac_computation;
 
-  /** Constructor. Sets up cache parameters */
+  /** Constructor. Sets up cache parameters.
+      nbthreads > 1 computes the fixed points by groups of cache sets on nbthreads threads. */
     ICacheAnalysis (Program * p, int nbsets, int nbways, int cachelinesize,
-		    t_replacement_policy r, int cacheLevel, bool apply_must, bool apply_persistence, bool apply_may, bool keepage);
+		    t_replacement_policy r, int cacheLevel, bool apply_must, bool apply_persistence, bool apply_may, bool keepage,
+		    int nbthreads = 1);
 
   /** Destructor. */
    ~ICacheAnalysis ()
@@ -175,6 +151,9 @@ public:
    /** Remove all private attributes*/
    void RemovePrivateAttributes ();   
 
+   /** Compiles the cache accesses of a node in all its contexts into access_streams */
+   void CompileAccessStreams (Cfg * c, Node * n);
+
   /** Accessors */
   int getNbSets () const
   {
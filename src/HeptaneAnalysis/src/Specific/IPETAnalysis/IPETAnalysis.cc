@@ -80,6 +80,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <cassert>
+#include <unistd.h>
 
 #include "Analysis.h"
 #include "Generic/Config.h"
@@ -96,21 +97,32 @@
 // -----------
 // - p: program whose WCET is to be computed
 // - m: WCET computation method (METHOD_NOPIPELINE_ICACHE_DCACHE, METHOD_NOPIPELINE_PERFECTICACHE_PERFECTDCACHE, METHOD_PIPELINE_ICACHE_DCACHE, ....)
-// - used_solver: used solver (LP_SOLVE or CPLEX)
+// - used_solver: used solver (LP_SOLVE, LP_SOLVE_LIB or CPLEX)
 // - generate_wcet_info: true if WCET information is attached to the CFG of entry point
 // - generate_node_freq: true if frequency information is attached to the nodes (one value per execution context)
 // - latencyPerfectIcache : useful only for PerfectIcache method
 // - latencyPerfectDcache : useful only for PerfectDcache method
+// - ilp_file: file the ILP system is dumped to, none if empty
 // ---------------------------------------
 IPETAnalysis::IPETAnalysis(Program * p, int m, int used_solver, bool generate_wcet_info, bool generate_node_freq, int nb_icache_levels, int nb_dcache_levels, 
-			   map < int, int >CacheLatency, int latPerfectIcache, int latPerfectDcache):Analysis(p)
+			   map < int, int >CacheLatency, int latPerfectIcache, int latPerfectDcache, string ilp_file):Analysis(p)
 {
   // Check solver parameter is correct and create associated object
-  assert(used_solver == LP_SOLVE || used_solver == CPLEX);
+  assert(used_solver == LP_SOLVE || used_solver == CPLEX || used_solver == LP_SOLVE_LIB);
   if (used_solver == LP_SOLVE)
     solver = new LpsolveSolver((IPETAnalysis *) this);
-  else
+  else if (used_solver == CPLEX)
     solver = new CPLEXSolver((IPETAnalysis *) this);
+  else
+    {
+#ifdef LPSOLVE
+      solver = new LpsolveLibSolver((IPETAnalysis *) this, ilp_file != "");
+#else
+      Logger::addFatal("IPETAnalysis: solver lp_solve_lib requires Heptane built with LPSOLVE");
+      solver = new LpsolveSolver((IPETAnalysis *) this);
+#endif
+    }
+  this->ilp_file = ilp_file;
 
   // Fill-in member variables from parameters
   method = m;
@@ -1338,11 +1350,6 @@ bool IPETAnalysis::PerformAnalysis()
   ostringstream strf;		// flow constraints
   ostringstream stde;		// declarations
 
-  char buffer[25] = "/tmp/IPETAnalysis_XXXXXX";
-  mkstemp(buffer);
-  ofstream os(buffer);
-  string fout = buffer;
-
   // Get the Cfg of the program entry point
   // --------------------------------------
   vector < string > vid;
@@ -1377,20 +1384,41 @@ bool IPETAnalysis::PerformAnalysis()
     solver->generate_equality(strc, vs, 1);
   }
 
-  // Write everything (objective first, constraints, then declarations last) in the output file Objective function
-  os << strf.str();
-  // All the constraints (except statistics)
-  os << strc.str();
-  // Declarations
-  os << stde.str();
-  os.close();
-
-  // Launch the solver
-  char fileNameTemplate[19] = "/tmp/solver_XXXXXX";
-  string tmpFileName = mktemp(fileNameTemplate);
+  // Write everything (objective first, constraints, then declarations last) in the output file
+  // The in process solver only generates it when dumping
+  string fout = ilp_file;
+  if (fout == "" && solver->uses_files())
+    {
+      char buffer[25] = "/tmp/IPETAnalysis_XXXXXX";
+      mkstemp(buffer);
+      fout = buffer;
+    }
+  if (fout != "")
+    {
+      ofstream os(fout.c_str());
+      // Objective function
+      os << strf.str();
+      // All the constraints (except statistics)
+      os << strc.str();
+      // Declarations
+      os << stde.str();
+      os.close();
+    }
 
-  // Compiler: the use of `mktemp' is dangerous, better use `mkstemp'
-  // LBesnard. error ( for cplex, ok for lp_solve ) with: mkstemp(fileNameTemplate);  string tmpFileName = fileNameTemplate;
+  // Launch the solver, the external solvers write their output in a temporary file
+  string tmpFileName;
+  if (solver->uses_files())
+    {
+      char fileNameTemplate[19] = "/tmp/solver_XXXXXX";
+      int fd = mkstemp(fileNameTemplate);
+      if (fd == -1)
+	{
+	  Logger::addFatal("IPETAnalysis: cannot create the solver output file");
+	  return false;
+	}
+      close(fd);
+      tmpFileName = fileNameTemplate;
+    }
 
   if (!solver->solve(fout, tmpFileName))
     return false;
@@ -56,6 +56,9 @@ class IPETAnalysis:public Analysis
   /** Method to parse lp_solve solver */
   friend bool LpsolveSolver::parse_output (string file_name, string &);
   friend bool CPLEXSolver::parse_output (string file_name, string &);
+#ifdef LPSOLVE
+  friend bool LpsolveLibSolver::parse_output (string file_name, string &);
+#endif
   friend void Solver::setFrequencyAttribute(string VariableName, string freq);
 
   /** Map to store node_ids, used for naming variables in the ILP
@@ -72,11 +75,15 @@ class IPETAnalysis:public Analysis
   /** File name of the file to contain the ILP system (generated randomly)
       string fout; removed LBesnard */
 
+  /** File the ILP system is dumped to, a temporary file if empty
+      and the solver reads it from a file, none otherwise */
+  string ilp_file;
+
   /** Program call graph (built only to test if it is cyclic)
       The analysis fails with a "false" error code when the call graph is cyclic*/
   CallGraph *call_graph;
 
-  /** Used solver (lp_solve or CPLEX). Built in the constructor
+  /** Used solver (lp_solve, in process or not, or CPLEX). Built in the constructor
       depending on the value of parameter "used_solver"*/
   Solver *solver;
 
@@ -194,12 +201,14 @@ class IPETAnalysis:public Analysis
   /** Constructor
       - p: program whose WCET is to be computed
       - method: WCET computation method (METHOD_INSTR, METHOD_BB, METHOD_NOCACHE)
-      - used_solver: used solver (LP_SOLVE or CPLEX)
+      - used_solver: used solver (LP_SOLVE, LP_SOLVE_LIB or CPLEX)
       - generate_wcet_info: true if WCET information is attached to the CFG of entry
       - generate_node_freq: true if frequency information is attached to the nodes (one value per execution context) .
+      - ilp_file: file the ILP system is dumped to, none if empty
   */
   IPETAnalysis (Program * p, int method, int used_solver, bool generate_wcet_info, bool generate_node_freq,
-		int NbICacheLevels,  int NbDCacheLevels,  map < int, int >  CacheLatency,  int latPerfectIcache, int latPerfectDcache);
+		int NbICacheLevels,  int NbDCacheLevels,  map < int, int >  CacheLatency,  int latPerfectIcache, int latPerfectDcache,
+		string ilp_file = "");
     
   /** Destructor, nothing very exciting in it. */
   ~IPETAnalysis ()
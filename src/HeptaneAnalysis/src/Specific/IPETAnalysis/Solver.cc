@@ -36,6 +36,10 @@
 #include "Specific/IPETAnalysis/IPETAnalysis.h"
 #include "Utl.h"
 
+#ifdef LPSOLVE
+#include <lpsolve/lp_lib.h>
+#endif
+
 
 /*
   It assigns the frequency (freq) to the node (Basic block) associated with a variable (VariableName).
@@ -364,6 +368,9 @@ CPLEXSolver::generate_equality (ostringstream & os, vector < string > vid, int N
 bool
 CPLEXSolver::solve (string file_name, string fout)
 {
+  // fout is created empty by mkstemp, cplex does not write an existing file
+  remove (fout.c_str ());
+
   ofstream file;
   file.open (file_name.c_str (), ios_base::app);
   file << "write " << fout << " sol" << endl;
@@ -441,3 +448,179 @@ bool CPLEXSolver::parse_output (string file_name, string & wcet)
   readfile.close();
   return true;
 }
+
+#ifdef LPSOLVE
+// In process lp_solve solver
+// --------------------------
+// The generate_* functions record the constraint system (the text is
+// only generated when dumping), solve() hands it to the lp_solve library.
+
+LpsolveLibSolver::LpsolveLibSolver (IPETAnalysis * a, bool dump_text):LpsolveSolver (a), dump (dump_text), lp (NULL)
+{
+}
+
+LpsolveLibSolver::~LpsolveLibSolver ()
+{
+  if (lp != NULL)
+    delete_lp (lp);
+}
+
+int
+LpsolveLibSolver::column (const string & id)
+{
+  map < string, int >::iterator it = columns.find (id);
+  if (it != columns.end ())
+    return it->second;
+  names.push_back (id);
+  int col = names.size ();
+  columns[id] = col;
+  return col;
+}
+
+// Adds the constraint sum(ids*cst) type rhs, as lp_solve reads the text
+// format a variable appearing twice sums its coefficients.
+// A single variable constraint is a bound in the text format, which
+// is the same for the non negative variables of the system.
+void
+LpsolveLibSolver::add_row (const vector < string > &ids, const vector < long > &cst, int type, double rhs)
+{
+  assert (ids.size () == cst.size ());
+  Row row;
+  row.type = type;
+  row.rhs = rhs;
+  map < int, double > terms;
+  for (unsigned int i = 0; i < ids.size (); i++)
+    terms[column (ids[i])] += cst[i];
+  for (map < int, double >::iterator it = terms.begin (); it != terms.end (); it++)
+    {
+      row.cols.push_back (it->first);
+      row.coefs.push_back (it->second);
+    }
+  rows.push_back (row);
+}
+
+void
+LpsolveLibSolver::generate_objective_function (ostringstream & os, vector < string > ids, vector < long >cst)
+{
+  if (dump)
+    LpsolveSolver::generate_objective_function (os, ids, cst);
+  assert (ids.size () == cst.size ());
+  map < int, double > terms;
+  for (unsigned int i = 0; i < ids.size (); i++)
+    terms[column (ids[i])] += cst[i];
+  for (map < int, double >::iterator it = terms.begin (); it != terms.end (); it++)
+    {
+      obj_cols.push_back (it->first);
+      obj_coefs.push_back (it->second);
+    }
+}
+
+void
+LpsolveLibSolver::generate_declarations (ostringstream & os, vector < string > ids)
+{
+  if (dump)
+    LpsolveSolver::generate_declarations (os, ids);
+  for (unsigned int i = 0; i < ids.size (); i++)
+    int_cols.push_back (column (ids[i]));
+}
+
+// vid[0] = sum(vid[1..n])
+void
+LpsolveLibSolver::generate_flow_constraint (ostringstream & os, vector < string > vid)
+{
+  if (dump)
+    LpsolveSolver::generate_flow_constraint (os, vid);
+  assert (vid.size () > 0);
+  if (vid.size () > 1)
+    {
+      vector < long > cst (vid.size (), 1);
+      cst[0] = -1;
+      add_row (vid, cst, EQ, 0);
+    }
+}
+
+void
+LpsolveLibSolver::generate_inequality (ostringstream & os, vector < string > vid, int N)
+{
+  if (dump)
+    LpsolveSolver::generate_inequality (os, vid, N);
+  assert (vid.size () > 0);
+  add_row (vid, vector < long > (vid.size (), 1), LE, N);
+}
+
+void
+LpsolveLibSolver::generate_linear_inequality (ostringstream & os, vector < string > ids, vector < long >cst, int N)
+{
+  if (dump)
+    LpsolveSolver::generate_linear_inequality (os, ids, cst, N);
+  add_row (ids, cst, LE, N);
+}
+
+void
+LpsolveLibSolver::generate_equality (ostringstream & os, vector < string > vid, int N)
+{
+  if (dump)
+    LpsolveSolver::generate_equality (os, vid, N);
+  assert (vid.size () > 0);
+  add_row (vid, vector < long > (vid.size (), 1), EQ, N);
+}
+
+bool
+LpsolveLibSolver::solve (string file_name, string fout)
+{
+  if (lp != NULL)
+    delete_lp (lp);
+  lp = make_lp (0, names.size ());
+  if (lp == NULL)
+    {
+      Logger::addFatal ("LpsolveLibSolver: Error: cannot create the lp_solve model");
+      return false;
+    }
+  set_verbose (lp, NEUTRAL);
+
+  set_add_rowmode (lp, TRUE);
+  set_obj_fnex (lp, obj_cols.size (), obj_coefs.data (), obj_cols.data ());
+  for (unsigned int i = 0; i < rows.size (); i++)
+    {
+      Row & row = rows[i];
+      add_constraintex (lp, row.cols.size (), row.coefs.data (), row.cols.data (), row.type, row.rhs);
+    }
+  set_add_rowmode (lp, FALSE);
+  for (unsigned int i = 0; i < int_cols.size (); i++)
+    set_int (lp, int_cols[i], TRUE);
+  set_maxim (lp);
+
+  int ret = ::solve (lp);
+  if (ret != OPTIMAL)
+    {
+      stringstream errorstr;
+      errorstr << "LpsolveLibSolver: Error: no optimal solution (lp_solve returned " << ret << ")";
+      Logger::addFatal (errorstr.str ());
+      return false;
+    }
+  return true;
+}
+
+bool
+LpsolveLibSolver::parse_output (string file_name, string & wcet)
+{
+  if (lp == NULL)
+    return false;
+
+  char buf[256];
+  sprintf (buf, "%.0f", get_objective (lp));
+  wcet = string (buf);
+
+  if (analysis->generate_node_frequencies)
+    {
+      vector < REAL > values (names.size ());
+      get_variables (lp, values.data ());
+      for (unsigned int i = 0; i < names.size (); i++)
+	{
+	  sprintf (buf, "%.0f", values[i]);
+	  setFrequencyAttribute (names[i], buf);
+	}
+    }
+  return true;
+}
+#endif
@@ -29,6 +29,7 @@
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#include <map>
 #include "SharedAttributes/SharedAttributes.h"
 // #include <libxml/parser.h>  removed because it induces "memory leaks".
 
@@ -36,7 +37,7 @@ using namespace std;
 class IPETAnalysis;
 
 /**
-   Encapsulation of ILP solver (lp_solve and CPLEX so far)
+   Encapsulation of ILP solver (lp_solve, in process or not, and CPLEX so far)
 */
 class Solver
 {
@@ -83,6 +84,12 @@ class Solver
   /** Parse solver output */
   virtual bool parse_output (string file_name, string & wcet) = 0;
 
+  /** true if solve() reads the constraint system from a file */
+  virtual bool uses_files ()
+  {
+    return true;
+  };
+
   
   /** It assigns the frequency (freq) to the node (Basic block) associated with a variable (VariableName).
       The frequency is the result provided by a linear programming solver (cplex or lp_solve) for such a variable.
@@ -134,4 +141,64 @@ class CPLEXSolver:public Solver
   bool parse_output (string file_name, string & wcet);
 };
 
+#ifdef LPSOLVE
+/* The lp_solve model, see lp_lib.h */
+struct _lprec;
+
+/**
+ * lp_solve ILP solver linked in (Heptane built with LPSOLVE)
+ *
+ * The constraint system is built in memory and solved through the
+ * lp_solve library, the WCET and the node frequencies are read from the
+ * solved model instead of a solver output file. The lp_solve text
+ * format is only generated when the system is dumped (see
+ * IPETAnalysis::PerformAnalysis).
+ */
+class LpsolveLibSolver:public LpsolveSolver
+{
+  /** true to also generate the text format */
+  bool dump;
+
+  /** Column of every variable (from 1, as in lp_solve) and its name */
+  map < string, int > columns;
+  vector < string > names;
+
+  /** A constraint, sum(coefs*cols) type rhs */
+  struct Row
+  {
+    vector < int > cols;
+    vector < double > coefs;
+    int type;			// LE or EQ (lp_lib.h)
+    double rhs;
+  };
+  vector < Row > rows;
+  vector < int > obj_cols;
+  vector < double > obj_coefs;
+  vector < int > int_cols;
+
+  /** Solved model, NULL until solve() */
+  _lprec *lp;
+
+  /** Returns the column of a variable, added on first use */
+  int column (const string & id);
+  void add_row (const vector < string > &ids, const vector < long > &cst, int type, double rhs);
+ public:
+  LpsolveLibSolver (IPETAnalysis * a, bool dump_text);
+  ~LpsolveLibSolver ();
+  void generate_objective_function (ostringstream & os, vector < string > ids, vector < long >cst);
+  void generate_declarations (ostringstream & os, vector < string > ids);
+  void generate_flow_constraint (ostringstream & os, vector < string > vid);
+  void generate_inequality (ostringstream & os, vector < string > vid, int N);
+  void generate_linear_inequality (ostringstream & os, vector < string > vid, vector < long >cst, int N);
+  void generate_equality (ostringstream & os, vector < string > vid, int N);
+  /** Solves in process, no file is used */
+  bool solve (string file_name, string fout);
+  bool parse_output (string file_name, string & wcet);
+  bool uses_files ()
+  {
+    return false;
+  };
+};
+#endif
+
 #endif
@@ -0,0 +1,235 @@
+/* ---------------------------------------------------------------------
+
+   Copyright IRISA, 2003-2014
+
+   This file is part of Heptane, a tool for Worst-Case Execution Time (WCET)
+   estimation.
+   APP deposit IDDN.FR.001.510039.000.S.P.2003.000.10600
+
+   Heptane is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   Heptane is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details (COPYING.txt).
+
+   See CREDITS.txt for credits of authorship
+
+   ------------------------------------------------------------------------ */
+
+/**
+ *
+ * Differential test of the MUST, MAY and PS abstract cache sets against
+ * OLD_MUST, OLD_MAY and OLD_PS (see OldCacheSets.h).
+ *
+ * Pools of new and old sets get the same random sequences of Update
+ * (one address or a set of addresses), Join and Equals, for every
+ * number of ways from 1 to MAX_WAYS and nb_ways_removed 0 and 1. After
+ * each step the printed sets, the ages and the absence of every address
+ * must be the same, and so must the results of Equals.
+ *
+ * Usage: CacheSetsTest [seed [sequences]]
+ *   exits with 1 and prints the sequence at the first mismatch
+ *
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "Specific/CacheAnalysis/Cache.h"
+#include "OldCacheSets.h"
+
+using namespace std;
+
+static const unsigned int MAX_WAYS = 8;
+/* The addresses accessed, in more cache lines than ways */
+static const unsigned int NB_LINES = MAX_WAYS + 4;
+static const unsigned int LINE_SIZE = 16;
+static const unsigned int POOL_SIZE = 4;
+static const unsigned int STEPS = 60;
+
+/** The address of a random cache line */
+static t_address
+RandomAddress ()
+{
+  return (rand () % NB_LINES) * LINE_SIZE;
+}
+
+/** What Print writes to cout */
+template < typename T > static string
+Printed (const T & s)
+{
+  stringstream ss;
+  streambuf *previous = cout.rdbuf (ss.rdbuf ());
+  s.Print ();
+  cout.rdbuf (previous);
+  return ss.str ();
+}
+
+/** The ages of every address, MAY has none */
+static string
+Ages (const MUST & s)
+{
+  stringstream ss;
+  for (unsigned int l = 0; l < NB_LINES; l++)
+    ss << s.GetAge (l * LINE_SIZE) << " ";
+  return ss.str ();
+}
+
+static string
+Ages (const OLD_MUST & s)
+{
+  stringstream ss;
+  for (unsigned int l = 0; l < NB_LINES; l++)
+    ss << s.GetAge (l * LINE_SIZE) << " ";
+  return ss.str ();
+}
+
+static string
+Ages (const PS & s)
+{
+  stringstream ss;
+  for (unsigned int l = 0; l < NB_LINES; l++)
+    ss << s.GetAge (l * LINE_SIZE) << " ";
+  return ss.str ();
+}
+
+static string
+Ages (const OLD_PS & s)
+{
+  stringstream ss;
+  for (unsigned int l = 0; l < NB_LINES; l++)
+    ss << s.GetAge (l * LINE_SIZE) << " ";
+  return ss.str ();
+}
+
+static string
+Ages (const MAY &)
+{
+  return "";
+}
+
+static string
+Ages (const OLD_MAY &)
+{
+  return "";
+}
+
+/** The absence of every address */
+template < typename T > static string
+Absences (const T & s)
+{
+  string absent;
+  for (unsigned int l = 0; l < NB_LINES; l++)
+    absent += s.Absent (l * LINE_SIZE) ? 'a' : 'p';
+  return absent;
+}
+
+/** Reports a mismatch, with the steps leading to it */
+static void
+Mismatch (const string & name, unsigned int ways, unsigned int removed,
+	  const string & what, const string & trace, const string & got,
+	  const string & expected)
+{
+  cerr << name << " (ways " << ways << ", removed " << removed << "): "
+       << what << " mismatch after" << endl << trace
+       << "new:" << endl << got << "old:" << endl << expected;
+  exit (1);
+}
+
+/** Runs one random sequence on pools of sets made from proto and old_proto */
+template < typename N, typename O > static void
+Sequence (const string & name, unsigned int ways, unsigned int removed,
+	  const N & proto, const O & old_proto)
+{
+  vector < N > sets (POOL_SIZE, proto);
+  vector < O > old_sets (POOL_SIZE, old_proto);
+  stringstream trace;
+
+  for (unsigned int step = 0; step < STEPS; step++)
+    {
+      unsigned int k = rand () % POOL_SIZE, l = rand () % POOL_SIZE;
+      switch (rand () % 4)
+	{
+	case 0:
+	  {
+	    t_address addr = RandomAddress ();
+	    trace << "  " << k << ".Update(" << addr << ")" << endl;
+	    sets[k].Update (addr);
+	    old_sets[k].Update (addr);
+	    break;
+	  }
+	case 1:
+	  {
+	    set < t_address > addrs;
+	    unsigned int n = 1 + rand () % 4;
+	    for (unsigned int i = 0; i < n; i++)
+	      addrs.insert (RandomAddress ());
+	    trace << "  " << k << ".Update({";
+	    for (set < t_address >::iterator it = addrs.begin (); it != addrs.end (); it++)
+	      trace << " " << *it;
+	    trace << " })" << endl;
+	    sets[k].Update (addrs);
+	    old_sets[k].Update (addrs);
+	    break;
+	  }
+	case 2:
+	  {
+	    trace << "  " << k << ".Join(" << l << ")" << endl;
+	    N other = sets[l];
+	    O old_other = old_sets[l];
+	    sets[k].Join (other);
+	    old_sets[k].Join (old_other);
+	    break;
+	  }
+	default:
+	  {
+	    trace << "  " << k << ".Equals(" << l << ")" << endl;
+	    bool equal = sets[k].Equals (sets[l]);
+	    if (equal != old_sets[k].Equals (old_sets[l]))
+	      Mismatch (name, ways, removed, "Equals", trace.str (),
+			equal ? "true\n" : "false\n", equal ? "false\n" : "true\n");
+	  }
+	}
+
+      string got = Printed (sets[k]), expected = Printed (old_sets[k]);
+      if (got != expected)
+	Mismatch (name, ways, removed, "Print", trace.str (), got, expected);
+      got = Ages (sets[k]);
+      expected = Ages (old_sets[k]);
+      if (got != expected)
+	Mismatch (name, ways, removed, "GetAge", trace.str (), got + "\n", expected + "\n");
+      got = Absences (sets[k]);
+      expected = Absences (old_sets[k]);
+      if (got != expected)
+	Mismatch (name, ways, removed, "Absent", trace.str (), got + "\n", expected + "\n");
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  unsigned int seed = argc > 1 ? atoi (argv[1]) : 1;
+  unsigned int sequences = argc > 2 ? atoi (argv[2]) : 200;
+  srand (seed);
+
+  for (unsigned int ways = 1; ways <= MAX_WAYS; ways++)
+    {
+      for (unsigned int removed = 0; removed <= 1; removed++)
+	for (unsigned int i = 0; i < sequences; i++)
+	  {
+	    Sequence ("MUST", ways, removed, MUST (ways, removed), OLD_MUST (ways, removed));
+	    Sequence ("PS", ways, removed, PS (ways, removed), OLD_PS (ways, removed));
+	  }
+      for (unsigned int i = 0; i < sequences; i++)
+	Sequence ("MAY", ways, 0, MAY (ways), OLD_MAY (ways));
+    }
+  cout << "MUST, MAY and PS match their old implementation (seed " << seed
+       << ", " << sequences << " sequences of " << STEPS << " steps per geometry)" << endl;
+  return 0;
+}
@@ -0,0 +1,177 @@
+/* ---------------------------------------------------------------------
+
+   Copyright IRISA, 2003-2014
+
+   This file is part of Heptane, a tool for Worst-Case Execution Time (WCET)
+   estimation.
+   APP deposit IDDN.FR.001.510039.000.S.P.2003.000.10600
+
+   Heptane is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   Heptane is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details (COPYING.txt).
+
+   See CREDITS.txt for credits of authorship
+
+   ------------------------------------------------------------------------ */
+
+/**
+ *
+ * The MUST, MAY and PS abstract cache sets as they were before they were
+ * kept in sorted vectors, renamed OLD_MUST, OLD_MAY and OLD_PS. They are
+ * only the reference of the differential test (CacheSetsTest.cc) and are
+ * not part of the analysis.
+ *
+ */
+
+#ifndef OLD_CACHE_SETS_H
+#define OLD_CACHE_SETS_H
+
+#include <set>
+#include <map>
+#include <vector>
+#include <cassert>
+#include "Analysis.h"
+using namespace std;
+
+/**************************************************
+ *
+ *  AbstractCacheSet OLD_MUST
+ *
+ *************************************************/
+
+class OLD_MUST
+{
+ private:
+  unsigned int nb_ways;		//the value corresponds to the number of ways to consider during the analysis
+  //(cf. cache abstract factory in ICacheAnalysis.cc or DCacheAnalysis.cc)
+  unsigned int nb_ways_removed;	//used in function GetAge and useful when a non LRU policy is used
+  vector < set < t_address > >contents;	//abstract cache sets
+
+ public:
+
+  /** Constructor */
+  explicit OLD_MUST (unsigned int nbways, unsigned int nbways_removed);
+
+  /** @return the age in the abstract cache of the cache line containing addr between [0..nb_ways-1] if present,  nb_ways+nb_ways_removed otherwise
+   */
+  unsigned int GetAge (t_address addr) const;
+
+  /** @return true if the cache line containing addr is absent from the abstract cache set, false otherwise */
+  bool Absent (t_address) const;
+
+  /** Print the Abstract Cache Set for debugging purpose */
+  void Print () const;
+
+  /** Update function when only one address is accessed */
+  void Update (t_address);
+
+  /** Update function when a set of addresses is accessed
+      used by the data cache analysis
+  */
+  void Update (const set < t_address > &);
+
+  /** Join function */
+  void Join (const OLD_MUST &);
+
+  /** returns true if this is equal to c and false otherwise */
+  bool Equals (const OLD_MUST &) const;
+
+};
+
+/**************************************************
+ *
+ *  AbstractCacheSet OLD_MAY
+ *
+ *************************************************/
+
+class OLD_MAY
+{
+ private:
+  unsigned int nb_ways;		//the value corresponds to the number of ways to consider during the analysis
+  //(cf. cache abstract factory in ICacheAnalysis.cc or DCacheAnalysis.cc)
+  vector < set < t_address > >contents;	//abstract cache sets
+
+ public:
+
+  /** Constructor */
+  explicit OLD_MAY (unsigned int nbways);
+
+  //unsigned int GetAge(t_address addr) const; //Not implemented for OLD_MAY analysis: semantic issue with different replacement policies
+
+  /** returns true if the cache line containing addr is absent from the abstract cache set and false otherwise */
+  bool Absent (t_address) const;
+
+  /** Print the Abstract Cache Set for debugging purpose */
+  void Print () const;
+
+  /** Update function when only one address is accessed */
+  void Update (t_address);
+
+  /** Update function when a set of addresses is accessed
+      used by the data cache analysis
+  */
+  void Update (const set < t_address > &);
+
+  /** Join function */
+  void Join (const OLD_MAY &);
+
+  /** returns true if this is equal to c and false otherwise */
+  bool Equals (const OLD_MAY &) const;
+
+};
+
+/**************************************************
+ *
+ *  AbstractCacheSet OLD_PS
+ *
+ *************************************************/
+
+class OLD_PS
+{
+ private:
+  unsigned int nb_ways;		//the value corresponds to the number of ways to consider during the analysis
+  //(cf. cache abstract factory in ICacheAnalysis.cc or DCacheAnalysis.cc)
+  unsigned int nb_ways_removed;	//used in function GetAge and useful when a non LRU policy is used
+  map < t_address, set < t_address > >contents;	//abstract cache sets
+  set < t_address > evicted;	//used to reduce the size of the map (contents). No need to maintain the conflicts of evicted cache lines
+
+ public:
+
+  /** Constructor */
+  explicit OLD_PS (unsigned int nbways, unsigned int nbways_removed);
+
+  /** returns the age in the abstract cache of the cache line containing addr
+      between [0..nb_ways-1] if present
+      nb_ways+nb_ways_removed otherwise
+  */
+  unsigned int GetAge (t_address addr) const;
+
+  /** returns true if the cache line containing addr is absent from the abstract cache set and false otherwise */
+  bool Absent (t_address) const;
+
+  /** Print the Abstract Cache Set for debugging purpose */
+  void Print () const;
+
+  /** Update function when only one address is accessed */
+  void Update (t_address);
+
+  /** Update function when a set of addresses is accessed
+      used by the data cache analysis
+  */
+  void Update (const set < t_address > &);
+
+  /** Join function */
+  void Join (const OLD_PS &);
+
+  /** returns true if this is equal to c and false otherwise */
+  bool Equals (const OLD_PS &) const;
+
+};
+
+#endif